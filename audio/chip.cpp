@@ -22,10 +22,16 @@
 #include "audio/chip.h"
 #include "audio/mixer.h"
 
+#include "common/config-manager.h"
 #include "common/timer.h"
 
 namespace Audio {
 
+// A timer proc can only be installed once, so all chips that render
+// ahead share one
+static Common::Array<EmulatedChip *> *g_renderAheadChips = nullptr;
+static Common::Mutex *g_renderAheadMutex = nullptr;
+
 void Chip::start(TimerCallback *callback, int timerFrequency) {
 	_callback.reset(callback);
 	startCallbacks(timerFrequency);
@@ -97,7 +103,9 @@ EmulatedChip::EmulatedChip() :
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
-	_handle(new Audio::SoundHandle()) { }
+	_handle(new Audio::SoundHandle()),
+	_renderRead(0),
+	_renderFill(0) { }
 
 EmulatedChip::~EmulatedChip() {
 	// Stop callbacks, just in case. If it's still playing at this
@@ -110,6 +118,29 @@ EmulatedChip::~EmulatedChip() {
 }
 
 int EmulatedChip::readBuffer(int16 *buffer, const int numSamples) {
+	// The mixer thread holds the mixer lock here already. Taking it first
+	// keeps the order the same as in renderAhead().
+	Common::StackLock mixerLock(g_system->getMixer()->mutex());
+	Common::StackLock lock(_renderMutex);
+
+	// Play the samples rendered ahead first
+	int samples = 0;
+	while (samples < numSamples && _renderFill) {
+		const uint count = MIN<uint>(MIN<uint>(numSamples - samples, _renderFill), _renderBuffer.size() - _renderRead);
+		memcpy(buffer + samples, &_renderBuffer[_renderRead], count * sizeof(int16));
+		_renderRead = (_renderRead + count) % _renderBuffer.size();
+		_renderFill -= count;
+		samples += count;
+	}
+
+	// Emulate the rest now
+	if (samples < numSamples)
+		renderSamples(buffer + samples, numSamples - samples);
+
+	return numSamples;
+}
+
+void EmulatedChip::renderSamples(int16 *buffer, int numSamples) {
 	const int stereoFactor = isStereo() ? 2 : 1;
 	int len = numSamples / stereoFactor;
 	int step;
@@ -132,8 +163,119 @@ int EmulatedChip::readBuffer(int16 *buffer, const int numSamples) {
 		buffer += step * stereoFactor;
 		len -= step;
 	} while (len);
+}
 
-	return numSamples;
+void EmulatedChip::setRenderAhead(int milliseconds) {
+	Common::StackLock lock(_renderMutex);
+
+	if (milliseconds > 0) {
+		const int stereoFactor = isStereo() ? 2 : 1;
+		_renderBuffer.resize(getRate() * milliseconds / 1000 * stereoFactor);
+		_renderChunk.resize(kRenderAheadChunk * stereoFactor);
+	} else {
+		_renderBuffer.clear();
+		_renderChunk.clear();
+	}
+	_renderRead = 0;
+	_renderFill = 0;
+}
+
+void EmulatedChip::startRenderAhead() {
+	if (!g_renderAheadChips) {
+		g_renderAheadChips = new Common::Array<EmulatedChip *>();
+		g_renderAheadMutex = new Common::Mutex();
+	}
+
+	bool first;
+	{
+		Common::StackLock lock(*g_renderAheadMutex);
+		first = g_renderAheadChips->empty();
+		g_renderAheadChips->push_back(this);
+	}
+
+	if (first)
+		g_system->getTimerManager()->installTimerProc(renderAheadProc, kRenderAheadInterval, nullptr, "EmulatedChip");
+}
+
+void EmulatedChip::stopRenderAhead() {
+	if (!g_renderAheadChips)
+		return;
+
+	bool found = false;
+	bool last = false;
+	{
+		Common::StackLock lock(*g_renderAheadMutex);
+		for (uint i = 0; i < g_renderAheadChips->size(); i++) {
+			if ((*g_renderAheadChips)[i] == this) {
+				g_renderAheadChips->remove_at(i);
+				found = true;
+				last = g_renderAheadChips->empty();
+				break;
+			}
+		}
+	}
+
+	if (!found)
+		return;
+
+	if (last) {
+		// removeTimerProc() waits for a running renderAheadProc() to
+		// finish. Chips are started and stopped from one thread, so
+		// nothing uses the list afterwards.
+		g_system->getTimerManager()->removeTimerProc(renderAheadProc);
+
+		delete g_renderAheadChips;
+		g_renderAheadChips = nullptr;
+		delete g_renderAheadMutex;
+		g_renderAheadMutex = nullptr;
+	} else {
+		// Wait until the timer thread is done with this chip
+		Common::StackLock lock(_renderAheadMutex);
+	}
+}
+
+void EmulatedChip::renderAhead() {
+	while (true) {
+		// The callbacks may take the mixer lock, like they do when they
+		// run from readBuffer(). So it is taken before the render lock,
+		// in the same order as on the mixer thread. The mixer waits for
+		// at most one chunk.
+		Common::StackLock mixerLock(g_system->getMixer()->mutex());
+		Common::StackLock lock(_renderMutex);
+
+		const uint size = _renderBuffer.size();
+		const uint space = size - _renderFill;
+		if (!space)
+			break;
+
+		const uint count = MIN<uint>(space, _renderChunk.size());
+		renderSamples(_renderChunk.data(), count);
+
+		const uint writePos = (_renderRead + _renderFill) % size;
+		const uint first = MIN<uint>(count, size - writePos);
+		memcpy(_renderBuffer.data() + writePos, _renderChunk.data(), first * sizeof(int16));
+		memcpy(_renderBuffer.data(), _renderChunk.data() + first, (count - first) * sizeof(int16));
+		_renderFill += count;
+	}
+}
+
+void EmulatedChip::renderAheadProc(void *refCon) {
+	for (uint i = 0; ; i++) {
+		EmulatedChip *chip;
+		{
+			Common::StackLock lock(*g_renderAheadMutex);
+			if (i >= g_renderAheadChips->size())
+				break;
+
+			// Locked before the chip leaves the list lock, so that
+			// stopRenderAhead() waits for the chip to be rendered
+			chip = (*g_renderAheadChips)[i];
+			chip->_renderAheadMutex.lock();
+		}
+
+		chip->renderAhead();
+		chip->_renderAheadMutex.unlock();
+	}
 }
 
 int EmulatedChip::getRate() const {
@@ -142,11 +284,16 @@ int EmulatedChip::getRate() const {
 
 void EmulatedChip::startCallbacks(int timerFrequency) {
 	setCallbackFrequency(timerFrequency);
+	setRenderAhead(ConfMan.getInt("emulated_chip_render_ahead"));
+	if (!_renderBuffer.empty())
+		startRenderAhead();
 	g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, _handle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 }
 
 void EmulatedChip::stopCallbacks() {
 	g_system->getMixer()->stopHandle(*_handle);
+	stopRenderAhead();
+	setRenderAhead(0);
 }
 
 void EmulatedChip::setCallbackFrequency(int timerFrequency) {
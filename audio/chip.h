@@ -22,7 +22,9 @@
 #ifndef AUDIO_CHIP_H
 #define AUDIO_CHIP_H
 
+#include "common/array.h"
 #include "common/func.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 
 #include "audio/audiostream.h"
@@ -45,7 +47,8 @@ public:
 	void start(TimerCallback *callback, int timerFrequency);
 
 	/**
-	 * Stop the sound chip
+	 * Stop the sound chip. This waits for running callbacks, so it must
+	 * not be called while holding a lock the callback takes.
 	 */
 	void stop();
 
@@ -142,13 +145,46 @@ protected:
 	 */
 	virtual void generateSamples(int16 *buffer, int numSamples) = 0;
 
+	/**
+	 * Set how many milliseconds of samples are rendered ahead of playback.
+	 * Zero renders all samples when the mixer asks for them.
+	 */
+	void setRenderAhead(int milliseconds);
+
+	/**
+	 * Fill the render-ahead buffer. The samples the buffer cannot
+	 * provide are rendered in readBuffer().
+	 */
+	void renderAhead();
+
 private:
+	void startRenderAhead();
+	void stopRenderAhead();
+	static void renderAheadProc(void *refCon);
+	void renderSamples(int16 *buffer, int numSamples);
+
+	enum {
+		kRenderAheadInterval = 10000,	// in microseconds
+		kRenderAheadChunk = 512		// in sample frames
+	};
+
 	int _baseFreq;
 
 	int _nextTick;
 	int _samplesPerTick;
 
 	Audio::SoundHandle *_handle;
+
+	// Guards the render-ahead buffer and the emulation. It is always taken
+	// after the mixer lock, which the callbacks may take.
+	Common::Mutex _renderMutex;
+	Common::Array<int16> _renderBuffer;
+	uint _renderRead;
+	uint _renderFill;
+
+	// Held while the timer thread renders ahead
+	Common::Mutex _renderAheadMutex;
+	Common::Array<int16> _renderChunk;
 };
 
 } // End of namespace Audio
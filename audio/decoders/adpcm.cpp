@@ -64,24 +64,42 @@ bool ADPCMStream::rewind() {
 	return true;
 }
 
+uint32 ADPCMStream::readData(byte *data, uint32 size) {
+	size = MIN<uint32>(size, _endpos - _stream->pos());
+	uint32 read = _stream->read(data, size);
+	if (read < size)
+		data[read++] = 0;
+	return read;
+}
+
 
 #pragma mark -
 
 
 int Oki_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+	int samples = 0;
+
+	while (samples < numSamples && !endOfData()) {
+		if (_decodedSampleCount == 0 && numSamples - samples >= 2) {
+			// Decode whole bytes straight into the buffer
+			byte data[kDecodeChunkSize];
+			const uint32 size = readData(data, MIN<uint32>((numSamples - samples) / 2, kDecodeChunkSize));
+			for (uint32 i = 0; i < size; i++) {
+				buffer[samples++] = decodeOKI((data[i] >> 4) & 0x0f);
+				buffer[samples++] = decodeOKI((data[i] >> 0) & 0x0f);
+			}
+			continue;
+		}
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
 		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
+			byte data = _stream->readByte();
 			_decodedSamples[0] = decodeOKI((data >> 4) & 0x0f);
 			_decodedSamples[1] = decodeOKI((data >> 0) & 0x0f);
 			_decodedSampleCount = 2;
 		}
 
 		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
+		buffer[samples++] = _decodedSamples[1 - (_decodedSampleCount - 1)];
 		_decodedSampleCount--;
 	}
 
@@ -122,7 +140,7 @@ int16 Oki_ADPCMStream::decodeOKI(byte code) {
 
 int XA_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	int samples;
-	byte *data = new byte[128];
+	byte data[128];
 
 	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
 		if (_decodedSampleCount == 0) {
@@ -143,7 +161,6 @@ int XA_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 		_decodedSampleCount--;
 	}
 
-	delete[] data;
 	return samples;
 }
 
@@ -221,19 +238,30 @@ void XA_ADPCMStream::decodeXA(const byte *src) {
 
 
 int DVI_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+	const int secondChannel = _channels == 2 ? 1 : 0;
+	int samples = 0;
+
+	while (samples < numSamples && !endOfData()) {
+		if (_decodedSampleCount == 0 && numSamples - samples >= 2) {
+			// Decode whole bytes straight into the buffer
+			byte data[kDecodeChunkSize];
+			const uint32 size = readData(data, MIN<uint32>((numSamples - samples) / 2, kDecodeChunkSize));
+			for (uint32 i = 0; i < size; i++) {
+				buffer[samples++] = decodeIMA((data[i] >> 4) & 0x0f, 0);
+				buffer[samples++] = decodeIMA((data[i] >> 0) & 0x0f, secondChannel);
+			}
+			continue;
+		}
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
 		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
+			byte data = _stream->readByte();
 			_decodedSamples[0] = decodeIMA((data >> 4) & 0x0f, 0);
-			_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, _channels == 2 ? 1 : 0);
+			_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, secondChannel);
 			_decodedSampleCount = 2;
 		}
 
 		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
+		buffer[samples++] = _decodedSamples[1 - (_decodedSampleCount - 1)];
 		_decodedSampleCount--;
 	}
 
@@ -314,8 +342,21 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	// Need to write at least one sample per channel
 	assert((numSamples % _channels) == 0);
 
+	// Each set holds four bytes, eight samples, per channel
+	const uint32 setSize = _channels * 4;
+	const int setSamples = _channels * 8;
 	int samples = 0;
 
+	// Samples left over from the previous call
+	while (samples < numSamples && _samplesLeft[0] != 0) {
+		for (int i = 0; i < _channels; i++) {
+			buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
+			_samplesLeft[i]--;
+		}
+
+		samples += _channels;
+	}
+
 	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
 		if (_blockPos[0] == _blockAlign) {
 			for (int i = 0; i < _channels; i++) {
@@ -327,6 +368,36 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 			_blockPos[0] = _channels * 4;
 		}
 
+		// Decode whole sets of the block straight into the buffer. Every set
+		// starting before the end of the data is decoded, and the set
+		// running into the end of the stream is filled up with zeros.
+		uint32 sets = MIN<uint32>((numSamples - samples) / setSamples, (_blockAlign - _blockPos[0]) / setSize);
+		sets = MIN<uint32>(sets, (_endpos - _stream->pos() + setSize - 1) / setSize);
+		sets = MIN<uint32>(sets, kDecodeChunkSize / setSize);
+		if (sets > 0) {
+			byte data[kDecodeChunkSize];
+			const uint32 read = _stream->read(data, sets * setSize);
+			if (read < sets * setSize) {
+				sets = read / setSize + 1;
+				memset(data + read, 0, sets * setSize - read);
+			}
+			_blockPos[0] += sets * setSize;
+
+			const byte *src = data;
+			for (uint32 set = 0; set < sets; set++) {
+				for (int i = 0; i < _channels; i++) {
+					int16 *dst = buffer + samples + i;
+					for (int j = 0; j < 4; j++) {
+						dst[(j * 2) * _channels] = decodeIMA(*src & 0x0f, i);
+						dst[(j * 2 + 1) * _channels] = decodeIMA((*src >> 4) & 0x0f, i);
+						src++;
+					}
+				}
+				samples += setSamples;
+			}
+			continue;
+		}
+
 		// Decode a set of samples
 		for (int i = 0; i < _channels; i++) {
 			// The stream encodes four bytes per channel at a time
@@ -339,6 +410,7 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 			}
 		}
 
+		// The rest is kept for the next call
 		while (samples < numSamples && _samplesLeft[0] != 0) {
 			for (int i = 0; i < _channels; i++) {
 				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
@@ -388,11 +460,23 @@ int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
 }
 
 int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
+	int samples = 0;
 	byte data;
 	int i;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
+	while (samples < numSamples && !endOfData()) {
+		if (_decodedSampleCount == 0 && _blockPos[0] < _blockAlign && numSamples - samples >= 2) {
+			// Decode whole bytes of the block straight into the buffer
+			byte chunk[kDecodeChunkSize];
+			const uint32 size = readData(chunk, MIN<uint32>(MIN<uint32>((numSamples - samples) / 2, _blockAlign - _blockPos[0]), kDecodeChunkSize));
+			_blockPos[0] += size;
+			for (uint32 j = 0; j < size; j++) {
+				buffer[samples++] = decodeMS(&_status.ch[0], (chunk[j] >> 4) & 0x0f);
+				buffer[samples++] = decodeMS(&_status.ch[_channels - 1], chunk[j] & 0x0f);
+			}
+			continue;
+		}
+
 		if (_decodedSampleCount == 0) {
 			if (_blockPos[0] == _blockAlign) {
 				// read block header
@@ -425,7 +509,7 @@ int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 		}
 
 		// _decodedSamples acts as a FIFO of depth 2 or 4;
-		buffer[samples] = _decodedSamples[_decodedSampleIndex++];
+		buffer[samples++] = _decodedSamples[_decodedSampleIndex++];
 		_decodedSampleCount--;
 	}
 
@@ -59,6 +59,17 @@ protected:
 
 	virtual void reset();
 
+	enum {
+		kDecodeChunkSize = 256	// Bytes read from the stream at once by the block decoders
+	};
+
+	/**
+	 * Read up to size bytes, but not past the end of the ADPCM data. Like
+	 * readByte(), running into the end of the stream yields a zero byte.
+	 * There must be data left when calling this.
+	 */
+	uint32 readData(byte *data, uint32 size);
+
 public:
 	ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign);
 
@@ -23,6 +23,8 @@
 
 #ifdef USE_MAD
 
+#include "common/algorithm.h"
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/mutex.h"
 #include "common/ptr.h"
@@ -106,6 +108,30 @@ protected:
 
 	Timestamp _length;
 
+	/**
+	 * Start of every kSeekPointInterval-th frame, collected while the
+	 * length of the stream is determined. Seeking starts from the last
+	 * point before the destination instead of the start of the stream.
+	 */
+	struct SeekPoint {
+		mad_timer_t time;
+		uint32 offset;
+	};
+
+	struct SeekPointTimeLess {
+		bool operator()(const mad_timer_t &time, const SeekPoint &point) const {
+			return mad_timer_compare(time, point.time) < 0;
+		}
+	};
+
+	enum {
+		kSeekPointInterval = 32
+	};
+
+	Common::Array<SeekPoint> _seekPoints;
+
+	void addSeekPoint(const mad_timer_t &time);
+
 private:
 	static Common::SeekableReadStream *skipID3(Common::SeekableReadStream *stream, DisposeAfterUse::Flag dispose);
 };
@@ -336,9 +362,14 @@ MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag
 	_channels = MAD_NCHANNELS(&_frame.header);
 	_rate = _frame.header.samplerate;
 
-	// Calculate the length of the stream
-	while (_state != MP3_STATE_EOS)
+	// Calculate the length of the stream and remember where the frames are
+	_seekPoints.clear();
+	for (uint32 frame = 1; _state != MP3_STATE_EOS; frame++) {
+		const mad_timer_t frameStart = _curTime;
 		readHeader(*_inStream);
+		if (_state == MP3_STATE_READY && frame % kSeekPointInterval == 0)
+			addSeekPoint(frameStart);
+	}
 
 	// To rule out any invalid sample rate to be encountered here, say in case the
 	// MP3 stream is invalid, we just check the MAD error code here.
@@ -376,7 +407,17 @@ bool MP3Stream::seek(const Timestamp &where) {
 	mad_timer_t destination;
 	mad_timer_set(&destination, time / 1000, time % 1000, 1000);
 
-	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0) {
+	const bool rewind = _state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0;
+
+	// Continue from the last known frame before the destination, when
+	// it is further than the current position
+	const SeekPoint *point = Common::upperBound(_seekPoints.begin(), _seekPoints.end(), destination, SeekPointTimeLess());
+	if (point != _seekPoints.begin() && (rewind || mad_timer_compare((point - 1)->time, _curTime) > 0)) {
+		point--;
+		_inStream->seek(point->offset);
+		initStream(*_inStream);
+		_curTime = point->time;
+	} else if (rewind) {
 		_inStream->seek(0);
 		initStream(*_inStream);
 	}
@@ -389,6 +430,14 @@ bool MP3Stream::seek(const Timestamp &where) {
 	return (_state != MP3_STATE_EOS);
 }
 
+void MP3Stream::addSeekPoint(const mad_timer_t &time) {
+	// The buffer holds the data up to the current position of the input
+	SeekPoint point;
+	point.time = time;
+	point.offset = (uint32)(_inStream->pos() - (_stream.bufend - _stream.this_frame));
+	_seekPoints.push_back(point);
+}
+
 Common::SeekableReadStream *MP3Stream::skipID3(Common::SeekableReadStream *stream, DisposeAfterUse::Flag dispose) {
 	// Skip ID3 TAG if any
 	// ID3v1 (beginning with with 'TAG') is located at the end of files. So we can ignore those.
@@ -84,6 +84,9 @@ namespace DBOPL {
 #define ENV_LIMIT	( ( 12 * 256) >> ( 3 - ENV_EXTRA ) )
 #define ENV_SILENT( _X_ ) ( (_X_) >= ENV_LIMIT )
 
+//Amount of samples the operators are forwarded at once
+#define BLOCK_BATCH	64
+
 //Attack/decay/release rate counter shift
 #define RATE_SH		24
 #define RATE_MASK	( ( 1 << RATE_SH ) - 1 )
@@ -598,6 +601,120 @@ INLINE Bits Operator::GetSample( Bits modulation ) {
 	}
 }
 
+//Generate the envelope until the state changes, this matches TemplateVolume
+//but keeps the envelope in locals, as the compiler can't tell the writes to
+//vol apart from the members
+template< Operator::State yes >
+Bitu Operator::TemplateVolumeBlock( Bitu i, Bitu samples, Bitu* vol ) {
+	const Bitu level = currentLevel;
+	Bit32s v = volume;
+	Bit32u index = rateIndex;
+	Bit8u next = yes;
+	for ( ; i < samples && next == yes; i++ ) {
+		Bit32s change;
+		switch ( yes ) {
+		case ATTACK:
+			index += attackAdd;
+			change = index >> RATE_SH;
+			index &= RATE_MASK;
+			if ( change ) {
+				v += ( (~v) * change ) >> 3;
+				if ( v < ENV_MIN ) {
+					v = ENV_MIN;
+					index = 0;
+					next = DECAY;
+				}
+			}
+			break;
+		case DECAY:
+			index += decayAdd;
+			v += index >> RATE_SH;
+			index &= RATE_MASK;
+			if ( GCC_UNLIKELY(v >= sustainLevel) ) {
+				if ( GCC_UNLIKELY(v >= ENV_MAX) ) {
+					v = ENV_MAX;
+					next = OFF;
+				} else {
+					index = 0;
+					next = SUSTAIN;
+				}
+			}
+			break;
+		case SUSTAIN:
+		case RELEASE:
+			index += releaseAdd;
+			v += index >> RATE_SH;
+			index &= RATE_MASK;
+			if ( GCC_UNLIKELY(v >= ENV_MAX) ) {
+				v = ENV_MAX;
+				next = OFF;
+			}
+			break;
+		default:
+			break;
+		}
+		vol[i] = level + v;
+	}
+	volume = v;
+	rateIndex = index;
+	if ( next != yes )
+		SetState( next );
+	return i;
+}
+
+//Generate the envelope for a batch of samples, see Channel::BlockBatch
+void Operator::ForwardVolumeBlock( Bitu samples, Bitu* vol ) {
+	for ( Bitu i = 0; i < samples; ) {
+		switch ( state ) {
+		case SUSTAIN:
+			if ( !( reg20 & MASK_SUSTAIN ) ) {
+				i = TemplateVolumeBlock< SUSTAIN >( i, samples, vol );
+				break;
+			}
+			//The volume only changes with a key change, which can't happen during a batch
+			//fall through
+		case OFF:
+			{
+				const Bitu level = currentLevel + ( state == OFF ? ENV_MAX : volume );
+				for ( ; i < samples; i++ ) {
+					vol[i] = level;
+				}
+			}
+			break;
+		case RELEASE:
+			i = TemplateVolumeBlock< RELEASE >( i, samples, vol );
+			break;
+		case DECAY:
+			i = TemplateVolumeBlock< DECAY >( i, samples, vol );
+			break;
+		case ATTACK:
+			i = TemplateVolumeBlock< ATTACK >( i, samples, vol );
+			break;
+		default:
+			vol[i++] = ForwardVolume();
+			break;
+		}
+	}
+}
+
+//Forward the wave for a batch of samples, silent operators advance it too
+void Operator::ForwardWaveBlock( Bitu samples, Bitu* index ) {
+	const Bit32u start = waveIndex;
+	for ( Bitu i = 0; i < samples; i++ ) {
+		index[i] = (Bit32u)( start + ( i + 1 ) * waveCurrent ) >> WAVE_SH;
+	}
+	waveIndex = start + samples * waveCurrent;
+}
+
+//Same as GetSample with the volume and wave already forwarded
+INLINE Bits Operator::GetBlockSample( Bitu index, Bitu vol, Bits modulation ) {
+	if ( ENV_SILENT( vol ) ) {
+		return 0;
+	}
+	index += modulation;
+	return GetWave( index, vol );
+}
+
 Operator::Operator() {
 	chanData = 0;
 	freqMul = 0;
@@ -843,6 +960,61 @@ INLINE void Channel::GeneratePercussion( Chip* chip, Bit32s* output ) {
 	}
 }
 
+//Synthesize a batch of samples in a non percussion mode, with the output of
+//the first operator already generated by Chip::GenerateBatches
+//None of the samples depend on each other anymore and they are kept local
+//until the end, so the compiler does not have to assume that writing the
+//output changes the operators
+template<SynthMode mode>
+void Channel::BlockBatch( Bitu samples, const Bit32s* first, Bit32s* output ) {
+	Bitu vol[4][BLOCK_BATCH];
+	Bitu index[4][BLOCK_BATCH];
+	Bit32s result[BLOCK_BATCH];
+	const Bitu ops = ( mode > sm4Start ) ? 4 : 2;
+	for ( Bitu o = 1; o < ops; o++ ) {
+		Op( o )->ForwardVolumeBlock( samples, vol[o] );
+		Op( o )->ForwardWaveBlock( samples, index[o] );
+	}
+	for ( Bitu i = 0; i < samples; i++ ) {
+		Bit32s sample;
+		Bit32s out0 = first[i];
+		if ( mode == sm2AM || mode == sm3AM ) {
+			sample = out0 + Op(1)->GetBlockSample( index[1][i], vol[1][i], 0 );
+		} else if ( mode == sm2FM || mode == sm3FM ) {
+			sample = Op(1)->GetBlockSample( index[1][i], vol[1][i], out0 );
+		} else if ( mode == sm3FMFM ) {
+			Bits next = Op(1)->GetBlockSample( index[1][i], vol[1][i], out0 );
+			next = Op(2)->GetBlockSample( index[2][i], vol[2][i], next );
+			sample = Op(3)->GetBlockSample( index[3][i], vol[3][i], next );
+		} else if ( mode == sm3AMFM ) {
+			sample = out0;
+			Bits next = Op(1)->GetBlockSample( index[1][i], vol[1][i], 0 );
+			next = Op(2)->GetBlockSample( index[2][i], vol[2][i], next );
+			sample += Op(3)->GetBlockSample( index[3][i], vol[3][i], next );
+		} else if ( mode == sm3FMAM ) {
+			sample = Op(1)->GetBlockSample( index[1][i], vol[1][i], out0 );
+			Bits next = Op(2)->GetBlockSample( index[2][i], vol[2][i], 0 );
+			sample += Op(3)->GetBlockSample( index[3][i], vol[3][i], next );
+		} else if ( mode == sm3AMAM ) {
+			sample = out0;
+			Bits next = Op(1)->GetBlockSample( index[1][i], vol[1][i], 0 );
+			sample += Op(2)->GetBlockSample( index[2][i], vol[2][i], next );
+			sample += Op(3)->GetBlockSample( index[3][i], vol[3][i], 0 );
+		}
+		result[i] = sample;
+	}
+	if ( mode == sm2AM || mode == sm2FM ) {
+		for ( Bitu i = 0; i < samples; i++ ) {
+			output[ i ] += result[ i ];
+		}
+	} else {
+		for ( Bitu i = 0; i < samples; i++ ) {
+			output[ i * 2 + 0 ] += result[ i ] & maskLeft;
+			output[ i * 2 + 1 ] += result[ i ] & maskRight;
+		}
+	}
+}
+
 template<SynthMode mode>
 Channel* Channel::BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
 	switch( mode ) {
@@ -918,82 +1090,20 @@ Channel* Channel::BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
 		Op( 4 )->Prepare( chip );
 		Op( 5 )->Prepare( chip );
 	}
-	for ( Bitu i = 0; i < samples; i++ ) {
-		//Early out for percussion handlers
-		if ( mode == sm2Percussion ) {
+	//Early out for percussion handlers
+	if ( mode == sm2Percussion ) {
+		for ( Bitu i = 0; i < samples; i++ ) {
 			GeneratePercussion<false>( chip, output + i );
-			continue;	//Prevent some unitialized value bitching
-		} else if ( mode == sm3Percussion ) {
-			GeneratePercussion<true>( chip, output + i * 2 );
-			continue;	//Prevent some unitialized value bitching
-		}
-
-		//Do unsigned shift so we can shift out all bits but still stay in 10 bit range otherwise
-		Bit32s mod = (Bit32u)((old[0] + old[1])) >> feedback;
-		old[0] = old[1];
-		old[1] = Op(0)->GetSample( mod );
-		Bit32s sample;
-		Bit32s out0 = old[0];
-		if ( mode == sm2AM || mode == sm3AM ) {
-			sample = out0 + Op(1)->GetSample( 0 );
-		} else if ( mode == sm2FM || mode == sm3FM ) {
-			sample = Op(1)->GetSample( out0 );
-		} else if ( mode == sm3FMFM ) {
-			Bits next = Op(1)->GetSample( out0 );
-			next = Op(2)->GetSample( next );
-			sample = Op(3)->GetSample( next );
-		} else if ( mode == sm3AMFM ) {
-			sample = out0;
-			Bits next = Op(1)->GetSample( 0 );
-			next = Op(2)->GetSample( next );
-			sample += Op(3)->GetSample( next );
-		} else if ( mode == sm3FMAM ) {
-			sample = Op(1)->GetSample( out0 );
-			Bits next = Op(2)->GetSample( 0 );
-			sample += Op(3)->GetSample( next );
-		} else if ( mode == sm3AMAM ) {
-			sample = out0;
-			Bits next = Op(1)->GetSample( 0 );
-			sample += Op(2)->GetSample( next );
-			sample += Op(3)->GetSample( 0 );
 		}
-		switch( mode ) {
-		case sm2AM:
-		case sm2FM:
-			output[ i ] += sample;
-			break;
-		case sm3AM:
-		case sm3FM:
-		case sm3FMFM:
-		case sm3AMFM:
-		case sm3FMAM:
-		case sm3AMAM:
-			output[ i * 2 + 0 ] += sample & maskLeft;
-			output[ i * 2 + 1 ] += sample & maskRight;
-			break;
-		case sm2Percussion:
-			// This case was not handled in the DOSBox code either
-			// thus we leave this blank.
-			// TODO: Consider checking this.
-			break;
-		case sm3Percussion:
-			// This case was not handled in the DOSBox code either
-			// thus we leave this blank.
-			// TODO: Consider checking this.
-			break;
-		case sm4Start:
-			// This case was not handled in the DOSBox code either
-			// thus we leave this blank.
-			// TODO: Consider checking this.
-			break;
-		case sm6Start:
-			// This case was not handled in the DOSBox code either
-			// thus we leave this blank.
-			// TODO: Consider checking this.
-			break;
-		default:
-			break;
+	} else if ( mode == sm3Percussion ) {
+		for ( Bitu i = 0; i < samples; i++ ) {
+			GeneratePercussion<true>( chip, output + i * 2 );
 		}
+	} else {
+		//Generated together with the other channels after all handlers ran
+		chip->batchChannel[ chip->batchCount ] = this;
+		chip->batchHandler[ chip->batchCount ] = &Channel::BlockBatch< mode >;
+		chip->batchCount++;
 	}
 	switch( mode ) {
 	case sm2AM:
@@ -1035,6 +1145,7 @@ Chip::Chip() {
 	regBD = 0;
 	reg104 = 0;
 	opl3Active = 0;
+	batchCount = 0;
 }
 
 INLINE Bit32u Chip::ForwardNoise() {
@@ -1235,6 +1346,47 @@ Bit32u Chip::WriteAddr( Bit32u port, Bit8u val ) {
 	return 0;
 }
 
+void Chip::GenerateBatches( Bitu samples, Bit32s* output, Bitu stride ) {
+	Bitu vol[18][BLOCK_BATCH];
+	Bitu index[18][BLOCK_BATCH];
+	Bit32s first[18][BLOCK_BATCH];
+	//The feedback state is copied, the compiler can't tell it apart from the operators
+	Bit32s old[18][2];
+	Bit8u feedback[18];
+	for ( Bitu c = 0; c < batchCount; c++ ) {
+		old[c][0] = batchChannel[c]->old[0];
+		old[c][1] = batchChannel[c]->old[1];
+		feedback[c] = batchChannel[c]->feedback;
+	}
+	for ( Bitu start = 0; start < samples; start += BLOCK_BATCH ) {
+		const Bitu todo = ( samples - start < BLOCK_BATCH ) ? samples - start : BLOCK_BATCH;
+		for ( Bitu c = 0; c < batchCount; c++ ) {
+			batchChannel[c]->Op( 0 )->ForwardVolumeBlock( todo, vol[c] );
+			batchChannel[c]->Op( 0 )->ForwardWaveBlock( todo, index[c] );
+		}
+		//The feedback makes every sample of the first operator depend on the
+		//previous ones, running the channels side by side lets those chains
+		//overlap instead of waiting for each other
+		for ( Bitu i = 0; i < todo; i++ ) {
+			for ( Bitu c = 0; c < batchCount; c++ ) {
+				//Do unsigned shift so we can shift out all bits but still stay in 10 bit range otherwise
+				Bit32s mod = (Bit32u)((old[c][0] + old[c][1])) >> feedback[c];
+				old[c][0] = old[c][1];
+				old[c][1] = batchChannel[c]->Op( 0 )->GetBlockSample( index[c][i], vol[c][i], mod );
+				first[c][i] = old[c][0];
+			}
+		}
+		for ( Bitu c = 0; c < batchCount; c++ ) {
+			(batchChannel[c]->*(batchHandler[c]))( todo, first[c], output + start * stride );
+		}
+	}
+	for ( Bitu c = 0; c < batchCount; c++ ) {
+		batchChannel[c]->old[0] = old[c][0];
+		batchChannel[c]->old[1] = old[c][1];
+	}
+	batchCount = 0;
+}
+
 void Chip::GenerateBlock2( Bitu total, Bit32s* output ) {
 	while ( total > 0 ) {
 		Bit32u samples = ForwardLFO( total );
@@ -1242,6 +1394,7 @@ void Chip::GenerateBlock2( Bitu total, Bit32s* output ) {
 		for( Channel* ch = chan; ch < chan + 9; ) {
 			ch = (ch->*(ch->synthHandler))( this, samples, output );
 		}
+		GenerateBatches( samples, output, 1 );
 		total -= samples;
 		output += samples;
 	}
@@ -1254,6 +1407,7 @@ void Chip::GenerateBlock3( Bitu total, Bit32s* output  ) {
 		for( Channel* ch = chan; ch < chan + 18; ) {
 			ch = (ch->*(ch->synthHandler))( this, samples, output );
 		}
+		GenerateBatches( samples, output, 2 );
 		total -= samples;
 		output += samples * 2;
 	}
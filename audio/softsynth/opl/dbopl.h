@@ -68,6 +68,7 @@ typedef Bits ( DB_FASTCALL *WaveHandler) ( Bitu i, Bitu volume );
 
 typedef Bits ( DBOPL::Operator::*VolumeHandler) ( );
 typedef Channel* ( DBOPL::Channel::*SynthHandler) ( Chip* chip, Bit32u samples, Bit32s* output );
+typedef void ( DBOPL::Channel::*BatchHandler) ( Bitu samples, const Bit32s* first, Bit32s* output );
 
 //Different synth modes that can generate blocks of data
 typedef enum {
@@ -178,6 +179,12 @@ public:
 
 	Bits GetSample( Bits modulation );
 	Bits GetWave( Bitu index, Bitu vol );
+
+	template< State state>
+	Bitu TemplateVolumeBlock( Bitu i, Bitu samples, Bitu* vol );
+	void ForwardVolumeBlock( Bitu samples, Bitu* vol );
+	void ForwardWaveBlock( Bitu samples, Bitu* index );
+	Bits GetBlockSample( Bitu index, Bitu vol, Bits modulation );
 public:
 	Operator();
 };
@@ -212,6 +219,10 @@ struct Channel {
 	template< bool opl3Mode >
 	void GeneratePercussion( Chip* chip, Bit32s* output );
 
+	//Generate a batch of at most BLOCK_BATCH samples in a non percussion mode
+	template<SynthMode mode>
+	void BlockBatch( Bitu samples, const Bit32s* first, Bit32s* output );
+
 	//Generate blocks of data in specific modes
 	template<SynthMode mode>
 	Channel* BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output );
@@ -254,6 +265,11 @@ struct Chip {
 	//0 or -1 when enabled
 	Bit8s opl3Active;
 
+	//Channels queued by their synth handler to generate the block together
+	Bitu batchCount;
+	Channel* batchChannel[18];
+	BatchHandler batchHandler[18];
+
 	//Return the maximum amount of samples before and LFO change
 	Bit32u ForwardLFO( Bit32u samples );
 	Bit32u ForwardNoise();
@@ -263,6 +279,7 @@ struct Chip {
 
 	Bit32u WriteAddr( Bit32u port, Bit8u val );
 
+	void GenerateBatches( Bitu samples, Bit32s* output, Bitu stride );
 	void GenerateBlock2( Bitu samples, Bit32s* output );
 	void GenerateBlock3( Bitu samples, Bit32s* output );
 
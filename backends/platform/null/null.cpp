@@ -49,14 +49,14 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/mixer/null/null-mixer.h"
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
-#include "backends/mixer/null/null-mixer.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
 
@@ -95,6 +95,19 @@ public:
 
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority);
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// Audio code under test can play into the mixer, which never runs
+	void initMixer() {
+		_mixerManager = new NullMixerManager();
+		_mixerManager->init();
+	}
+
+	// hasFeature() is answered by the graphics manager
+	void initGraphics() {
+		_graphicsManager = new NullGraphicsManager();
+	}
+#endif
+
 private:
 #ifdef POSIX
 	timeval _startTime;
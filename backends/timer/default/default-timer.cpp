@@ -33,89 +33,184 @@ struct TimerSlot {
 	uint32 nextFireTime;	// in milliseconds
 	uint32 nextFireTimeMicro;	// microseconds part of nextFire
 
+	// Circular list of the timers in the same wheel bucket
+	TimerSlot *prev;
 	TimerSlot *next;
+	TimerSlot **bucket;
+	int level;
 
-	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0), next(nullptr) {}
-};
-
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = nullptr;
+	uint32 calls;
+	uint32 maxLateness;	// in microseconds
+	uint64 totalLateness;	// in microseconds
 
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == nullptr || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
-}
+	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0),
+		prev(nullptr), next(nullptr), bucket(nullptr), level(0), calls(0), maxLateness(0), totalLateness(0) {}
+};
 
 
 DefaultTimerManager::DefaultTimerManager() :
-	_timerCallbackNext(0),
-	_head(nullptr) {
+	_wheelTime(0),
+	_timerCallbackNext(0) {
 
-	_head = new TimerSlot();
+	memset(_wheel, 0, sizeof(_wheel));
+	memset(_wheelCount, 0, sizeof(_wheelCount));
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
+	Common::StackLock dispatchLock(_dispatchMutex);
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
+	for (auto &slot : _slots)
 		delete slot;
-		slot = next;
+	_slots.clear();
+	memset(_wheel, 0, sizeof(_wheel));
+	memset(_wheelCount, 0, sizeof(_wheelCount));
+}
+
+uint32 DefaultTimerManager::getMillis(bool skipRecord) const {
+	return g_system->getMillis(skipRecord);
+}
+
+void DefaultTimerManager::scheduleSlot(TimerSlot *slot) {
+	uint32 expires = slot->nextFireTime;
+	uint32 delta = expires - _wheelTime;
+
+	if ((int32)delta < 0) {
+		// Overdue, expire with the current millisecond
+		expires = _wheelTime;
+		delta = 0;
+	} else if (delta >= (1U << (kWheelBits * kWheelLevels))) {
+		// Beyond the range of the wheel. The timer is put into the last
+		// bucket and scheduled again once the wheel gets there.
+		expires = _wheelTime + (1U << (kWheelBits * kWheelLevels)) - 1;
+		delta = expires - _wheelTime;
+	}
+
+	int level = 0;
+	while (level < kWheelLevels - 1 && delta >= (1U << (kWheelBits * (level + 1))))
+		level++;
+
+	TimerSlot **bucket = &_wheel[level][(expires >> (kWheelBits * level)) & kWheelMask];
+	TimerSlot *head = *bucket;
+	if (head) {
+		// Append, so that timers due in the same millisecond fire in the
+		// order they were scheduled
+		slot->prev = head->prev;
+		slot->next = head;
+		head->prev->next = slot;
+		head->prev = slot;
+	} else {
+		slot->prev = slot->next = slot;
+		*bucket = slot;
 	}
-	_head = nullptr;
+	slot->bucket = bucket;
+	slot->level = level;
+	_wheelCount[level]++;
 }
 
-void DefaultTimerManager::handler() {
-	Common::StackLock lock(_mutex);
+void DefaultTimerManager::unscheduleSlot(TimerSlot *slot) {
+	assert(slot->bucket);
+	if (slot->next == slot) {
+		*slot->bucket = nullptr;
+	} else {
+		slot->prev->next = slot->next;
+		slot->next->prev = slot->prev;
+		if (*slot->bucket == slot)
+			*slot->bucket = slot->next;
+	}
+	slot->prev = slot->next = nullptr;
+	slot->bucket = nullptr;
+	_wheelCount[slot->level]--;
+}
 
-	uint32 curTime = g_system->getMillis(true);
+void DefaultTimerManager::cascade(int level) {
+	// Move the timers of the bucket the wheel has reached down to
+	// the finer levels
+	TimerSlot **bucket = &_wheel[level][(_wheelTime >> (kWheelBits * level)) & kWheelMask];
+	while (*bucket) {
+		TimerSlot *slot = *bucket;
+		unscheduleSlot(slot);
+		scheduleSlot(slot);
+	}
+}
 
-	// On slow systems this could still be run after destructor
-	if (!_head)
-		return;
+TimerSlot *DefaultTimerManager::nextExpiredSlot(uint32 curTime) {
+	if (_slots.empty()) {
+		_wheelTime = curTime;
+		return nullptr;
+	}
+
+	// A timer expires once curTime has passed its fire time
+	while ((int32)(curTime - _wheelTime) > 0) {
+		TimerSlot *slot = _wheel[0][_wheelTime & kWheelMask];
+		if (slot) {
+			unscheduleSlot(slot);
+			return slot;
+		}
+
+		if (_wheelCount[0] == 0) {
+			// Nothing can expire before the upper levels cascade again
+			_wheelTime = MIN<uint32>(_wheelTime | kWheelMask, curTime - 1);
+		}
+
+		_wheelTime++;
+		for (int level = 1; level < kWheelLevels; level++) {
+			if ((_wheelTime >> (kWheelBits * (level - 1))) & kWheelMask)
+				break;
+			cascade(level);
+		}
+	}
+
+	return nullptr;
+}
+
+void DefaultTimerManager::handler() {
+	// Callbacks are invoked without holding _mutex, so that a slow
+	// callback does not delay installing or removing other timers
+	Common::StackLock dispatchLock(_dispatchMutex);
+
+	uint32 curTime = getMillis(true);
 
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
-
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
-		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
+	while (true) {
+		TimerProc callback;
+		void *refCon;
+
+		{
+			Common::StackLock lock(_mutex);
+
+			TimerSlot *slot = nextExpiredSlot(curTime);
+			if (!slot)
+				break;
+
+			const uint32 lateness = (curTime - slot->nextFireTime) * 1000 - slot->nextFireTimeMicro;
+			slot->calls++;
+			slot->totalLateness += lateness;
+			slot->maxLateness = MAX(slot->maxLateness, lateness);
+
+			// Update the fire time and put the TimerSlot back into
+			// the wheel.
+			assert(slot->interval > 0);
+			slot->nextFireTime += (slot->interval / 1000);
+			slot->nextFireTimeMicro += (slot->interval % 1000);
+			if (slot->nextFireTimeMicro >= 1000) {
+				slot->nextFireTime += slot->nextFireTimeMicro / 1000;
+				slot->nextFireTimeMicro %= 1000;
+			}
+			scheduleSlot(slot);
+
+			callback = slot->callback;
+			refCon = slot->refCon;
 		}
-		insertPrioQueue(_head, slot);
 
 		// Invoke the timer callback
-		assert(slot->callback);
-		slot->callback(slot->refCon);
-
-		// Look at the next scheduled timer
-		slot = _head->next;
+		assert(callback);
+		callback(refCon);
 	}
 }
 
 void DefaultTimerManager::checkTimers(uint32 interval) {
-	uint32 curTime = g_system->getMillis();
+	uint32 curTime = getMillis();
 
 	// Timer checking & firing
 	if (curTime >= _timerCallbackNext) {
@@ -141,49 +236,74 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	}
 	_callbacks[id] = callback;
 
+	// The wheel does not advance while it is empty
+	if (_slots.empty())
+		_wheelTime = getMillis(true);
+
 	TimerSlot *slot = new TimerSlot;
 	slot->callback = callback;
 	slot->refCon = refCon;
 	slot->id = id;
 	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
+	slot->nextFireTime = getMillis() + interval / 1000;
 	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = nullptr;
 
-	insertPrioQueue(_head, slot);
+	_slots.push_back(slot);
+	scheduleSlot(slot);
 
 	return true;
 }
 
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
-	Common::StackLock lock(_mutex);
-
-	TimerSlot *slot = _head;
+	{
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _slots.size();) {
+			TimerSlot *slot = _slots[i];
+			if (slot->callback == callback) {
+				unscheduleSlot(slot);
+				delete slot;
+				_slots.remove_at(i);
+			} else {
+				i++;
+			}
+		}
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
-		} else {
-			slot = slot->next;
+		// We need to remove all names referencing the timer proc here.
+		//
+		// Else we run into troubles, when the client code removes and readds timer
+		// callbacks.
+		//
+		// Another issues occurs when one plays a game with ALSA as music driver,
+		// returns to launcher and starts a different engine game with ALSA as music driver.
+		// In this case the MPU401 code will add different timer procs with the
+		// same name, resulting in two different callbacks added with the same
+		// name and causing installTimerProc to error out.
+		// A good test case is running a SCUMM with ALSA output and then a KYRA
+		// game for example.
+		for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
+			if (i->_value == callback)
+				_callbacks.erase(i);
 		}
 	}
 
-	// We need to remove all names referencing the timer proc here.
-	//
-	// Else we run into troubles, when the client code removes and readds timer
-	// callbacks.
-	//
-	// Another issues occurs when one plays a game with ALSA as music driver,
-	// returns to launcher and starts a different engine game with ALSA as music driver.
-	// In this case the MPU401 code will add different timer procs with the
-	// same name, resulting in two different callbacks added with the same
-	// name and causing installTimerProc to error out.
-	// A good test case is running a SCUMM with ALSA output and then a KYRA
-	// game for example.
-	for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
-		if (i->_value == callback)
-			_callbacks.erase(i);
+	// The callback may still be running in handler(). Wait for it to
+	// return, since the caller may release refCon as soon as we are done.
+	// Mutexes are recursive, so a callback can still remove itself.
+	Common::StackLock dispatchLock(_dispatchMutex);
+}
+
+void DefaultTimerManager::getStatistics(Common::Array<TimerStatistics> &stats) {
+	Common::StackLock lock(_mutex);
+
+	stats.clear();
+	for (const auto &slot : _slots) {
+		TimerStatistics timerStats;
+		timerStats.id = slot->id;
+		timerStats.interval = slot->interval;
+		timerStats.calls = slot->calls;
+		timerStats.maxLateness = slot->maxLateness;
+		timerStats.totalLateness = slot->totalLateness;
+		stats.push_back(timerStats);
 	}
 }
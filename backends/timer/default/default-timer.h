@@ -22,6 +22,7 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -30,15 +31,61 @@
 struct TimerSlot;
 
 class DefaultTimerManager : public Common::TimerManager {
+public:
+	/**
+	 * How late the callbacks of one timer were invoked, measured from
+	 * their scheduled time to the time the handler ran.
+	 */
+	struct TimerStatistics {
+		Common::String id;
+		uint32 interval;	// in microseconds
+		uint32 calls;
+		uint32 maxLateness;	// in microseconds
+		uint64 totalLateness;	// in microseconds
+	};
+
 private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
+	/**
+	 * Timers are kept in a hierarchical timing wheel. The first level has a
+	 * bucket for each of the next 256 milliseconds, each further level
+	 * covers 256 buckets of the previous one. Buckets of the upper levels
+	 * are redistributed to the lower ones when the wheel reaches them, so
+	 * scheduling and expiring a timer does not depend on the number of
+	 * installed timers.
+	 */
+	enum {
+		kWheelBits = 8,
+		kWheelSize = 1 << kWheelBits,
+		kWheelMask = kWheelSize - 1,
+		kWheelLevels = 3
+	};
+
 	Common::Mutex _mutex;
-	TimerSlot *_head;
+	// Held while callbacks are invoked. Callbacks run without _mutex, so
+	// a slow one does not block installing and removing other timers.
+	Common::Mutex _dispatchMutex;
+
+	TimerSlot *_wheel[kWheelLevels][kWheelSize];
+	uint32 _wheelCount[kWheelLevels];
+	uint32 _wheelTime;	// next millisecond to expire
+	Common::Array<TimerSlot *> _slots;
 	TimerSlotMap _callbacks;
 
 	uint32 _timerCallbackNext;
 
+	void scheduleSlot(TimerSlot *slot);
+	void unscheduleSlot(TimerSlot *slot);
+	void cascade(int level);
+	TimerSlot *nextExpiredSlot(uint32 curTime);
+
+protected:
+	/**
+	 * The clock the timers run on, g_system->getMillis() by default.
+	 */
+	virtual uint32 getMillis(bool skipRecord = false) const;
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
@@ -55,6 +102,11 @@ public:
 	 * Should be called from pollEvents() on backends without threads.
 	 */
 	void checkTimers(uint32 interval = 10);
+
+	/**
+	 * Get the drift statistics of all installed timers.
+	 */
+	void getStatistics(Common::Array<TimerStatistics> &stats);
 };
 
 #endif
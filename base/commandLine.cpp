@@ -328,6 +328,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("mt32_device", "null");
 	ConfMan.registerDefault("gm_device", "auto");
 	ConfMan.registerDefault("opl2lpt_parport", "null");
+	ConfMan.registerDefault("emulated_chip_render_ahead", 0);
 
 	ConfMan.registerDefault("cdrom", 0);
 
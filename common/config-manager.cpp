@@ -23,8 +23,11 @@
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/memstream.h"
+#include "common/mutex.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 
 static bool isValidDomainName(const Common::String &domName) {
 	const char *p = domName.c_str();
@@ -33,6 +36,22 @@ static bool isValidDomainName(const Common::String &domName) {
 	return *p == 0;
 }
 
+// Return the end of the line starting at p, without its line break
+static const char *findLineEnd(const char *p, const char *end) {
+	while (p < end && *p != '\n' && *p != '\r')
+		p++;
+	return p;
+}
+
+// Skip a CR, LF or CR LF line break
+static const char *skipLineBreak(const char *p, const char *end) {
+	if (p < end && *p == '\r')
+		p++;
+	if (p < end && *p == '\n')
+		p++;
+	return p;
+}
+
 namespace Common {
 
 DECLARE_SINGLETON(ConfigManager);
@@ -50,7 +69,15 @@ char const *const ConfigManager::kCloudDomain = "cloud";
 #pragma mark -
 
 
-ConfigManager::ConfigManager() : _activeDomain(nullptr) {
+ConfigManager::ConfigManager() : _activeDomain(nullptr), _flushPending(false) {
+	_parseMutex = new Mutex();
+	_flushMutex = new Mutex();
+}
+
+ConfigManager::~ConfigManager() {
+	waitForFlush();
+	delete _flushMutex;
+	delete _parseMutex;
 }
 
 void ConfigManager::defragment() {
@@ -73,7 +100,7 @@ void ConfigManager::copyFrom(ConfigManager &source) {
 #endif
 	_domainSaveOrder = source._domainSaveOrder;
 	_activeDomainName = source._activeDomainName;
-	_activeDomain = &_gameDomains[_activeDomainName];
+	_activeDomain = parseDomain(_gameDomains[_activeDomainName]);
 	_filename = source._filename;
 }
 
@@ -135,18 +162,23 @@ bool ConfigManager::loadFallbackConfigFile(const Path &filename) {
  * Add a ready-made domain based on its name and contents
  * The domain name should not already exist in the ConfigManager.
  **/
-void ConfigManager::addDomain(const String &domainName, const ConfigManager::Domain &domain) {
+void ConfigManager::addDomain(const String &domainName, const ConfigManager::Domain &domain, bool isGameDomain) {
 	if (domainName.empty())
 		return;
+	// The domains which are always there are read all the time, so they
+	// are parsed right away
 	if (domainName == kApplicationDomain) {
 		_appDomain = domain;
+		parseDomain(_appDomain);
 	} else if (domainName == kKeymapperDomain) {
 		_keymapperDomain = domain;
+		parseDomain(_keymapperDomain);
 #ifdef USE_CLOUD
 	} else if (domainName == kCloudDomain) {
 		_cloudDomain = domain;
+		parseDomain(_cloudDomain);
 #endif
-	} else if (domain.contains("gameid")) {
+	} else if (isGameDomain) {
 		// If the domain contains "gameid" we assume it's a game domain
 		if (_gameDomains.contains(domainName))
 			warning("Game domain %s already exists in ConfigManager", domainName.c_str());
@@ -175,6 +207,7 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 	String domainName;
 	String comment;
 	Domain domain;
+	bool isGameDomain = false;
 	int lineno = 0;
 
 	_appDomain.clear();
@@ -189,49 +222,76 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 	_cloudDomain.clear();
 #endif
 
+	// The file on disk may not match what was last written anymore
+	_lastFlush.clear();
+
 	// TODO: Detect if a domain occurs multiple times (or likewise, if
 	// a key occurs multiple times inside one domain).
 
-	while (!stream.eos() && !stream.err()) {
-		lineno++;
+	// Read the whole file at once. The lines of each domain are only
+	// checked here, and parsed from this buffer when the domain is first
+	// accessed, so loading a config file with many game targets does not
+	// have to build all of their entries.
+	const int64 size = stream.size() - stream.pos();
+	if (size <= 0)
+		return !stream.err();
+
+	char *buffer = new char[size];
+	const uint32 bytesRead = stream.read(buffer, size);
+	SharedPtr<char> source(buffer, ArrayDeleter<char>());
+	if (stream.err())
+		return false;
 
-		// Read a line
-		String line = stream.readLine();
+	const char *p = buffer;
+	const char *end = buffer + bytesRead;
+	const char *bodyStart = nullptr;
+	const char *bodyEnd = nullptr;
 
-		// Skip UTF-8 byte-order mark if added by a text editor.
-		if (lineno == 1 && memcmp(line.c_str(), UTF8_BOM, 3) == 0) {
-			line.erase(0, 3);
-		}
+	// Skip UTF-8 byte-order mark if added by a text editor.
+	if (end - p >= 3 && memcmp(p, UTF8_BOM, 3) == 0)
+		p += 3;
+
+	while (p < end) {
+		lineno++;
 
-		if (line.size() == 0) {
+		const char *lineEnd = findLineEnd(p, end);
+		const char *next = skipLineBreak(lineEnd, end);
+
+		if (p == lineEnd) {
 			// Do nothing
-		} else if (line[0] == '#') {
+		} else if (*p == '#') {
 			// Accumulate comments here. Once we encounter either the start
 			// of a new domain, or a key-value-pair, we associate the value
 			// of the 'comment' variable with that entity.
-			comment += line;
+			comment += String(p, lineEnd);
 			comment += "\n";
-		} else if (line[0] == '[') {
+		} else if (*p == '[') {
 			// It's a new domain which begins here.
 			// Determine where the previously accumulated domain goes, if we accumulated anything.
-			addDomain(domainName, domain);
-			domain.clear();
-			const char *p = line.c_str() + 1;
+			if (bodyEnd)
+				domain.setSource(source, bodyStart - buffer, bodyEnd - buffer);
+			addDomain(domainName, domain, isGameDomain);
+			domain = Domain();
+			isGameDomain = false;
+
 			// Get the domain name, and check whether it's valid (that
 			// is, verify that it only consists of alphanumerics,
 			// dashes and underscores).
-			while (*p && (isAlnum(*p) || *p == '-' || *p == '_'))
-				p++;
+			const char *q = p + 1;
+			while (q < lineEnd && (isAlnum(*q) || *q == '-' || *q == '_'))
+				q++;
 
-			if (*p == '\0') {
+			if (q == lineEnd) {
 				warning("Config file buggy: missing ] in line %d", lineno);
 				return false;
-			} else if (*p != ']') {
-				warning("Config file buggy: Invalid character '%c' occurred in section name in line %d", *p, lineno);
+			} else if (*q != ']') {
+				warning("Config file buggy: Invalid character '%c' occurred in section name in line %d", *q, lineno);
 				return false;
 			}
 
-			domainName = String(line.c_str() + 1, p);
+			domainName = String(p + 1, q);
+			bodyStart = next;
+			bodyEnd = nullptr;
 
 			domain.setDomainComment(comment);
 			comment.clear();
@@ -240,13 +300,15 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			// This line should be a line with a 'key=value' pair, or an empty one.
 
 			// Skip leading whitespaces
-			const char *t = line.c_str();
-			while (isSpace(*t))
+			const char *t = p;
+			while (t < lineEnd && isSpace(*t))
 				t++;
 
 			// Skip empty lines / lines with only whitespace
-			if (*t == 0)
+			if (t == lineEnd) {
+				p = next;
 				continue;
+			}
 
 			// If no domain has been set, this config file is invalid!
 			if (domainName.empty()) {
@@ -255,100 +317,187 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			}
 
 			// Split string at '=' into 'key' and 'value'. First, find the "=" delimeter.
-			const char *p = strchr(t, '=');
-			if (!p) {
-				warning("Config file buggy: Junk found in line %d: '%s'", lineno, t);
+			const char *q = (const char *)memchr(t, '=', lineEnd - t);
+			if (!q) {
+				warning("Config file buggy: Junk found in line %d: '%s'", lineno, String(t, lineEnd).c_str());
 				return false;
 			}
 
-			// Extract the key/value pair
-			String key(t, p);
-			String value(p + 1);
-
-			// Trim of spaces
-			key.trim();
-			value.trim();
+			// The key is left in the buffer, except for deciding whether
+			// this is a game domain.
+			const char *keyEnd = q;
+			while (keyEnd > t && isSpace(keyEnd[-1]))
+				keyEnd--;
+			if (keyEnd - t == 6 && !scumm_strnicmp(t, "gameid", 6))
+				isGameDomain = true;
 
-			// Finally, store the key/value pair in the active domain
-			domain.setVal(key, value);
-
-			// Store comment
-			domain.setKVComment(key, comment);
+			// Comments within the domain are parsed along with the keys
 			comment.clear();
+			bodyEnd = next;
 		}
+
+		p = next;
 	}
 
-	addDomain(domainName, domain); // Add the last domain found
+	// Add the last domain found
+	if (bodyEnd)
+		domain.setSource(source, bodyStart - buffer, bodyEnd - buffer);
+	addDomain(domainName, domain, isGameDomain);
 
 	return true;
 }
 
-void ConfigManager::flushToDisk() {
-#ifndef __DC__
-	WriteStream *stream;
-
-	if (_filename.empty()) {
-		// Write to the default config file
-		assert(g_system);
-		stream = g_system->createConfigWriteStream();
-		if (!stream)    // If writing to the config file is not possible, do nothing
-			return;
-	} else {
-		DumpFile *dump = new DumpFile();
-		assert(dump);
-
-		if (!dump->open(_filename)) {
-			warning("Unable to write configuration file: %s", _filename.toString(Common::Path::kNativeSeparator).c_str());
-			delete dump;
-			return;
-		}
-
-		stream = dump;
-	}
+bool ConfigManager::saveToStream(WriteStream &stream) {
+	// Domains which are not parsed yet are written as they were read, so
+	// keep them from being parsed meanwhile
+	StackLock lock(*_parseMutex);
 
 	// Write the application domain
-	writeDomain(*stream, kApplicationDomain, _appDomain);
+	writeDomain(stream, kApplicationDomain, _appDomain);
 
 	// Write the keymapper domain
-	writeDomain(*stream, kKeymapperDomain, _keymapperDomain);
+	writeDomain(stream, kKeymapperDomain, _keymapperDomain);
 #ifdef USE_CLOUD
 	// Write the cloud domain
-	writeDomain(*stream, kCloudDomain, _cloudDomain);
+	writeDomain(stream, kCloudDomain, _cloudDomain);
 #endif
 
 	// Write the miscellaneous domains next
 	for (const auto &misc : _miscDomains) {
-		writeDomain(*stream, misc._key, misc._value);
+		writeDomain(stream, misc._key, misc._value);
 	}
 
 	// First write the domains in _domainSaveOrder, in that order.
 	// Note: It's possible for _domainSaveOrder to list domains which
 	// are not present anymore, so we validate each name.
+	HashMap<String, bool> saved;
 	for (const auto &domain : _domainSaveOrder) {
+		saved.setVal(domain, true);
 		if (_gameDomains.contains(domain)) {
-			writeDomain(*stream, domain, _gameDomains[domain]);
+			writeDomain(stream, domain, _gameDomains[domain]);
 		}
 	}
 
 	// Now write the domains which haven't been written yet
 	for (auto &domain : _gameDomains) {
-		if (find(_domainSaveOrder.begin(), _domainSaveOrder.end(), domain._key) == _domainSaveOrder.end())
-			writeDomain(*stream, domain._key, domain._value);
+		if (!saved.contains(domain._key))
+			writeDomain(stream, domain._key, domain._value);
 	}
 
-	delete stream;
+	return !stream.err();
+}
+
+void ConfigManager::flushToDisk() {
+#ifndef __DC__
+	MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+	saveToStream(stream);
 
+	Array<byte> contents(stream.getData(), stream.size());
+
+	// Nothing changed since the last flush
+	if (!contents.empty() && contents == _lastFlush)
+		return;
+	_lastFlush = contents;
+
+	// Paths share their storage, so pass a copy which is not shared
+	// with anything to the timer
+	Array<char> filename;
+	if (!_filename.empty()) {
+		String native = _filename.toString(Common::Path::kNativeSeparator);
+		filename = Array<char>(native.c_str(), native.size() + 1);
+	}
+
+	if (!g_system || !g_system->backendInitialized()) {
+		writeConfigFile(contents, filename);
+		return;
+	}
+
+	StackLock lock(*_flushMutex);
+	_pendingFlush.swap(contents);
+	_pendingFlushFilename.swap(filename);
+	if (!_flushPending) {
+		_flushPending = true;
+		g_system->getTimerManager()->installTimerProc(&flushCallback, kFlushInterval, this, "ConfigManager");
+	}
 #endif // !__DC__
 }
 
+void ConfigManager::flushCallback(void *refCon) {
+	ConfigManager *manager = (ConfigManager *)refCon;
+	Array<byte> contents;
+	Array<char> filename;
+
+	{
+		StackLock lock(*manager->_flushMutex);
+		if (!manager->_flushPending)
+			return;
+		contents.swap(manager->_pendingFlush);
+		filename.swap(manager->_pendingFlushFilename);
+		manager->_flushPending = false;
+		g_system->getTimerManager()->removeTimerProc(&flushCallback);
+	}
+
+	writeConfigFile(contents, filename);
+}
+
+void ConfigManager::waitForFlush() {
+	// Wait for a write in progress, which is older than the pending one
+	if (g_system && g_system->backendInitialized())
+		g_system->getTimerManager()->removeTimerProc(&flushCallback);
+
+	Array<byte> contents;
+	Array<char> filename;
+
+	{
+		StackLock lock(*_flushMutex);
+		if (!_flushPending)
+			return;
+		contents.swap(_pendingFlush);
+		filename.swap(_pendingFlushFilename);
+		_flushPending = false;
+	}
+
+	writeConfigFile(contents, filename);
+}
+
+void ConfigManager::writeConfigFile(const Array<byte> &contents, const Array<char> &filename) {
+	WriteStream *stream;
+
+	if (filename.empty()) {
+		// Write to the default config file
+		assert(g_system);
+		stream = g_system->createConfigWriteStream();
+		if (!stream)    // If writing to the config file is not possible, do nothing
+			return;
+	} else {
+		DumpFile *dump = new DumpFile();
+		assert(dump);
+
+		if (!dump->open(Path(filename.begin(), Common::Path::kNativeSeparator))) {
+			warning("Unable to write configuration file: %s", filename.begin());
+			delete dump;
+			return;
+		}
+
+		stream = dump;
+	}
+
+	// The file is written to a temporary file first, and only replaces
+	// the config file once complete, see FSNode::createWriteStream()
+	stream->write(contents.begin(), contents.size());
+
+	delete stream;
+}
+
 void ConfigManager::writeDomain(WriteStream &stream, const String &name, const Domain &domain) {
 	if (domain.empty())
 		return; // Don't bother writing empty domains.
 
 	// WORKAROUND: Fix for bug #3746 "ALL: On-the-fly targets are
 	// written to the config file": Do not save domains that came from
-	// the command line
-	if (domain.contains("id_came_from_command_line"))
+	// the command line. These are never loaded from a file, so domains
+	// which still have their source are not parsed for checking this.
+	if (!domain._source && domain.contains("id_came_from_command_line"))
 		return;
 
 	String comment;
@@ -364,6 +513,18 @@ void ConfigManager::writeDomain(WriteStream &stream, const String &name, const D
 	stream.writeByte(']');
 	stream.writeByte('\n');
 
+	if (domain._source) {
+		// Write the lines of a domain which was not modified as they
+		// were read
+		const char *start = domain._source.get() + domain._sourceStart;
+		const uint32 size = domain._sourceEnd - domain._sourceStart;
+		stream.write(start, size);
+		if (start[size - 1] != '\n')
+			stream.writeByte('\n');
+		stream.writeByte('\n');
+		return;
+	}
+
 	// Write all key/value pairs in this domain, including comments
 	for (const auto &x : domain) {
 		if (!x._value.empty()) {
@@ -403,9 +564,9 @@ const ConfigManager::Domain *ConfigManager::getDomain(const String &domName) con
 		return &_cloudDomain;
 #endif
 	if (_gameDomains.contains(domName))
-		return &_gameDomains[domName];
+		return parseDomain(_gameDomains[domName]);
 	if (_miscDomains.contains(domName))
-		return &_miscDomains[domName];
+		return parseDomain(_miscDomains[domName]);
 
 	return nullptr;
 }
@@ -427,9 +588,9 @@ ConfigManager::Domain *ConfigManager::getDomain(const String &domName) {
 		return &_cloudDomain;
 #endif
 	if (_gameDomains.contains(domName))
-		return &_gameDomains[domName];
+		return parseDomain(_gameDomains[domName]);
 	if (_miscDomains.contains(domName))
-		return &_miscDomains[domName];
+		return parseDomain(_miscDomains[domName]);
 
 	return nullptr;
 }
@@ -713,7 +874,7 @@ void ConfigManager::setActiveDomain(const String &domName) {
 		_activeDomain = nullptr;
 	} else {
 		assert(isValidDomainName(domName));
-		_activeDomain = &_gameDomains[domName];
+		_activeDomain = parseDomain(_gameDomains[domName]);
 	}
 	_activeDomainName = domName;
 }
@@ -760,7 +921,7 @@ void ConfigManager::renameGameDomain(const String &oldName, const String &newNam
 	renameDomain(oldName, newName, _gameDomains);
 	if (_activeDomainName == oldName) {
 		_activeDomainName = newName;
-		_activeDomain = &_gameDomains[newName];
+		_activeDomain = parseDomain(_gameDomains[newName]);
 	}
 }
 
@@ -781,14 +942,39 @@ void ConfigManager::renameDomain(const String &oldName, const String &newName, D
 	assert(isValidDomainName(newName));
 
 //	_gameDomains[newName].merge(_gameDomains[oldName]);
-	Domain &oldDom = map[oldName];
-	Domain &newDom = map[newName];
+	Domain &oldDom = *parseDomain(map[oldName]);
+	Domain &newDom = *parseDomain(map[newName]);
 	for (const auto &dom : oldDom)
 		newDom.setVal(dom._key, dom._value);
 
 	map.erase(oldName);
 }
 
+const ConfigManager::DomainMap &ConfigManager::getGameDomains() const {
+	parseGameDomains();
+	return _gameDomains;
+}
+
+ConfigManager::DomainMap::iterator ConfigManager::beginGameDomains() {
+	parseGameDomains();
+	return _gameDomains.begin();
+}
+
+ConfigManager::Domain *ConfigManager::parseDomain(const Domain &domain) const {
+	// Parsing does not change the contents of the domain, and the lock
+	// keeps it from happening twice
+	StackLock lock(*_parseMutex);
+	Domain *parsed = const_cast<Domain *>(&domain);
+	if (parsed->_source && !parsed->_parsed)
+		parsed->parse();
+	return parsed;
+}
+
+void ConfigManager::parseGameDomains() const {
+	for (auto &domain : _gameDomains)
+		parseDomain(domain._value);
+}
+
 bool ConfigManager::hasGameDomain(const String &domName) const {
 	assert(!domName.empty());
 	return isValidDomainName(domName) && _gameDomains.contains(domName);
@@ -805,6 +991,52 @@ bool ConfigManager::isKeyTemporary(const String &key) const {
 
 #pragma mark -
 
+void ConfigManager::Domain::setSource(const SharedPtr<char> &source, uint32 start, uint32 end) {
+	_source = source;
+	_sourceStart = start;
+	_sourceEnd = end;
+	_parsed = false;
+}
+
+void ConfigManager::Domain::parse() {
+	_parsed = true;
+
+	// The lines were checked by loadFromStream()
+	const char *p = _source.get() + _sourceStart;
+	const char *end = _source.get() + _sourceEnd;
+	String comment;
+
+	while (p < end) {
+		const char *lineEnd = findLineEnd(p, end);
+
+		if (p == lineEnd) {
+			// Do nothing
+		} else if (*p == '#') {
+			comment += String(p, lineEnd);
+			comment += "\n";
+		} else {
+			const char *t = p;
+			while (t < lineEnd && isSpace(*t))
+				t++;
+
+			if (t < lineEnd) {
+				const char *q = (const char *)memchr(t, '=', lineEnd - t);
+
+				String key(t, q);
+				String value(q + 1, lineEnd);
+				key.trim();
+				value.trim();
+
+				_entries.setVal(key, value);
+				_keyValueComments.setVal(key, comment);
+				comment.clear();
+			}
+		}
+
+		p = skipLineBreak(lineEnd, end);
+	}
+}
+
 void ConfigManager::Domain::setDomainComment(const String &comment) {
 	_domainComment = comment;
 }
@@ -813,6 +1045,7 @@ const String &ConfigManager::Domain::getDomainComment() const {
 }
 
 void ConfigManager::Domain::setKVComment(const String &key, const String &comment) {
+	markDirty();
 	_keyValueComments[key] = comment;
 }
 const String &ConfigManager::Domain::getKVComment(const String &key) const {
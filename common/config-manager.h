@@ -25,6 +25,7 @@
 #include "common/array.h"
 #include "common/hashmap.h"
 #include "common/path.h"
+#include "common/ptr.h"
 #include "common/singleton.h"
 #include "common/str.h"
 #include "common/hash-str.h"
@@ -41,6 +42,7 @@ namespace Common {
  * @{
  */
 
+class Mutex;
 class WriteStream;
 class SeekableReadStream;
 
@@ -57,17 +59,45 @@ class ConfigManager : public Singleton<ConfigManager> {
 public:
 
 	class Domain {
+		friend class ConfigManager;
 	private:
 		StringMap _entries;
 		StringMap _keyValueComments;
 		String _domainComment;
 
+		/**
+		 * The lines of a game or misc domain loaded from a config file.
+		 * The ConfigManager parses them into the entries before it first
+		 * hands out the domain, see ConfigManager::parseDomain(). They are
+		 * kept until the domain is modified, so a domain that is only read
+		 * is written back as it was read.
+		 */
+		SharedPtr<char> _source;
+		uint32 _sourceStart;
+		uint32 _sourceEnd;
+		bool _parsed;
+
+		void setSource(const SharedPtr<char> &source, uint32 start, uint32 end);
+		void parse();
+
+		/** Drop the source lines before the entries change. */
+		void markDirty() {
+			if (_source) {
+				if (!_parsed)
+					parse();
+				_source.reset();
+			}
+		}
+
 	public:
+		Domain() : _sourceStart(0), _sourceEnd(0), _parsed(false) {}
+
 		typedef StringMap::const_iterator const_iterator;
 		const_iterator begin() const { return _entries.begin(); } /*!< Return the beginning position of configuration entries. */
 		const_iterator end()   const { return _entries.end(); }   /*!< Return the ending position of configuration entries. */
 
-		bool           empty() const { return _entries.empty(); } /*!< Return true if the configuration is empty, i.e. has no [key, value] pairs, and false otherwise. */
+		// The lines of a source always contain a key
+		bool           empty() const { return !_source && _entries.empty(); } /*!< Return true if the configuration is empty, i.e. has no [key, value] pairs, and false otherwise. */
 
 		bool           contains(const String &key) const { return _entries.contains(key); } /*!< Check whether the domain contains a @p key. */
 		/** Return the configuration value for the given key.
@@ -79,10 +109,10 @@ public:
 		 */
 		const String &operator[](const String &key) const { return _entries[key]; }
 
-		void           setVal(const String &key, const String &value) { _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
+		void           setVal(const String &key, const String &value) { markDirty(); _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
 
-		String &getOrCreateVal(const String &key) { return _entries.getOrCreateVal(key); }
-		String        &getVal(const String &key) { return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
+		String &getOrCreateVal(const String &key) { markDirty(); return _entries.getOrCreateVal(key); }
+		String        &getVal(const String &key) { markDirty(); return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
 		const String  &getVal(const String &key) const { return _entries.getVal(key); } /*!< @overload */
 		 /**
 		  * Retrieve the value of @p key if it exists and leave the referenced variable unchanged if the key does not exist.
@@ -92,9 +122,9 @@ public:
 		const String &getValOrDefault(const String &key) const { return _entries.getValOrDefault(key); }
 		bool tryGetVal(const String &key, String &out) const { return _entries.tryGetVal(key, out); }
 
-		void           clear() { _entries.clear(); } /*!< Clear all configuration entries in the domain. */
+		void           clear() { _source.reset(); _entries.clear(); } /*!< Clear all configuration entries in the domain. */
 
-		void           erase(const String &key) { _entries.erase(key); } /*!< Remove a key from the domain. */
+		void           erase(const String &key) { markDirty(); _entries.erase(key); } /*!< Remove a key from the domain. */
 
 		void           setDomainComment(const String &comment); /*!< Add a @p comment for this configuration domain. */
 		const String  &getDomainComment() const; /*!< Retrieve the comment of this configuration domain. */
@@ -200,7 +230,19 @@ public:
 	void                     registerDefault(const String &key, bool value); /*!< @overload */
 	void                     registerDefault(const String &key, const Path &value); /*!< @overload */
 
-	void                     flushToDisk(); /*!< Flush configuration to disk. */
+	/**
+	 * Flush configuration to disk.
+	 *
+	 * Once the backend is initialized, the file is written by a timer
+	 * shortly afterwards, so a flush does not wait for the file system.
+	 * Flushes which follow each other closely are written only once.
+	 */
+	void                     flushToDisk();
+
+	void                     waitForFlush(); /*!< Write a flush which is still waiting for the timer. */
+
+	bool                     loadFromStream(SeekableReadStream &stream); /*!< Load the configuration from a stream, replacing the current one. */
+	bool                     saveToStream(WriteStream &stream); /*!< Write the configuration to a stream. */
 
 	void                     setActiveDomain(const String &domName); /*!< Set the given domain as active. */
 	Domain                  *getActiveDomain() { return _activeDomain; } /*!< Get the active domain. */
@@ -220,8 +262,8 @@ public:
 
 	bool                     isKeyTemporary(const String &key) const; /*!< Check if a specific key exists in either transient or session domain. */
 
-	const DomainMap         &getGameDomains() const { return _gameDomains; } /*!< Return all game domains in the DomainMap. */
-	DomainMap::iterator      beginGameDomains() { return _gameDomains.begin(); } /*!< Return the beginning position of game domains. */
+	const DomainMap         &getGameDomains() const; /*!< Return all game domains in the DomainMap. */
+	DomainMap::iterator      beginGameDomains(); /*!< Return the beginning position of game domains. */
 	DomainMap::iterator      endGameDomains() { return _gameDomains.end(); } /*!< Return the ending position of game domains. */
 
 	const Path              &getCustomConfigFileName() { return _filename; } /*!< Return the custom config file being used, or an empty string when using the default config file */
@@ -232,13 +274,28 @@ public:
 private:
 	friend class Singleton<SingletonBaseType>;
 	ConfigManager();
+	~ConfigManager();
+
+	enum {
+		kFlushInterval = 100 * 1000 // in microseconds
+	};
 
 	bool			loadFallbackConfigFile(const Path &filename);
-	bool			loadFromStream(SeekableReadStream &stream);
-	void			addDomain(const String &domainName, const Domain &domain);
+	void			addDomain(const String &domainName, const Domain &domain, bool isGameDomain);
 	void			writeDomain(WriteStream &stream, const String &name, const Domain &domain);
 	void			renameDomain(const String &oldName, const String &newName, DomainMap &map);
 
+	/**
+	 * Parse a domain loaded from the config file, before it is handed out.
+	 * Domains can be read from other threads, such as timers, so this
+	 * happens under a lock.
+	 */
+	Domain			*parseDomain(const Domain &domain) const;
+	void			parseGameDomains() const;
+
+	static void		flushCallback(void *refCon);
+	static void		writeConfigFile(const Array<byte> &contents, const Array<char> &filename);
+
 	Domain			_transientDomain;
 	DomainMap		_gameDomains;
 	DomainMap		_miscDomains; // Any other domains
@@ -259,6 +316,18 @@ private:
 	Domain *		_activeDomain;
 
 	Path			_filename;
+
+	// Written from the GUI thread only
+	Array<byte>		_lastFlush;
+
+	// Guards parsing domains, see parseDomain()
+	Mutex *			_parseMutex;
+
+	// Guard the flush waiting for the timer, see flushToDisk()
+	Mutex *			_flushMutex;
+	bool			_flushPending;
+	Array<byte>		_pendingFlush;
+	Array<char>		_pendingFlushFilename;
 };
 
 /** @} */
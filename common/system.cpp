@@ -22,6 +22,7 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_exit
 
 #include "common/system.h"
+#include "common/config-manager.h"
 #include "common/events.h"
 #include "common/fs.h"
 #include "common/file.h"
@@ -121,6 +122,10 @@ void OSystem::initBackend() {
 }
 
 void OSystem::destroy() {
+	// The timer which writes the config file is about to go away
+	if (Common::ConfigManager::hasInstance())
+		ConfMan.waitForFlush();
+
 	_backendInitialized = false;
 	Common::String::releaseMemoryPoolMutex();
 	Common::releaseCJKTables();
@@ -25,6 +25,7 @@
 #include "ags/shared/ac/sprite_cache.h"
 #include "ags/shared/gfx/allegro_bitmap.h"
 #include "ags/shared/script/cc_common.h"
+#include "ags/engine/script/cc_instance.h"
 #include "image/png.h"
 
 namespace AGS {
@@ -33,8 +34,10 @@ AGSConsole::AGSConsole(AGSEngine *vm) : GUI::Debugger(), _vm(vm), _logOutputTarg
 	registerCmd("ags_debug_groups_list",   WRAP_METHOD(AGSConsole, Cmd_listDebugGroups));
 	registerCmd("ags_debug_groups_set",  WRAP_METHOD(AGSConsole, Cmd_setDebugGroupLevel));
 	registerCmd("ags_set_script_dump", WRAP_METHOD(AGSConsole, Cmd_SetScriptDump));
+	registerCmd("ags_script_stats", WRAP_METHOD(AGSConsole, Cmd_scriptStats));
 	registerCmd("ags_sprite_info",   WRAP_METHOD(AGSConsole, Cmd_getSpriteInfo));
 	registerCmd("ags_sprite_dump",  WRAP_METHOD(AGSConsole, Cmd_dumpSprite));
+	registerCmd("ags_sprite_cache_stats", WRAP_METHOD(AGSConsole, Cmd_spriteCacheStats));
 
 	_logOutputTarget = new LogOutputTarget();
 	_agsDebuggerOutput = _GP(DbgMgr).RegisterOutput("ScummVMLog", _logOutputTarget, AGS3::AGS::Shared::kDbgMsg_None);
@@ -184,6 +187,24 @@ bool AGSConsole::Cmd_SetScriptDump(int argc, const char **argv) {
 	return true;
 }
 
+bool AGSConsole::Cmd_scriptStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset") != 0)) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		AGS3::ccInstance::ResetExecStats();
+		debugPrintf("Script execution counters reset\n");
+		return true;
+	}
+
+	const AGS3::ScriptExecStats &stats = AGS3::ccInstance::GetExecStats();
+	debugPrintf("Script calls:    %u\n", stats.Calls);
+	debugPrintf("Time in scripts: %u ms (longest call %u ms)\n", stats.TimeMs, stats.MaxCallTimeMs);
+	return true;
+}
+
 bool AGSConsole::Cmd_getSpriteInfo(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Usage: %s SpriteNumber\n", argv[0]);
@@ -244,6 +265,29 @@ bool AGSConsole::Cmd_dumpSprite(int argc, const char **argv) {
 	return true;
 }
 
+bool AGSConsole::Cmd_spriteCacheStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset") != 0)) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		_GP(spriteset).ResetStatistics();
+		debugPrintf("Sprite cache counters reset\n");
+		return true;
+	}
+
+	const AGS3::Shared::SpriteCache::Statistics &stats = _GP(spriteset).GetStatistics();
+	debugPrintf("Cache size:     %u / %u KB (%u KB locked)\n",
+		(uint)(_GP(spriteset).GetCacheSize() / 1024), (uint)(_GP(spriteset).GetMaxCacheSize() / 1024),
+		(uint)(_GP(spriteset).GetLockedSize() / 1024));
+	debugPrintf("Hits / misses:  %u / %u\n", stats.Hits, stats.Misses);
+	debugPrintf("Sprites loaded: %u (%u prefetched, %u queued)\n", stats.Loads, stats.Prefetched,
+		(uint)_GP(spriteset).GetPrefetchQueueSize());
+	debugPrintf("Load time:      %u ms (longest %u ms)\n", stats.LoadTimeMs, stats.MaxLoadTimeMs);
+	return true;
+}
+
 LogOutputTarget::LogOutputTarget() {
 }
 
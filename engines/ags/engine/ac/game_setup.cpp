@@ -40,6 +40,7 @@ GameSetup::GameSetup() {
 	mouse_speed_def = kMouseSpeed_CurrentDisplay;
 	RenderAtScreenRes = false;
 	clear_cache_on_room_change = false;
+	sprite_prefetch = true;
 	load_latest_save = false;
 	rotation = kScreenRotation_Unlocked;
 	show_fps = false;
@@ -93,6 +93,7 @@ struct GameSetup {
 	size_t SpriteCacheSize = DefSpriteCacheSize;  // in KB
 	size_t TextureCacheSize = DefTexCacheSize;  // in KB
 	bool  clear_cache_on_room_change; // for low-end devices: clear resource caches on room change
+	bool  sprite_prefetch; // load sprites used in the new room during the idle frame time
 	bool  load_latest_save; // load latest saved game on launch
 	ScreenRotation rotation;
 	bool  show_fps;
@@ -29,6 +29,7 @@
 #include "ags/engine/ac/game.h"
 #include "ags/engine/ac/game_setup.h"
 #include "ags/shared/ac/game_setup_struct.h"
+#include "ags/shared/ac/view.h"
 #include "ags/engine/ac/game_state.h"
 #include "ags/engine/ac/global_audio.h"
 #include "ags/engine/ac/global_character.h"
@@ -414,6 +415,35 @@ static void reset_temp_room() {
 	_GP(troom) = RoomStatus();
 }
 
+// Schedules the sprites of the room objects and characters for loading
+// during the spare frame time, so that they don't stall the first frames
+static void queue_room_sprites() {
+	_GP(spriteset).ClearPrefetchQueue();
+	if (!_GP(usetup).sprite_prefetch)
+		return;
+
+	for (size_t i = 0; i < _G(croom)->numobj; ++i) {
+		const RoomObject &obj = _G(croom)->obj[i];
+		_GP(spriteset).QueuePrefetch(obj.num);
+		if ((obj.view == RoomObject::NoView) || (obj.view >= _GP(game).numviews) ||
+			(obj.loop >= _GP(views)[obj.view].numLoops))
+			continue;
+		const ViewLoopNew &loop = _GP(views)[obj.view].loops[obj.loop];
+		for (int f = 0; f < loop.numFrames; ++f)
+			_GP(spriteset).QueuePrefetch(loop.frames[f].pic);
+	}
+	for (int i = 0; i < _GP(game).numcharacters; ++i) {
+		const CharacterInfo &chi = _GP(game).chars[i];
+		if ((chi.room != _G(displayed_room)) || (chi.view < 0) || (chi.view >= _GP(game).numviews))
+			continue;
+		const ViewStruct &view = _GP(views)[chi.view];
+		for (int l = 0; l < view.numLoops; ++l) {
+			for (int f = 0; f < view.loops[l].numFrames; ++f)
+				_GP(spriteset).QueuePrefetch(view.loops[l].frames[f].pic);
+		}
+	}
+}
+
 // forchar = playerchar on NewRoom, or NULL if restore saved game
 void load_new_room(int newnum, CharacterInfo *forchar) {
 
@@ -865,6 +895,7 @@ void load_new_room(int newnum, CharacterInfo *forchar) {
 	update_polled_stuff();
 	debug_script_log("Now in room %d", _G(displayed_room));
 	GUI::MarkAllGUIForUpdate(true, true);
+	queue_room_sprites();
 	pl_run_plugin_hooks(AGSE_ENTERROOM, _G(displayed_room));
 }
 
@@ -22,6 +22,7 @@
 #include "common/std/thread.h"
 #include "ags/engine/ac/timer.h"
 #include "ags/shared/core/platform.h"
+#include "ags/shared/ac/sprite_cache.h"
 #include "ags/engine/ac/sys_events.h"
 #include "ags/engine/platform/base/ags_platform_driver.h"
 #include "ags/ags.h"
@@ -80,8 +81,15 @@ void WaitForNextFrame() {
 	}
 
 	if (_G(next_frame_timestamp) > now) {
-		auto frame_time_remaining = _G(next_frame_timestamp) - now;
-		std::this_thread::sleep_for(frame_time_remaining);
+		// use the spare frame time to load sprites scheduled for prefetching
+		if (_GP(spriteset).GetPrefetchQueueSize() > 0) {
+			const int64_t spare_ms = ToMilliseconds(_G(next_frame_timestamp) - now);
+			if (spare_ms > 1)
+				_GP(spriteset).ProcessPrefetchQueue(static_cast<uint32_t>(spare_ms - 1));
+		}
+		const auto after_prefetch = AGS_Clock::now();
+		if (_G(next_frame_timestamp) > after_prefetch)
+			std::this_thread::sleep_for(_G(next_frame_timestamp) - after_prefetch);
 	}
 
 	_G(last_tick_time) = _G(next_frame_timestamp);
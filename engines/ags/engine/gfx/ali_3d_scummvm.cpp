@@ -121,6 +121,7 @@ bool ScummVMRendererGraphicsDriver::SetDisplayMode(const DisplayMode &mode) {
 	const int driver = GFX_SCUMMVM;
 	if (set_gfx_mode(driver, mode.Width, mode.Height, mode.ColorDepth) != 0)
 		return false;
+	InvalidatePresentedFrame();
 
 	if (g_system->hasFeature(OSystem::kFeatureVSync)) {
 		g_system->beginGFXTransaction();
@@ -195,6 +196,7 @@ void ScummVMRendererGraphicsDriver::UnInit() {
 	OnUnInit();
 	ReleaseDisplayMode();
 	DestroyVirtualScreen();
+	InvalidatePresentedFrame();
 
 	sys_window_destroy();
 }
@@ -455,8 +457,46 @@ void ScummVMRendererGraphicsDriver::RenderToBackBuffer() {
 	ClearDrawLists();
 }
 
+void ScummVMRendererGraphicsDriver::FindOccludedSprites(size_t from, size_t to, const Bitmap *surface) {
+	_spriteOccluded.resize(to - from);
+	// Only a few nearest opaque sprites are tested against, which is enough
+	// to catch the common case of a large opaque GUI or a fullscreen image
+	const size_t max_occluders = 4;
+	Rect occluders[max_occluders];
+	size_t num_occluders = 0;
+	for (size_t i = to; i-- > from;) {
+		const auto &sprite = _spriteList[i];
+		_spriteOccluded[i - from] = false;
+		if (sprite.ddb == nullptr) {
+			// sprite event callbacks may read or modify the whole surface
+			num_occluders = 0;
+			continue;
+		}
+		if ((sprite.ddb == reinterpret_cast<ALSoftwareBitmap *>(DRAWENTRY_TINT)) || (sprite.ddb->_bmp == nullptr))
+			continue;
+
+		const ALSoftwareBitmap *bitmap = sprite.ddb;
+		const Rect rc = RectWH(sprite.x, sprite.y, bitmap->_bmp->GetWidth(), bitmap->_bmp->GetHeight());
+		for (size_t j = 0; j < num_occluders; ++j) {
+			if (IsRectInsideRect(occluders[j], rc)) {
+				_spriteOccluded[i - from] = true;
+				break;
+			}
+		}
+		// an opaque sprite with full alpha is blitted as a plain copy
+		if (!_spriteOccluded[i - from] && (num_occluders < max_occluders) &&
+			bitmap->_opaque && (bitmap->_alpha == 255) && (bitmap->_bmp != surface))
+			occluders[num_occluders++] = rc;
+	}
+}
+
 size_t ScummVMRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch, size_t from, Bitmap *surface, int surf_offx, int surf_offy) {
-	for (; (from < _spriteList.size()) && (_spriteList[from].node == batch.ID); ++from) {
+	const size_t first = from;
+	size_t to = from;
+	for (; (to < _spriteList.size()) && (_spriteList[to].node == batch.ID); ++to) {}
+	FindOccludedSprites(first, to, surface);
+
+	for (; from < to; ++from) {
 		const auto &sprite = _spriteList[from];
 		if (sprite.ddb == nullptr) {
 			if (_spriteEvtCallback)
@@ -473,6 +513,9 @@ size_t ScummVMRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &bat
 			continue;
 		}
 
+		if (_spriteOccluded[from - first])
+			continue; // will be completely overdrawn by a later sprite
+
 		ALSoftwareBitmap *bitmap = sprite.ddb;
 		int drawAtX = sprite.x + surf_offx;
 		int drawAtY = sprite.y + surf_offy;
@@ -583,34 +626,43 @@ void ScummVMRendererGraphicsDriver::Present(int xoff, int yoff, Shared::GraphicF
 		renderMode = kRenderOther;
 	}
 
-	if (renderMode != kRenderDirect && !_screen)
+	if (renderMode != kRenderDirect && !_screen) {
 		_screen = new Graphics::Screen();
+		InvalidatePresentedFrame();
+	}
 
 	switch (renderMode) {
 	case kRenderToABGR:
-		// ARGB to ABGR
+		// ARGB to ABGR; this compares the pixels against the screen by itself
+		InvalidatePresentedFrame();
 		copySurface(src, false);
 		break;
 
 	case kRenderToRGBA:
 		// ARGB to RGBA
+		InvalidatePresentedFrame();
 		copySurface(src, true);
 		break;
 
 	case kRenderOther: {
-		// Blit the surface to the temporary screen, ignoring the alphas.
-		// This takes care of converting to the screen format
+		// Blit the changed parts of the surface to the temporary screen,
+		// ignoring the alphas. This takes care of converting to the screen format
 		Graphics::Surface srcCopy = src;
 		srcCopy.format.aLoss = 8;
 
-		_screen->blitFrom(srcCopy);
+		FindChangedRegions(src);
+		for (const auto &rc : _changedRects)
+			_screen->blitFrom(srcCopy, rc, Common::Point(rc.left, rc.top));
 		break;
 	}
 
 	case kRenderDirect:
-		// Blit the virtual surface directly to the screen
-		g_system->copyRectToScreen(src.getPixels(), src.pitch,
-			0, 0, src.w, src.h);
+		// Blit the changed parts of the virtual surface directly to the screen
+		FindChangedRegions(src);
+		for (const auto &rc : _changedRects) {
+			g_system->copyRectToScreen(src.getBasePtr(rc.left, rc.top), src.pitch,
+				rc.left, rc.top, rc.width(), rc.height());
+		}
 		g_system->updateScreen();
 		if (srcTransformed) {
 			srcTransformed->free();
@@ -631,6 +683,60 @@ void ScummVMRendererGraphicsDriver::Present(int xoff, int yoff, Shared::GraphicF
 		_screen->update();
 }
 
+void ScummVMRendererGraphicsDriver::FindChangedRegions(const Graphics::Surface &src) {
+	_changedRects.clear();
+	if ((_lastFrame.w != src.w) || (_lastFrame.h != src.h) || (_lastFrame.format != src.format)) {
+		_lastFrame.free();
+		_lastFrame.copyFrom(src);
+		_changedRects.push_back(Common::Rect(src.w, src.h));
+		return;
+	}
+
+	// Scan the rows, merging consecutive changed rows into a single region
+	const int bpp = src.format.bytesPerPixel;
+	const size_t row_size = src.w * bpp;
+	Common::Rect region;
+	bool in_region = false;
+	for (int y = 0; y < src.h; ++y) {
+		const byte *src_row = (const byte *)src.getBasePtr(0, y);
+		byte *last_row = (byte *)_lastFrame.getBasePtr(0, y);
+		if (memcmp(src_row, last_row, row_size) == 0) {
+			if (in_region)
+				_changedRects.push_back(region);
+			in_region = false;
+			continue;
+		}
+
+		size_t first = 0, last = row_size - 1;
+		while (src_row[first] == last_row[first])
+			++first;
+		while (src_row[last] == last_row[last])
+			--last;
+		const int x1 = first / bpp;
+		const int x2 = last / bpp + 1;
+		memcpy(last_row + x1 * bpp, src_row + x1 * bpp, (x2 - x1) * bpp);
+
+		if (in_region) {
+			region.left = MIN<int16>(region.left, x1);
+			region.right = MAX<int16>(region.right, x2);
+			region.bottom = y + 1;
+		} else {
+			region = Common::Rect(x1, y, x2, y + 1);
+			in_region = true;
+		}
+	}
+	if (in_region)
+		_changedRects.push_back(region);
+}
+
+void ScummVMRendererGraphicsDriver::InvalidatePresentedFrame() {
+	_lastFrame.free();
+	_changedRects.clear();
+	// The conversions compare against the intermediate screen instead
+	if (_screen)
+		_screen->makeAllDirty();
+}
+
 void ScummVMRendererGraphicsDriver::Render(int xoff, int yoff, GraphicFlip flip) {
 	RenderToBackBuffer();
 	Present(xoff, yoff, flip);
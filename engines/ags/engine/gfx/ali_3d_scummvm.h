@@ -34,8 +34,10 @@
 #ifndef AGS_ENGINE_GFX_ALI_3D_SCUMMVM_H
 #define AGS_ENGINE_GFX_ALI_3D_SCUMMVM_H
 
+#include "common/rect.h"
 #include "common/std/memory.h"
 #include "common/std/vector.h"
+#include "graphics/surface.h"
 #include "ags/shared/core/platform.h"
 #include "ags/shared/gfx/bitmap.h"
 #include "ags/engine/gfx/ddb.h"
@@ -236,6 +238,8 @@ public:
 	bool GetStageMatrixes(RenderMatrixes & /*rm*/) override {
 		return false; /* not supported */
 	}
+	// Forgets the last presented frame, so that the next one is sent in whole
+	void InvalidatePresentedFrame() override;
 
 	typedef std::shared_ptr<ScummVMRendererGfxFilter> PSDLRenderFilter;
 
@@ -282,6 +286,14 @@ private:
 	ALSpriteBatches _spriteBatches;
 	// List of sprites to render
 	std::vector<ALDrawListEntry> _spriteList;
+	// Flags for the sprites of the batch being rendered, telling which ones
+	// are completely covered by the later opaque sprites and may be skipped
+	std::vector<bool> _spriteOccluded;
+
+	// Copy of the last frame sent to the system screen
+	Graphics::Surface _lastFrame;
+	// Regions of the current frame which differ from the last presented one
+	std::vector<Common::Rect> _changedRects;
 
 	void InitSpriteBatch(size_t index, const SpriteBatchDesc &desc) override;
 	void ResetAllBatches() override;
@@ -293,6 +305,9 @@ private:
 	void ReleaseDisplayMode();
 	// Renders single sprite batch on the precreated surface
 	size_t RenderSpriteBatch(const ALSpriteBatch &batch, size_t from, Shared::Bitmap *surface, int surf_offx, int surf_offy);
+	// Marks the sprites in the [from, to) range of the draw list, which are
+	// going to be completely overdrawn by a later opaque sprite
+	void FindOccludedSprites(size_t from, size_t to, const Shared::Bitmap *surface);
 
 	void highcolor_fade_in(Bitmap *vs, void(*draw_callback)(), int speed, int targetColourRed, int targetColourGreen, int targetColourBlue);
 	void highcolor_fade_out(Bitmap *vs, void(*draw_callback)(), int speed, int targetColourRed, int targetColourGreen, int targetColourBlue);
@@ -302,6 +317,9 @@ private:
 	void copySurface(const Graphics::Surface &src, bool mode);
 	// Render bitmap on screen
 	void Present(int xoff = 0, int yoff = 0, Shared::GraphicFlip flip = Shared::kFlip_None);
+	// Compares the frame with the last presented one, fills the list of
+	// changed regions and updates the stored copy
+	void FindChangedRegions(const Graphics::Surface &src);
 };
 
 
@@ -254,6 +254,9 @@ public:
 	// These matrixes will be filled in accordance to the renderer's compatible format;
 	// returns false if renderer does not use matrixes (not a 3D renderer).
 	virtual bool GetStageMatrixes(RenderMatrixes &rm) = 0;
+	// Tells the renderer that something else has drawn on the screen, such as
+	// a video, so that the next frame is presented in whole.
+	virtual void InvalidatePresentedFrame() = 0;
 
 	virtual ~IGraphicsDriver() {}
 };
@@ -362,7 +362,14 @@ void apply_config(const ConfigTree &cfg) {
 
 		// Resource caches and options
 		_GP(usetup).clear_cache_on_room_change = CfgReadBoolInt(cfg, "misc", "clear_cache_on_room_change", _GP(usetup).clear_cache_on_room_change);
-		_GP(usetup).SpriteCacheSize = CfgReadInt(cfg, "graphics", "sprite_cache_size", _GP(usetup).SpriteCacheSize);
+		if (ConfMan.hasKey("sprite_cache_size"))
+			_GP(usetup).SpriteCacheSize = ConfMan.getInt("sprite_cache_size");
+		else
+			_GP(usetup).SpriteCacheSize = CfgReadInt(cfg, "graphics", "sprite_cache_size", _GP(usetup).SpriteCacheSize);
+		if (ConfMan.hasKey("sprite_prefetch"))
+			_GP(usetup).sprite_prefetch = ConfMan.getBool("sprite_prefetch");
+		else
+			_GP(usetup).sprite_prefetch = CfgReadBoolInt(cfg, "graphics", "sprite_prefetch", _GP(usetup).sprite_prefetch);
 		_GP(usetup).TextureCacheSize = CfgReadInt(cfg, "graphics", "texture_cache_size", _GP(usetup).TextureCacheSize);
 
 		// Mouse options
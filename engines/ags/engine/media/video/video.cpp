@@ -110,6 +110,8 @@ static bool play_video(Video::VideoDecoder *decoder, const char *name, int flags
 			}
 
 			scr.update();
+			// The frame was drawn past the renderer
+			_G(gfxDriver)->InvalidatePresentedFrame();
 		}
 
 		g_system->delayMillis(10);
@@ -20,6 +20,7 @@
  */
 
 #include "common/debug-channels.h"
+#include "common/system.h"
 #include "ags/shared/ac/common.h"
 #include "ags/engine/ac/dynobj/cc_dynamic_array.h"
 #include "ags/engine/ac/dynobj/managed_object_pool.h"
@@ -157,6 +158,7 @@ struct ScriptCommands {
 	}
 };
 static ScriptCommands *g_commands;
+static ScriptExecStats g_execStats;
 
 void script_commands_init() {
 	g_commands = new ScriptCommands();
@@ -230,6 +232,14 @@ void ccInstance::SetExecTimeout(const unsigned sys_poll_ms, const unsigned abort
 	_G(maxWhileLoops) = abort_loops;
 }
 
+const ScriptExecStats &ccInstance::GetExecStats() {
+	return g_execStats;
+}
+
+void ccInstance::ResetExecStats() {
+	g_execStats = ScriptExecStats();
+}
+
 ccInstance::ccInstance() {
 	flags               = 0;
 	globaldata          = nullptr;
@@ -253,6 +263,7 @@ ccInstance::ccInstance() {
 	numimports = 0;
 	resolved_imports = nullptr;
 	code_fixups         = nullptr;
+	code_ops            = nullptr;
 
 	memset(callStackLineNumber, 0, sizeof(callStackLineNumber));
 	memset(callStackAddr, 0, sizeof(callStackAddr));
@@ -430,9 +441,20 @@ int ccInstance::CallScriptFunction(const char *funcname, int32_t numargs, const
 	// Push placeholder for the return value (it will be popped before ret)
 	PushValueToStack(RuntimeScriptValue().SetInt32(0));
 
+	// Only time the outermost calls, nested ones are already accounted for
+	const bool is_toplevel = _GP(InstThreads).size() == 0;
+	const uint32 start_ms = is_toplevel ? g_system->getMillis() : 0;
+
 	_GP(InstThreads).push_back(this); // push instance thread
 	runningInst = this;
 	const int reterr = Run(startat);
+
+	if (is_toplevel) {
+		const uint32 call_ms = g_system->getMillis() - start_ms;
+		g_execStats.Calls++;
+		g_execStats.TimeMs += call_ms;
+		g_execStats.MaxCallTimeMs = MAX(g_execStats.MaxCallTimeMs, call_ms);
+	}
 	// Cleanup before returning, even if error
 	ASSERT_STACK_SIZE(numargs);
 	PopValuesFromStack(numargs);
@@ -583,14 +605,14 @@ int ccInstance::Run(int32_t curpc) {
 		//
 		/* Read operation */
 		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-		CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
-							"invalid instruction %d found in code stream", codeOp.Instruction.Code);
+		// The instruction word was unpacked when the script was loaded
+		const ScriptCodeOp &preOp       = codeInst->code_ops[pc];
+		codeOp.Instruction.Code         = preOp.Code;
+		codeOp.Instruction.InstanceId   = preOp.InstanceId;
+		codeOp.ArgCount                 = preOp.ArgCount;
 
-		codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
+		CC_ERROR_IF_RETCODE(codeOp.Instruction.Code >= CC_NUM_SCCMDS,
+							"invalid instruction %d found in code stream", static_cast<int>(codeInst->code[pc] & INSTANCE_ID_REMOVEMASK));
 
 		CC_ERROR_IF_RETCODE(pc + codeOp.ArgCount >= codeInst->codesize,
 							"unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
@@ -1651,6 +1673,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		code_ops = joined->code_ops;
 	} else {
 		if (!CreateGlobalVars(scri.get())) {
 			return false;
@@ -1658,6 +1681,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 		if (!CreateRuntimeCodeFixups(scri.get())) {
 			return false;
 		}
+		PreDecodeCode();
 	}
 
 	exports = new RuntimeScriptValue[scri->numexports];
@@ -1737,9 +1761,11 @@ void ccInstance::Free() {
 	if ((flags & INSTF_SHAREDATA) == 0) {
 		delete[] resolved_imports;
 		delete[] code_fixups;
+		delete[] code_ops;
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	code_ops = nullptr;
 }
 
 bool ccInstance::ResolveScriptImports(const ccScript *scri) {
@@ -1945,14 +1971,39 @@ bool ccInstance::ResolveImportFixups(const ccScript *scri) {
 			return false;
 		}
 		code[fixup] = import_index;
+		DecodeCodeOp(fixup);
 		// If the call is to another script function next CALLEXT
 		// must be replaced with CALLAS
-		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
+		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT) {
 			code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->loadedInstanceId << INSTANCE_ID_SHIFT);
+			DecodeCodeOp(fixup + 1);
+		}
 	}
 	return true;
 }
 
+void ccInstance::PreDecodeCode() {
+	code_ops = new ScriptCodeOp[codesize];
+	for (int32_t i = 0; i < codesize; ++i)
+		DecodeCodeOp(i);
+}
+
+void ccInstance::DecodeCodeOp(int32_t at_pc) {
+	// Every position is decoded as if it was an instruction, since that is
+	// what the executor would do if it ever ended up there
+	ScriptCodeOp &op = code_ops[at_pc];
+	const intptr_t instr = code[at_pc] & INSTANCE_ID_REMOVEMASK;
+	if (instr < 0 || instr >= CC_NUM_SCCMDS) {
+		op.Code = CC_NUM_SCCMDS;
+		op.InstanceId = 0;
+		op.ArgCount = 0;
+		return;
+	}
+	op.Code = static_cast<uint8_t>(instr);
+	op.InstanceId = static_cast<uint8_t>((code[at_pc] >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK);
+	op.ArgCount = static_cast<uint8_t>((*g_commands)[op.Code].ArgCount);
+}
+
 void ccInstance::PushValueToStack(const RuntimeScriptValue &rval) {
 	// Write value to the stack tail and advance stack ptr
 	registers[SREG_SP].WriteValue(rval);
@@ -67,6 +67,23 @@ struct ScriptInstruction {
 	int32_t InstanceId = 0;
 };
 
+// Pre-decoded bytecode position: the instruction code with its instance id
+// split off, and the number of arguments following it. These are prepared
+// once when the script is loaded, so that the executor does not have to
+// unpack each instruction word over again.
+struct ScriptCodeOp {
+	uint8_t Code = 0;       // pure instruction code, CC_NUM_SCCMDS if invalid
+	uint8_t InstanceId = 0;
+	uint8_t ArgCount = 0;
+};
+
+// Script execution counters, for measuring the scripts' cost
+struct ScriptExecStats {
+	uint32_t Calls = 0;          // top-level script function calls
+	uint32_t TimeMs = 0;         // time spent in top-level calls
+	uint32_t MaxCallTimeMs = 0;  // longest top-level call
+};
+
 struct ScriptOperation {
 	ScriptInstruction   Instruction;
 	RuntimeScriptValue  Args[MAX_SCMD_ARGS];
@@ -154,6 +171,8 @@ public:
 	int  numimports;
 
 	char *code_fixups;
+	// pre-decoded instructions, one per code position
+	ScriptCodeOp *code_ops;
 
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
@@ -165,6 +184,9 @@ public:
 	static std::unique_ptr<ccInstance> CreateFromScript(PScript script);
 	static std::unique_ptr<ccInstance> CreateEx(PScript scri, const ccInstance *joined);
 	static void SetExecTimeout(unsigned sys_poll_ms, unsigned abort_ms, unsigned abort_loops);
+	// get or reset the script execution counters
+	static const ScriptExecStats &GetExecStats();
+	static void ResetExecStats();
 
 	ccInstance();
 	~ccInstance();
@@ -208,6 +230,9 @@ private:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(const ccScript *scri);
+	// Pre-decode the instructions of the whole bytecode, or at a single position
+	void    PreDecodeCode();
+	void    DecodeCodeOp(int32_t at_pc);
 
 	// Begin executing script starting from the given bytecode index
 	int     Run(int32_t curpc);
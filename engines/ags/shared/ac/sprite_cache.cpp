@@ -104,6 +104,7 @@ void SpriteCache::Reset() {
 	_file.Close();
 	_spriteData.clear();
 	_mru.clear();
+	ClearPrefetchQueue();
 	_cacheSize = 0;
 	_lockedSize = 0;
 }
@@ -227,11 +228,13 @@ Bitmap *SpriteCache::operator[](sprkey_t index) {
 		return _spriteData[index].Image.get();
 	// Either use ready image, or load one from assets
 	if (_spriteData[index].Image) {
+		_stats.Hits++;
 		// Move to the beginning of the MRU list
 		_mru.splice(_mru.begin(), _mru, _spriteData[index].MruIt);
 		return _spriteData[index].Image.get();
 	} else {
 		// Sprite exists in file but is not in mem, load it and add to MRU list
+		_stats.Misses++;
 		if (LoadSprite(index)) {
 			_spriteData[index].MruIt = _mru.insert(_mru.begin(), index);
 			return _spriteData[index].Image.get();
@@ -358,12 +361,58 @@ void SpriteCache::UnlockSprite(sprkey_t index) {
 	SprCacheLog("Unlocked %d", index);
 }
 
+void SpriteCache::QueuePrefetch(sprkey_t index) {
+	if (index < MIN_SPRITE_INDEX || (size_t)index >= _spriteData.size())
+		return;
+	if (!_spriteData[index].IsAssetSprite() || _spriteData[index].IsError() ||
+		_spriteData[index].Image)
+		return; // not an asset sprite, or nothing to load
+	_prefetchQueue.push_back(index);
+}
+
+void SpriteCache::ClearPrefetchQueue() {
+	_prefetchQueue.clear();
+	_prefetchPos = 0u;
+}
+
+size_t SpriteCache::GetPrefetchQueueSize() const {
+	return _prefetchQueue.size() - _prefetchPos;
+}
+
+int SpriteCache::ProcessPrefetchQueue(uint32_t max_ms) {
+	// Prefetching must not push out the sprites which are actually in use,
+	// so only fill up to 3/4 of the space which is not taken by locked sprites
+	const size_t free_limit = (_maxCacheSize > _lockedSize) ? (_maxCacheSize - _lockedSize) : 0u;
+	const size_t budget = _lockedSize + free_limit / 4u * 3u;
+	const uint32_t start = g_system->getMillis();
+	int loaded = 0;
+	while (_prefetchPos < _prefetchQueue.size()) {
+		if ((_cacheSize >= budget) || (g_system->getMillis() - start >= max_ms))
+			break;
+		const sprkey_t index = _prefetchQueue[_prefetchPos++];
+		// The sprite might have been loaded, or even deleted, since it was queued
+		if ((size_t)index >= _spriteData.size() || !_spriteData[index].IsAssetSprite() ||
+			_spriteData[index].IsError() || _spriteData[index].Image)
+			continue;
+		if (LoadSprite(index)) {
+			_spriteData[index].MruIt = _mru.insert(_mru.begin(), index);
+			_stats.Prefetched++;
+			loaded++;
+		}
+	}
+	if (_prefetchPos >= _prefetchQueue.size())
+		ClearPrefetchQueue();
+	SprCacheLog("Prefetched %d sprites, %zu left in queue", loaded, GetPrefetchQueueSize());
+	return loaded;
+}
+
 size_t SpriteCache::LoadSprite(sprkey_t index, bool lock) {
 	assert((index >= 0) && ((size_t)index < _spriteData.size()));
 	if (index < 0 || (size_t)index >= _spriteData.size())
 		return 0;
 	assert((_spriteData[index].Flags & SPRCACHEFLAG_ISASSET) != 0);
 
+	const uint32_t load_start = g_system->getMillis();
 	Bitmap *image;
 	HError err = _file.LoadSprite(index, image);
 	if (!image) {
@@ -401,6 +450,10 @@ size_t SpriteCache::LoadSprite(sprkey_t index, bool lock) {
 	// but not its size or flags.
 	_callbacks.PostInitSprite(index);
 
+	const uint32_t load_time = g_system->getMillis() - load_start;
+	_stats.Loads++;
+	_stats.LoadTimeMs += load_time;
+	_stats.MaxLoadTimeMs = std::max(_stats.MaxLoadTimeMs, load_time);
 	return size;
 }
 
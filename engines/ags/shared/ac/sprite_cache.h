@@ -95,6 +95,16 @@ public:
 		PfnPrewriteSprite PrewriteSprite;
 	};
 
+	// Cache usage counters, for diagnostic purposes
+	struct Statistics {
+		uint32_t Hits = 0;          // requested sprite was found in memory
+		uint32_t Misses = 0;        // requested sprite had to be loaded
+		uint32_t Loads = 0;         // sprites loaded from the file, for any reason
+		uint32_t Prefetched = 0;    // sprites loaded by the prefetch queue
+		uint32_t LoadTimeMs = 0;    // total time spent loading sprites
+		uint32_t MaxLoadTimeMs = 0; // longest single sprite load
+	};
+
 	SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &callbacks);
 	~SpriteCache() = default;
 
@@ -175,6 +185,24 @@ public:
 	// Sets max cache size in bytes
 	void        SetMaxCacheSize(size_t size);
 
+	// Adds an asset sprite to the prefetch queue; queued sprites are loaded
+	// by ProcessPrefetchQueue, unless they are already in memory by then
+	void        QueuePrefetch(sprkey_t index);
+	// Removes all sprites from the prefetch queue
+	void        ClearPrefetchQueue();
+	// Returns number of sprites still waiting in the prefetch queue
+	size_t      GetPrefetchQueueSize() const;
+	// Loads queued sprites into the cache (unlocked, as recently used ones)
+	// until either the queue is empty, the time limit is exceeded, or
+	// the cache gets too full to take them without disposing other sprites;
+	// returns number of loaded sprites
+	int         ProcessPrefetchQueue(uint32_t max_ms);
+
+	// Returns cache usage counters
+	const Statistics &GetStatistics() const { return _stats; }
+	// Resets cache usage counters
+	void        ResetStatistics() { _stats = Statistics(); }
+
 	// Loads (if it's not in cache yet) and returns bitmap by the sprite index
 	Bitmap *operator[](sprkey_t index);
 
@@ -245,6 +273,11 @@ private:
 	// that were last time used long ago.
 	std::list<sprkey_t> _mru;
 
+	// Sprites scheduled for loading ahead of their first use
+	std::vector<sprkey_t> _prefetchQueue;
+	size_t _prefetchPos = 0u; // next queue entry to process
+
+	Statistics _stats;
 };
 
 } // namespace Shared
@@ -200,6 +200,23 @@ void Lingo::pushVoid() {
 	push(d);
 }
 
+Datum Lingo::internName(const char *name, DatumType type) {
+	Common::String key(name);
+	Common::HashMap<Common::String, Datum>::iterator it = _internedNames.find(key);
+	if (it == _internedNames.end()) {
+		Datum d(key);
+		d.type = SYMBOL;
+		_internedNames[key] = d;
+		it = _internedNames.find(key);
+	}
+
+	// The copy shares the interned string. Names are never modified in
+	// place, so only the type of the copy needs to change.
+	Datum d(it->_value);
+	d.type = type;
+	return d;
+}
+
 Datum Lingo::pop() {
 	assert (_state->stack.size() != 0);
 
@@ -420,16 +437,11 @@ void LC::c_symbolpush() {
 	// TODO: FIXME: Currently we push string
 	// If you change it, you must also fix func_play for "play done"
 	// command
-	Datum d = Datum(Common::String(s));
-	d.type = SYMBOL;
-
-	g_lingo->push(d);
+	g_lingo->push(g_lingo->internName(s, SYMBOL));
 }
 
 void LC::c_namepush() {
-	Datum d(g_lingo->readString());
-	d.type = SYMBOL;
-	g_lingo->push(d);
+	g_lingo->push(g_lingo->internName(g_lingo->readString(), SYMBOL));
 }
 
 void LC::c_argcpush() {
@@ -489,31 +501,19 @@ void LC::c_globalinit() {
 }
 
 void LC::c_varrefpush() {
-	Common::String name(g_lingo->readString());
-	Datum d(name);
-	d.type = VARREF;
-	g_lingo->push(d);
+	g_lingo->push(g_lingo->internName(g_lingo->readString(), VARREF));
 }
 
 void LC::c_globalrefpush() {
-	Common::String name(g_lingo->readString());
-	Datum d(name);
-	d.type = GLOBALREF;
-	g_lingo->push(d);
+	g_lingo->push(g_lingo->internName(g_lingo->readString(), GLOBALREF));
 }
 
 void LC::c_localrefpush() {
-	Common::String name(g_lingo->readString());
-	Datum d(name);
-	d.type = LOCALREF;
-	g_lingo->push(d);
+	g_lingo->push(g_lingo->internName(g_lingo->readString(), LOCALREF));
 }
 
 void LC::c_proprefpush() {
-	Common::String name(g_lingo->readString());
-	Datum d(name);
-	d.type = PROPREF;
-	g_lingo->push(d);
+	g_lingo->push(g_lingo->internName(g_lingo->readString(), PROPREF));
 }
 
 void LC::c_varpush() {
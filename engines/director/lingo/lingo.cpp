@@ -20,6 +20,7 @@
  */
 
 #include "common/file.h"
+#include "common/memorypool.h"
 
 #include "graphics/macgui/macwindowmanager.h"
 
@@ -45,6 +46,45 @@ namespace Director {
 
 Lingo *g_lingo;
 
+// Reference counters of shared Datum payloads. They are allocated and
+// released for every copied string, list and reference on the Lingo
+// stack, so they come from a pool rather than the heap.
+static Common::MemoryPool *g_datumRefCountPool = nullptr;
+static uint32 g_datumRefCountsInUse = 0;
+static bool g_datumRefCountPoolReleased = false;
+
+static int *allocDatumRefCount() {
+	if (!g_datumRefCountPool)
+		g_datumRefCountPool = new Common::MemoryPool(sizeof(int));
+	g_datumRefCountPoolReleased = false;
+	g_datumRefCountsInUse++;
+	return (int *)g_datumRefCountPool->allocChunk();
+}
+
+static void freeDatumRefCount(int *refCount) {
+	assert(g_datumRefCountPool);
+	g_datumRefCountPool->freeChunk(refCount);
+	if (--g_datumRefCountsInUse == 0 && g_datumRefCountPoolReleased) {
+		delete g_datumRefCountPool;
+		g_datumRefCountPool = nullptr;
+	}
+}
+
+static bool datumOwnsPayload(DatumType type) {
+	switch (type) {
+	case VOID:
+	case INT:
+	case FLOAT:
+	case ARGC:
+	case ARGCNORET:
+	case CASTLIBREF:
+	case SPRITEREF:
+		return false;
+	default:
+		return true;
+	}
+}
+
 int calcStringAlignment(const char *s) {
 	return calcCodeAlignment(strlen(s) + 1);
 }
@@ -232,6 +272,7 @@ Lingo::~Lingo() {
 	for (auto &it : _openXLibsState) {
 		delete it._value;
 	}
+	Datum::releaseRefCountPool();
 }
 
 void Lingo::reloadBuiltIns() {
@@ -871,52 +912,74 @@ int Lingo::getAlignedType(const Datum &d1, const Datum &d2, bool equality) {
 Datum::Datum() {
 	u.s = nullptr;
 	type = VOID;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Datum &d) {
 	type = d.type;
 	u = d.u;
-	refCount = d.refCount;
-	*refCount += 1;
+	refCount = d.shareRefCount();
 	ignoreGlobal = false;
 }
 
 Datum& Datum::operator=(const Datum &d) {
-	if (this != &d && refCount != d.refCount) {
+	if (this != &d && (!refCount || refCount != d.refCount)) {
+		// Take the new reference before dropping the old one, in case
+		// d lives inside the payload we are about to release
+		int *newRefCount = d.shareRefCount();
+		DatumType newType = d.type;
+		auto newU = d.u;
 		reset();
-		type = d.type;
-		u = d.u;
-		refCount = d.refCount;
-		*refCount += 1;
+		type = newType;
+		u = newU;
+		refCount = newRefCount;
 	}
 	ignoreGlobal = false;
 	return *this;
 }
 
+int *Datum::shareRefCount() const {
+	if (!refCount) {
+		// Plain values are simply copied
+		if (!datumOwnsPayload(type))
+			return nullptr;
+		refCount = allocDatumRefCount();
+		*refCount = 1;
+	}
+	*refCount += 1;
+	return refCount;
+}
+
+void Datum::releaseRefCountPool() {
+	// Datums may outlive the interpreter, so the pool goes away
+	// with the last counter still in use
+	if (g_datumRefCountsInUse == 0) {
+		delete g_datumRefCountPool;
+		g_datumRefCountPool = nullptr;
+	} else {
+		g_datumRefCountPoolReleased = true;
+	}
+}
+
 Datum::Datum(int val) {
 	u.i = val;
 	type = INT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(double val) {
 	u.f = val;
 	type = FLOAT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Common::String &val) {
 	u.s = new Common::String(val);
 	type = STRING;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -928,8 +991,7 @@ Datum::Datum(AbstractObject *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -942,8 +1004,7 @@ Datum::Datum(CastMember *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -951,8 +1012,7 @@ Datum::Datum(CastMember *val) {
 Datum::Datum(const CastMemberID &val) {
 	u.cast = new CastMemberID(val);
 	type = CASTREF;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -961,8 +1021,7 @@ Datum::Datum(const Common::Point &point) {
 	u.farr = new FArray;
 	u.farr->arr.push_back(Datum(point.x));
 	u.farr->arr.push_back(Datum(point.y));
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -973,21 +1032,19 @@ Datum::Datum(const Common::Rect &rect) {
 	u.farr->arr.push_back(Datum(rect.top));
 	u.farr->arr.push_back(Datum(rect.right));
 	u.farr->arr.push_back(Datum(rect.bottom));
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 void Datum::reset() {
-	if (!refCount)
-		return;
-
-	*refCount -= 1;
+	// Without a counter this Datum is the only owner of its payload
+	if (refCount)
+		*refCount -= 1;
 	// Coverity thinks that we always free memory, as it assumes
 	// (correctly) that there are cases when refCount == 0
 	// Thus, DO NOT COMPILE, trick it and shut tons of false positives
 #ifndef __COVERITY__
-	if (*refCount <= 0) {
+	if (!refCount || *refCount <= 0) {
 		switch (type) {
 		case VOID:
 		case INT:
@@ -1019,7 +1076,8 @@ void Datum::reset() {
 		case OBJECT:
 			if (u.obj->getObjType() == kWindowObj) {
 				// Window has an override for decRefCount, use it directly
-				*refCount += 1;
+				if (refCount)
+					*refCount += 1;
 				static_cast<Window *>(u.obj)->decRefCount();
 			} else {
 				// *refCount is copied between the Datum and the Object,
@@ -1044,8 +1102,8 @@ void Datum::reset() {
 			warning("Datum::reset(): Unprocessed REF type %d", type);
 			break;
 		}
-		if (type != OBJECT && type != MEDIA) // object owns refCount
-			delete refCount;
+		if (refCount && type != OBJECT && type != MEDIA) // object owns refCount
+			freeDatumRefCount(refCount);
 	}
 #endif
 }
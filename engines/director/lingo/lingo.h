@@ -143,7 +143,10 @@ struct Datum {	/* interpreter stack type */
 		PictureReference *picture; /* PICTUREREF */
 	} u;
 
-	int *refCount;
+	// Shared between copies of a Datum that owns its payload. Allocated
+	// lazily on the first copy, so values that are never shared, and plain
+	// numbers, do not allocate a counter at all.
+	mutable int *refCount;
 
 	bool ignoreGlobal; // True if this Datum should be ignored by showGlobals and clearGlobals
 
@@ -188,6 +191,11 @@ struct Datum {	/* interpreter stack type */
 	bool operator<(const Datum &d) const;
 	bool operator>=(const Datum &d) const;
 	bool operator<=(const Datum &d) const;
+
+	static void releaseRefCountPool();
+
+private:
+	int *shareRefCount() const;
 };
 
 struct ChunkReference {
@@ -439,6 +447,7 @@ public:
 
 	Datum getVoid();
 	void pushVoid();
+	Datum internName(const char *name, DatumType type);
 
 	void printArgs(const char *funcname, int nargs, const char *prefix = nullptr);
 	inline void printSTUBWithArglist(const char *funcname, int nargs) { printArgs(funcname, nargs, "STUB: "); }
@@ -546,6 +555,10 @@ public:
 
 	DatumHash _globalvars;
 
+	// Names pushed by symbol and variable reference opcodes, shared by
+	// all pushes of the same name instead of copied each time
+	Common::HashMap<Common::String, Datum> _internedNames;
+
 	FuncHash _functions;
 
 	Common::HashMap<int, const LingoV4Bytecode *> _lingoV4;
@@ -57,6 +57,7 @@
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/paint32.h"
 #include "sci/graphics/palette32.h"
+#include "sci/graphics/video32.h"
 #include "sci/sound/decoders/sol.h"
 #include "video/coktel_decoder.h"
 #endif
@@ -95,6 +96,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("opcodes",			WRAP_METHOD(Console, cmdOpcodes));
 	registerCmd("selector",			WRAP_METHOD(Console, cmdSelector));
 	registerCmd("selectors",			WRAP_METHOD(Console, cmdSelectors));
+	registerCmd("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	registerCmd("kernfunctions",		WRAP_METHOD(Console, cmdKernelFunctions));
 	registerCmd("functions",		WRAP_METHOD(Console, cmdKernelFunctions));	// alias
 	registerCmd("kerncall", 		WRAP_METHOD(Console, cmdKernelCall));
@@ -115,6 +117,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
@@ -143,6 +146,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("plane_list",         WRAP_METHOD(Console, cmdPlaneList));
 	registerCmd("pl",                 WRAP_METHOD(Console, cmdPlaneList));	// alias
 	registerCmd("visible_plane_list", WRAP_METHOD(Console, cmdVisiblePlaneList));
+	registerCmd("frameout_benchmark", WRAP_METHOD(Console, cmdFrameOutBenchmark));
 	registerCmd("vpl",                WRAP_METHOD(Console, cmdVisiblePlaneList));	// alias
 	registerCmd("plane_items",        WRAP_METHOD(Console, cmdPlaneItemList));
 	registerCmd("pi",                 WRAP_METHOD(Console, cmdPlaneItemList));	// alias
@@ -163,6 +167,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_incremental",		WRAP_METHOD(Console, cmdGCIncremental));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -200,6 +206,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("disasm_addr",		WRAP_METHOD(Console, cmdDisassembleAddress));
 	registerCmd("find_callk",			WRAP_METHOD(Console, cmdFindKernelFunctionCall));
 	registerCmd("send",				WRAP_METHOD(Console, cmdSend));
+	registerCmd("vm_benchmark",		WRAP_METHOD(Console, cmdVMBenchmark));
 	registerCmd("go",					WRAP_METHOD(Console, cmdGo));
 	registerCmd("logkernel",          WRAP_METHOD(Console, cmdLogKernel));
 	registerCmd("vocab994",          WRAP_METHOD(Console, cmdMapVocab994));
@@ -335,6 +342,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("Kernel:\n");
 	debugPrintf(" opcodes - Lists the opcode names\n");
 	debugPrintf(" selectors - Lists the selector names\n");
+	debugPrintf(" selector_cache - Shows or flushes the selector lookup cache\n");
 	debugPrintf(" selector - Attempts to find the requested selector by name\n");
 	debugPrintf(" functions - Lists the kernel functions\n");
 	debugPrintf(" class_table - Shows the available classes\n");
@@ -354,6 +362,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" hexdump - Dumps the specified resource to standard output\n");
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
+	debugPrintf(" resource_cache - Shows or changes the resource cache budget and statistics\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
@@ -382,6 +391,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" window_list / wl - Shows a list of all the windows (ports) in the draw list (SCI0 - SCI1.1)\n");
 	debugPrintf(" plane_list / pl - Shows a list of all the planes in the draw list (SCI2+)\n");
 	debugPrintf(" visible_plane_list / vpl - Shows a list of all the planes in the visible draw list (SCI2+)\n");
+	debugPrintf(" frameout_benchmark - Times full redraws of the current screen (SCI2+)\n");
 	debugPrintf(" plane_items / pi - Shows a list of all items for a plane (SCI2+)\n");
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
@@ -398,6 +408,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_incremental - Enables or disables the incremental garbage collector\n");
+	debugPrintf(" gc_stats - Shows garbage collector statistics (pause times, objects freed)\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -427,6 +439,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" disasm - Disassembles a method by name\n");
 	debugPrintf(" disasm_addr - Disassembles one or more commands\n");
 	debugPrintf(" send - Sends a message to an object\n");
+	debugPrintf(" vm_benchmark - Times a method with and without the selector cache\n");
 	debugPrintf(" go - Executes the script\n");
 	debugPrintf(" logkernel - Logs kernel calls\n");
 	debugPrintf(" gameflags_init - Initialize gameflag commands if necessary\n");
@@ -615,6 +628,27 @@ bool Console::cmdSelectors(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SegManager *segMan = _engine->_gamestate->_segMan;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "flush")) {
+		segMan->flushSelectorLookupCache();
+		debugPrintf("Selector lookup cache flushed\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the selector lookup cache statistics, or flushes the cache.\n");
+		debugPrintf("Usage: %s [flush]\n", argv[0]);
+		return true;
+	}
+
+	const uint32 hits = segMan->getSelectorLookupHits();
+	const uint32 misses = segMan->getSelectorLookupMisses();
+	debugPrintf("Cached lookups: %d\n", segMan->getSelectorLookupCacheSize());
+	debugPrintf("Hits: %d, misses: %d (%d%% hit rate)\n", hits, misses,
+		(hits + misses) ? (int)((uint64)hits * 100 / (hits + misses)) : 0);
+	return true;
+}
+
 bool Console::cmdKernelFunctions(int argc, const char **argv) {
 	debugPrintf("Kernel function names in numeric order:\n");
 	debugPrintf("+ denotes Kernel functions with subcommands\n");
@@ -1191,6 +1225,42 @@ bool Console::cmdResourceInfo(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		resMan->resetCacheStatistics();
+		debugPrintf("Resource cache statistics reset\n");
+		return true;
+	} else if (argc == 3 && !scumm_stricmp(argv[1], "size")) {
+		const int size = atoi(argv[2]);
+		if (size <= 0) {
+			debugPrintf("Invalid cache size '%s'\n", argv[2]);
+			return true;
+		}
+		if (size > ResourceManager::kMaxCacheSize) {
+			debugPrintf("The cache size can be at most %d MiB\n", ResourceManager::kMaxCacheSize);
+			return true;
+		}
+		resMan->setMaxMemory(size * 1024 * 1024);
+		debugPrintf("Resource cache budget set to %d MiB\n", size);
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the resource cache statistics, resets them, or sets the cache budget in MiB.\n");
+		debugPrintf("Usage: %s [reset | size <MiB>]\n", argv[0]);
+		return true;
+	}
+
+	const ResourceCacheStatistics &stats = resMan->getCacheStatistics();
+	debugPrintf("Budget: %d KiB, cached: %d KiB in %d resources, locked: %d KiB\n",
+		resMan->getMaxMemory() / 1024, resMan->getMemoryLRU() / 1024, resMan->getLRUSize(), resMan->getMemoryLocked() / 1024);
+	debugPrintf("Hits: %d, misses: %d (%d%% hit rate), evictions: %d\n", stats.hits, stats.misses,
+		(stats.hits + stats.misses) ? (int)((uint64)stats.hits * 100 / (stats.hits + stats.misses)) : 0, stats.evictions);
+	debugPrintf("Loaded: %d KiB in %d ms, prefetched: %d resources (prefetch %s)\n",
+		(int)(stats.bytesLoaded / 1024), stats.loadTime, stats.prefetched, resMan->isPrefetchEnabled() ? "on" : "off");
+	return true;
+}
+
 bool Console::cmdResourceTypes(int argc, const char **argv) {
 	debugPrintf("The %d valid resource types are:\n", kResourceTypeInvalid);
 	for (int i = 0; i < kResourceTypeInvalid; i++) {
@@ -2174,6 +2244,38 @@ bool Console::cmdPlaneList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdFrameOutBenchmark(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Redraws all screen items of the current screen and shows the time taken.\n");
+		debugPrintf("Usage: %s [frames]\n", argv[0]);
+		return true;
+	}
+
+#ifdef ENABLE_SCI32
+	if (_engine->_gfxFrameout) {
+		const int frameCount = argc == 2 ? atoi(argv[1]) : 100;
+		if (frameCount <= 0) {
+			debugPrintf("Invalid frame count '%s'\n", argv[1]);
+			return true;
+		}
+
+		if (_engine->_video32->getRobotPlayer().getStatus() != RobotDecoder::kRobotStatusUninitialized) {
+			debugPrintf("Can't benchmark while a robot is playing\n");
+			return true;
+		}
+
+		const uint32 duration = _engine->_gfxFrameout->benchmarkFrameOut(frameCount);
+		debugPrintf("%d frames in %u ms (%u.%02u ms per frame)\n", frameCount, duration,
+			duration / frameCount, (duration % frameCount) * 100 / frameCount);
+	} else {
+		debugPrintf("This SCI version does not have a list of planes\n");
+	}
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 bool Console::cmdVisiblePlaneList(int argc, const char **argv) {
 #ifdef ENABLE_SCI32
 	if (_engine->_gfxFrameout) {
@@ -2934,6 +3036,58 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCIncremental(int argc, const char **argv) {
+	IncrementalGC *gc = _engine->_gamestate->_incrementalGC;
+
+	if (argc < 2 || argc > 3) {
+		debugPrintf("Enables or disables the incremental garbage collector.\n");
+		debugPrintf("Usage: %s on|off [<step budget>]\n", argv[0]);
+		debugPrintf("Incremental gc is currently %s, step budget %d\n", gc->isEnabled() ? "on" : "off", gc->getStepBudget());
+		return true;
+	}
+
+	if (!scumm_stricmp(argv[1], "on")) {
+		gc->setEnabled(true);
+	} else if (!scumm_stricmp(argv[1], "off")) {
+		// Any partial cycle is finished by the next full collection
+		gc->setEnabled(false);
+	} else {
+		debugPrintf("Invalid parameter '%s'\n", argv[1]);
+		return true;
+	}
+
+	if (argc == 3) {
+		int budget = atoi(argv[2]);
+		if (budget <= 0) {
+			debugPrintf("Invalid step budget '%s'\n", argv[2]);
+			return true;
+		}
+		gc->setStepBudget(budget);
+	}
+
+	debugPrintf("Incremental gc is now %s, step budget %d\n", gc->isEnabled() ? "on" : "off", gc->getStepBudget());
+	return true;
+}
+
+bool Console::cmdGCStats(int argc, const char **argv) {
+	IncrementalGC *gc = _engine->_gamestate->_incrementalGC;
+	GCStatistics &stats = gc->getStatistics();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Garbage collector statistics reset\n");
+		return true;
+	}
+
+	debugPrintf("Garbage collector: %s%s\n", gc->isEnabled() ? "incremental" : "full",
+		gc->isRunning() ? " (cycle in progress)" : "");
+	debugPrintf("Full collections: %d\n", stats.fullCollections);
+	debugPrintf("Incremental cycles: %d (%d steps)\n", stats.incrementalCycles, stats.incrementalSteps);
+	debugPrintf("Pause time: last %d ms, max %d ms, total %d ms\n", stats.lastPause, stats.maxPause, stats.totalPause);
+	debugPrintf("Objects freed: last cycle %d, total %d\n", stats.lastFreed, stats.totalFreed);
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -4044,6 +4198,93 @@ bool Console::cmdSend(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdVMBenchmark(int argc, const char **argv) {
+	if (argc < 4) {
+		debugPrintf("Runs a method of an object a number of times, without and with the selector\n");
+		debugPrintf("lookup cache, and shows the times.\n");
+		debugPrintf("The method should not change the game state, as it is run 2 * count times.\n");
+		debugPrintf("Usage: %s <count> <object> <selector name> <param1> <param2> ... <paramn>\n", argv[0]);
+		debugPrintf("Example: %s 1000 ?ego isMemberOf ?Actor\n", argv[0]);
+		return true;
+	}
+
+	EngineState *s = _engine->_gamestate;
+	const int count = atoi(argv[1]);
+	reg_t object;
+
+	if (parse_reg_t(s, argv[2], &object)) {
+		debugPrintf("Invalid address \"%s\" passed.\n", argv[2]);
+		debugPrintf("Check the \"addresses\" command on how to use addresses\n");
+		return true;
+	}
+
+	const int selectorId = _engine->getKernel()->findSelector(argv[3]);
+	if (selectorId < 0) {
+		debugPrintf("Unknown selector: \"%s\"\n", argv[3]);
+		return true;
+	}
+
+	if (!s->_segMan->getObject(object)) {
+		debugPrintf("Address \"%04x:%04x\" is not an object\n", PRINT_REG(object));
+		return true;
+	}
+
+	if (lookupSelector(s->_segMan, object, selectorId, nullptr, nullptr) != kSelectorMethod) {
+		debugPrintf("Selector \"%s\" is not a method of the object\n", argv[3]);
+		return true;
+	}
+
+	const int send_argc = argc - 4;
+	Common::Array<reg_t> params(send_argc);
+	for (int i = 0; i < send_argc; i++) {
+		if (parse_reg_t(s, argv[4 + i], &params[i])) {
+			debugPrintf("Invalid address \"%s\" passed.\n", argv[4 + i]);
+			debugPrintf("Check the \"addresses\" command on how to use addresses\n");
+			return true;
+		}
+	}
+
+	static const char *const modes[] = {
+		"Plain",
+		"Selector cache"
+	};
+
+	const bool cacheEnabled = s->_segMan->isSelectorLookupCacheEnabled();
+	const reg_t old_acc = s->r_acc;
+
+	for (int mode = 0; mode < ARRAYSIZE(modes); mode++) {
+		s->_segMan->setSelectorLookupCacheEnabled(mode >= 1);
+
+		const int steps = s->scriptStepCounter;
+		const uint32 start = g_system->getMillis();
+
+		for (int i = 0; i < count; i++) {
+			// The method can change its parameters, so set them up every time
+			StackPtr stackframe = s->_executionStack.back().sp;
+			stackframe[0] = make_reg(0, selectorId);
+			stackframe[1] = make_reg(0, send_argc);
+			for (int j = 0; j < send_argc; j++)
+				stackframe[2 + j] = params[j];
+
+			ExecStack *old_xstack = &s->_executionStack.back();
+			send_selector(s, object, object, stackframe + 2 + send_argc, 2 + send_argc, stackframe);
+			s->_executionStackPosChanged = true;
+			run_vm(s);
+			s->xs = old_xstack;
+
+			if (s->abortScriptProcessing != kAbortNone)
+				break;
+		}
+
+		const uint32 time = g_system->getMillis() - start;
+		debugPrintf("%s: %u ms, %d instructions\n", modes[mode], time, s->scriptStepCounter - steps);
+	}
+
+	s->_segMan->setSelectorLookupCacheEnabled(cacheEnabled);
+	s->r_acc = old_acc;
+	return true;
+}
+
 bool Console::cmdGo(int argc, const char **argv) {
 	// CHECKME: is this necessary?
 	_debugState.seeking = kDebugSeekNothing;
@@ -54,6 +54,7 @@ private:
 	bool cmdOpcodes(int argc, const char **argv);
 	bool cmdSelector(int argc, const char **argv);
 	bool cmdSelectors(int argc, const char **argv);
+	bool cmdSelectorCache(int argc, const char **argv);
 	bool cmdKernelFunctions(int argc, const char **argv);
 	bool cmdKernelCall(int argc, const char **argv);
 	bool cmdClassTable(int argc, const char **argv);
@@ -72,6 +73,7 @@ private:
 	bool cmdHexDump(int argc, const char **argv);
 	bool cmdResourceId(int argc, const char **argv);
 	bool cmdResourceInfo(int argc, const char **argv);
+	bool cmdResourceCache(int argc, const char **argv);
 	bool cmdResourceTypes(int argc, const char **argv);
 	bool cmdList(int argc, const char **argv);
 	bool cmdResourceIntegrityDump(int argc, const char **argv);
@@ -98,6 +100,7 @@ private:
 	bool cmdAnimateList(int argc, const char **argv);
 	bool cmdWindowList(int argc, const char **argv);
 	bool cmdPlaneList(int argc, const char **argv);
+	bool cmdFrameOutBenchmark(int argc, const char **argv);
 	bool cmdVisiblePlaneList(int argc, const char **argv);
 	bool cmdPlaneItemList(int argc, const char **argv);
 	bool cmdVisiblePlaneItemList(int argc, const char **argv);
@@ -113,6 +116,8 @@ private:
 	bool cmdGCShowReachable(int argc, const char **argv);
 	bool cmdGCShowFreeable(int argc, const char **argv);
 	bool cmdGCNormalize(int argc, const char **argv);
+	bool cmdGCIncremental(int argc, const char **argv);
+	bool cmdGCStats(int argc, const char **argv);
 	// Music/SFX
 	bool cmdSongLib(int argc, const char **argv);
 	bool cmdSongInfo(int argc, const char **argv);
@@ -141,6 +146,7 @@ private:
 	bool cmdDisassembleAddress(int argc, const char **argv);
 	bool cmdFindKernelFunctionCall(int argc, const char **argv);
 	bool cmdSend(int argc, const char **argv);
+	bool cmdVMBenchmark(int argc, const char **argv);
 	bool cmdGo(int argc, const char **argv);
 	bool cmdLogKernel(int argc, const char **argv);
 	bool cmdMapVocab994(int argc, const char **argv);
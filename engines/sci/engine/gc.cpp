@@ -21,6 +21,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -83,26 +84,36 @@ static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_
 	return normal_map;
 }
 
-static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap) {
+static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap, uint budget = 0) {
 	SegmentId stackSegment = segMan->findSegmentByType(SEG_TYPE_STACK);
+	uint processed = 0;
 	while (!wm._worklist.empty()) {
+		if (budget && processed++ >= budget)
+			break;
+
 		reg_t reg = wm._worklist.back();
 		wm._worklist.pop_back();
 		if (reg.getSegment() != stackSegment) { // No need to repeat this one
 			debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
-			if (reg.getSegment() < heap.size() && heap[reg.getSegment()]) {
-				// Valid heap object? Find its outgoing references!
+			// Valid heap object? Find its outgoing references! Entries may
+			// have been freed explicitly by scripts since they were pushed
+			// during an incremental cycle, so skip those.
+			if (reg.getSegment() < heap.size() && heap[reg.getSegment()] &&
+				heap[reg.getSegment()]->isValidOffset(reg.getOffset())) {
 				wm.pushArray(heap[reg.getSegment()]->listAllOutgoingReferences(reg));
 			}
 		}
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+/**
+ * Pushes the root set onto the work list. If rescanRoots is set, the
+ * outgoing references of root objects which have already been marked are
+ * pushed again, so that stores into them since they were traced are seen.
+ */
+static void pushRootSet(EngineState *s, WorklistManager &wm, bool rescanRoots) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -149,7 +160,16 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 				Script *script = (Script *)heap[i];
 
 				if (script->getLockers()) { // Explicitly loaded?
-					wm.pushArray(script->listObjectReferences());
+					const Common::Array<reg_t> objects = script->listObjectReferences();
+					wm.pushArray(objects);
+
+					if (rescanRoots) {
+						for (Common::Array<reg_t>::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+							SegmentObj *mobj = s->_segMan->getSegmentObj(it->getSegment());
+							if (mobj)
+								wm.pushArray(mobj->listAllOutgoingReferences(*it));
+						}
+					}
 				}
 			}
 
@@ -169,7 +189,14 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
 
+	pushRootSet(s, wm, false);
+
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
 	processWorkList(s->_segMan, wm, heap);
 
 	if (g_sci->_gfxPorts)
@@ -180,6 +207,12 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	IncrementalGC *incrementalGC = s->_incrementalGC;
+	const uint32 startTime = g_system->getMillis();
+	uint32 freed = 0;
+
+	// A full collection supersedes any partially completed cycle
+	incrementalGC->cancel(segMan);
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -214,6 +247,7 @@ void run_gc(EngineState *s) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+					freed++;
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
@@ -232,6 +266,167 @@ void run_gc(EngineState *s) {
 		if (segcount[i])
 			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
 #endif
+
+	GCStatistics &stats = incrementalGC->getStatistics();
+	stats.fullCollections++;
+	stats.lastFreed = freed;
+	stats.totalFreed += freed;
+	stats.addPause(g_system->getMillis() - startTime);
+}
+
+void GCStatistics::reset() {
+	fullCollections = 0;
+	incrementalCycles = 0;
+	incrementalSteps = 0;
+	lastPause = 0;
+	maxPause = 0;
+	totalPause = 0;
+	lastFreed = 0;
+	totalFreed = 0;
+}
+
+void GCStatistics::addPause(uint32 duration) {
+	lastPause = duration;
+	maxPause = MAX(maxPause, duration);
+	totalPause += duration;
+}
+
+IncrementalGC::IncrementalGC() :
+	_enabled(false),
+	_stepBudget(kGCStepBudget),
+	_phase(kPhaseIdle),
+	_liveSet(nullptr),
+	_sweepSegment(0),
+	_freedThisCycle(0) {
+}
+
+IncrementalGC::~IncrementalGC() {
+	delete _liveSet;
+}
+
+bool IncrementalGC::step(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	const uint32 startTime = g_system->getMillis();
+	bool finished = false;
+
+	switch (_phase) {
+	case kPhaseIdle:
+		beginCycle(s);
+		break;
+
+	case kPhaseMark:
+		if (markStep(segMan))
+			finishMark(s);
+		break;
+
+	case kPhaseSweep:
+		finished = sweep(segMan);
+		break;
+	}
+
+	_stats.incrementalSteps++;
+	_stats.addPause(g_system->getMillis() - startTime);
+
+	if (finished) {
+		_stats.incrementalCycles++;
+		_stats.lastFreed = _freedThisCycle;
+		_stats.totalFreed += _freedThisCycle;
+		debugC(kDebugLevelGC, "[GC] Incremental cycle done, %d objects freed", _freedThisCycle);
+	}
+
+	return finished;
+}
+
+void IncrementalGC::cancel(SegManager *segMan) {
+	if (segMan->getIncrementalGC() == this)
+		segMan->setIncrementalGC(nullptr);
+
+	_phase = kPhaseIdle;
+	_wm._worklist.clear();
+	_wm._map.clear();
+	delete _liveSet;
+	_liveSet = nullptr;
+}
+
+void IncrementalGC::shade(SegManager *segMan, reg_t reg) {
+	if (_phase == kPhaseMark) {
+		_wm.push(reg);
+	} else if (_phase == kPhaseSweep) {
+		// Only freshly allocated objects can get here, as unreachable
+		// objects cannot become reachable again
+		SegmentObj *mobj = segMan->getSegmentObj(reg.getSegment());
+		if (mobj)
+			_liveSet->setVal(mobj->findCanonicAddress(segMan, reg), true);
+	}
+}
+
+void IncrementalGC::beginMark(SegManager *segMan) {
+	_wm._worklist.clear();
+	_wm._map.clear();
+	_freedThisCycle = 0;
+	_phase = kPhaseMark;
+	segMan->setIncrementalGC(this);
+}
+
+bool IncrementalGC::markStep(SegManager *segMan) {
+	processWorkList(segMan, _wm, segMan->getSegments(), _stepBudget);
+	return _wm._worklist.empty();
+}
+
+void IncrementalGC::beginCycle(EngineState *s) {
+	debugC(kDebugLevelGC, "[GC] Starting incremental cycle");
+
+	beginMark(s->_segMan);
+	pushRootSet(s, _wm, false);
+}
+
+void IncrementalGC::finishMark(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+
+	// The stack, the registers and the root objects are not covered by the
+	// write barrier, so scan them again and finish marking in one go
+	pushRootSet(s, _wm, true);
+	processWorkList(segMan, _wm, segMan->getSegments());
+
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(_wm);
+
+	_liveSet = normalizeAddresses(segMan, _wm._map);
+	_wm._map.clear();
+	_sweepSegment = 1;
+	_phase = kPhaseSweep;
+
+	debugC(kDebugLevelGC, "[GC] Mark phase done, %d reachable addresses", _liveSet->size());
+}
+
+bool IncrementalGC::sweep(SegManager *segMan) {
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	uint processed = 0;
+
+	while (_sweepSegment < heap.size() && processed < _stepBudget) {
+		const SegmentId seg = _sweepSegment++;
+		SegmentObj *mobj = heap[seg];
+
+		if (mobj == nullptr)
+			continue;
+
+		const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
+		for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
+			const reg_t addr = *it;
+			if (!_liveSet->contains(addr)) {
+				mobj->freeAtAddress(segMan, addr);
+				debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+				_freedThisCycle++;
+			}
+		}
+		processed += tmp.size() + 1;
+	}
+
+	if (_sweepSegment < heap.size())
+		return false;
+
+	cancel(segMan);
+	return true;
 }
 
 } // End of namespace Sci
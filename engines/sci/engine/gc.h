@@ -41,6 +41,11 @@ struct reg_t_Hash {
  */
 typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
 
+enum {
+	/** Default number of references traced or freed per incremental gc step */
+	kGCStepBudget = 512
+};
+
 /**
  * Finds all used references and normalises them to their memory addresses
  * @param s The state to gather all information from
@@ -62,6 +67,109 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+/**
+ * Garbage collector statistics, shown by the "gc_stats" console command.
+ * Pause times are in milliseconds.
+ */
+struct GCStatistics {
+	uint32 fullCollections;    ///< Number of stop-the-world collections
+	uint32 incrementalCycles;  ///< Number of completed incremental cycles
+	uint32 incrementalSteps;   ///< Number of incremental mark/sweep steps
+	uint32 lastPause;          ///< Duration of the last collector pause
+	uint32 maxPause;           ///< Longest collector pause seen so far
+	uint32 totalPause;         ///< Sum of all collector pauses
+	uint32 lastFreed;          ///< Objects freed by the last completed cycle
+	uint32 totalFreed;         ///< Objects freed by all cycles
+
+	GCStatistics() { reset(); }
+	void reset();
+	void addPause(uint32 duration);
+};
+
+/**
+ * Incremental mark-and-sweep garbage collector.
+ *
+ * A cycle is split into small steps which are run from the VM in between
+ * kernel calls, so that a large heap does not stall the game for a whole
+ * collection. The mark phase traces at most _stepBudget references per step.
+ * References stored into the heap while marking are reported through
+ * SegManager::writeBarrier(), and objects allocated during a cycle are
+ * treated as reachable. Once the work list runs dry, the root set is
+ * rescanned in one final step and the sweep phase frees unreachable objects,
+ * again a limited number per step.
+ */
+class IncrementalGC {
+public:
+	IncrementalGC();
+	~IncrementalGC();
+
+	bool isEnabled() const { return _enabled; }
+	void setEnabled(bool enabled) { _enabled = enabled; }
+
+	bool isRunning() const { return _phase != kPhaseIdle; }
+
+	uint getStepBudget() const { return _stepBudget; }
+	void setStepBudget(uint budget) { _stepBudget = budget; }
+
+	/**
+	 * Performs one step of the current collection cycle, starting a new
+	 * cycle if none is running.
+	 * @return true if this step completed a cycle
+	 */
+	bool step(EngineState *s);
+
+	/**
+	 * Discards the current cycle without freeing anything. Used when a full
+	 * collection is forced and when the heap is torn down.
+	 */
+	void cancel(SegManager *segMan);
+
+	/**
+	 * Marks a reference as reachable for the current cycle. Called by the
+	 * write barrier in SegManager.
+	 */
+	void shade(SegManager *segMan, reg_t reg);
+
+	/**
+	 * Starts the mark phase of a cycle with an empty root set. References
+	 * shaded from then on are traced by markStep().
+	 */
+	void beginMark(SegManager *segMan);
+
+	/**
+	 * Traces at most the step budget of references of the mark phase.
+	 * @return true if there is nothing left to trace
+	 */
+	bool markStep(SegManager *segMan);
+
+	/** Checks if a reference has been reached by the current mark phase */
+	bool isMarked(reg_t reg) const { return _wm._map.contains(reg); }
+
+	GCStatistics &getStatistics() { return _stats; }
+
+private:
+	enum Phase {
+		kPhaseIdle,
+		kPhaseMark,
+		kPhaseSweep
+	};
+
+	void beginCycle(EngineState *s);
+	void finishMark(EngineState *s);
+	bool sweep(SegManager *segMan);
+
+	bool _enabled;
+	uint _stepBudget;
+	Phase _phase;
+
+	WorklistManager _wm;     ///< Grey set and marked set during the mark phase
+	AddrSet *_liveSet;       ///< Normalized reachable set during the sweep phase
+	uint _sweepSegment;      ///< Next segment to sweep
+	uint32 _freedThisCycle;
+
+	GCStatistics _stats;
+};
+
 
 } // End of namespace Sci
 
@@ -68,6 +68,15 @@ enum {
 
 #define VERTEX_HAS_EDGES(V) ((V) != CLIST_NEXT(V))
 
+// Number of polygon sets whose visibility graph is kept between calls
+#define VISIBILITY_GRAPH_CACHE_SIZE 4
+
+// Polygon sets with more vertices than this are not cached
+#define VISIBILITY_GRAPH_MAX_VERTICES 512
+
+// Number of cells along each axis of the polygon edge grid
+#define EDGE_GRID_SIZE 8
+
 // Error codes
 enum {
 	PF_OK = 0,
@@ -116,10 +125,18 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Position in the vertex index
+	int index;
+
+	// Last edge grid query that visited this vertex's edge
+	uint32 gridStamp;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = nullptr;
+		index = -1;
+		gridStamp = 0;
 	}
 };
 
@@ -241,6 +258,31 @@ public:
 
 typedef Common::List<Polygon *> PolygonList;
 
+/**
+ * Uniform grid over the bounding box of all polygon edges, used to find the
+ * edges that can possibly block the line between two vertices. Each edge is
+ * stored (as the vertex it starts at) in every cell its bounding box covers.
+ */
+struct EdgeGrid {
+	// Bounding box of all edges, inclusive
+	int _left, _top, _right, _bottom;
+
+	int _cellWidth, _cellHeight;
+
+	Common::Array<Vertex *> _cells[EDGE_GRID_SIZE * EDGE_GRID_SIZE];
+
+	// Current query, to visit edges spanning several cells only once
+	uint32 _stamp;
+
+	EdgeGrid(Vertex **vertexIndex, int vertices);
+
+	bool blocked(Vertex *vertex_cur, Vertex *vertex);
+
+private:
+	int cellX(int x) const { return CLIP((x - _left) / _cellWidth, 0, EDGE_GRID_SIZE - 1); }
+	int cellY(int y) const { return CLIP((y - _top) / _cellHeight, 0, EDGE_GRID_SIZE - 1); }
+};
+
 // Pathfinding state
 struct PathfindingState {
 	// List of all polygons
@@ -262,6 +304,15 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Cached visibility of the obstacle vertices, or NULL if not cached
+	VisibilityGraph *_visibility;
+
+	// Index of the first obstacle vertex in vertex_index
+	int _visibilityOffset;
+
+	// Spatial index of all polygon edges
+	EdgeGrid *_edgeGrid;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = nullptr;
 		vertex_end = nullptr;
@@ -269,10 +320,14 @@ struct PathfindingState {
 		_prependPoint = nullptr;
 		_appendPoint = nullptr;
 		vertices = 0;
+		_visibility = nullptr;
+		_visibilityOffset = 0;
+		_edgeGrid = nullptr;
 	}
 
 	~PathfindingState() {
 		free(vertex_index);
+		delete _edgeGrid;
 
 		delete _prependPoint;
 		delete _appendPoint;
@@ -698,6 +753,118 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether or not an edge blocks the line between two vertices
+ * Parameters: (Vertex *) vertex_cur, vertex: The line (vertex_cur, vertex)
+ *             (Vertex *) edge: The vertex the edge starts at
+ * Returns   : (bool) true if the line cannot pass the edge, false otherwise
+ */
+static bool edge_blocks(Vertex *vertex_cur, Vertex *vertex, Vertex *edge) {
+	if (between(vertex_cur->v, vertex->v, edge->v)) {
+		// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+		return inside(vertex_cur->v, edge) || inside(vertex->v, edge);
+	}
+
+	return intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v);
+}
+
+EdgeGrid::EdgeGrid(Vertex **vertexIndex, int vertices) : _stamp(0) {
+	_left = _top = 0x7FFF;
+	_right = _bottom = -0x8000;
+
+	for (int i = 0; i < vertices; i++) {
+		const Common::Point &p = vertexIndex[i]->v;
+		_left = MIN<int>(_left, p.x);
+		_right = MAX<int>(_right, p.x);
+		_top = MIN<int>(_top, p.y);
+		_bottom = MAX<int>(_bottom, p.y);
+	}
+
+	_cellWidth = MAX((_right - _left + EDGE_GRID_SIZE) / EDGE_GRID_SIZE, 1);
+	_cellHeight = MAX((_bottom - _top + EDGE_GRID_SIZE) / EDGE_GRID_SIZE, 1);
+
+	for (int i = 0; i < vertices; i++) {
+		Vertex *edge = vertexIndex[i];
+
+		if (!VERTEX_HAS_EDGES(edge))
+			continue;
+
+		const Common::Point &p = edge->v;
+		const Common::Point &q = CLIST_NEXT(edge)->v;
+		const int x1 = cellX(MIN(p.x, q.x)), x2 = cellX(MAX(p.x, q.x));
+		const int y1 = cellY(MIN(p.y, q.y)), y2 = cellY(MAX(p.y, q.y));
+
+		for (int y = y1; y <= y2; y++) {
+			for (int x = x1; x <= x2; x++)
+				_cells[y * EDGE_GRID_SIZE + x].push_back(edge);
+		}
+	}
+}
+
+bool EdgeGrid::blocked(Vertex *vertex_cur, Vertex *vertex) {
+	const Common::Point &a = vertex_cur->v;
+	const Common::Point &b = vertex->v;
+
+	// An edge can only block the line if the bounding boxes overlap
+	const int left = MIN(a.x, b.x), right = MAX(a.x, b.x);
+	const int top = MIN(a.y, b.y), bottom = MAX(a.y, b.y);
+
+	if (right < _left || left > _right || bottom < _top || top > _bottom)
+		return false;
+
+	const int x1 = cellX(left), x2 = cellX(right);
+	const int y1 = cellY(top), y2 = cellY(bottom);
+
+	_stamp++;
+
+	for (int y = y1; y <= y2; y++) {
+		for (int x = x1; x <= x2; x++) {
+			const Common::Array<Vertex *> &cell = _cells[y * EDGE_GRID_SIZE + x];
+
+			for (uint i = 0; i < cell.size(); i++) {
+				Vertex *edge = cell[i];
+
+				if (edge->gridStamp == _stamp)
+					continue;
+
+				edge->gridStamp = _stamp;
+
+				if (edge_blocks(vertex_cur, vertex, edge))
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Determines whether or not two vertices are visible from each other
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (Vertex *) vertex_cur, vertex: The two vertices
+ * Returns   : (bool) true if the line (vertex_cur, vertex) doesn't intersect
+ *                    any polygon, false otherwise
+ */
+static bool vertices_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges. When both vertices are at the same
+	// location every vertex on the same row counts as lying between them,
+	// so the edge grid can't be used.
+	if (s->_edgeGrid && vertex_cur->v != vertex->v)
+		return !s->_edgeGrid->blocked(vertex_cur, vertex);
+
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge) && edge_blocks(vertex_cur, vertex, edge))
+			return false;
+	}
+
+	return true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -706,35 +873,31 @@ static int inside(const Common::Point &p, Vertex *vertex) {
  */
 static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	VertexList *visVerts = new VertexList();
+	VisibilityGraph *graph = s->_visibility;
+	const int cur = vertex_cur->index - s->_visibilityOffset;
 
-	for (int i = 0; i < s->vertices; i++) {
+	// Vertices are visited back to front to keep the order of the list the
+	// same as when it was built with push_front
+	for (int i = s->vertices - 1; i >= 0; i--) {
 		Vertex *vertex = s->vertex_index[i];
+		const int other = i - s->_visibilityOffset;
+		bool visible;
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
+		if (graph && cur >= 0 && other >= 0) {
+			// Both vertices belong to the obstacles, so their visibility
+			// doesn't depend on the start and end points
+			byte &pair = graph->pairs[MIN(cur, other) * graph->vertexCount + MAX(cur, other)];
 
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+			if (pair == VisibilityGraph::kPairUnknown)
+				pair = vertices_visible(s, vertex_cur, vertex) ? VisibilityGraph::kPairVisible : VisibilityGraph::kPairBlocked;
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
+			visible = (pair == VisibilityGraph::kPairVisible);
+		} else {
+			visible = vertices_visible(s, vertex_cur, vertex);
 		}
 
-		if (j == s->vertices)
-			visVerts->push_front(vertex);
+		if (visible)
+			visVerts->push_back(vertex);
 	}
 
 	return visVerts;
@@ -1235,6 +1398,66 @@ static void change_polygons_opt_0(PathfindingState *s) {
 	}
 }
 
+/**
+ * Finds the visibility graph of the polygons in a pathfinding state, creating
+ * an empty one if the polygon set hasn't been seen recently
+ * Parameters: (EngineState *) s: The game state
+ *             (PathfindingState *) pf_s: The pathfinding state
+ * Returns   : (VisibilityGraph *) The visibility graph, or NULL if the
+ *                                 polygon set is too large to be cached
+ */
+static VisibilityGraph *lookup_visibility_graph(EngineState *s, PathfindingState *pf_s) {
+	Common::Array<int16> key;
+	uint vertexCount = 0;
+	uint32 hash = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		const uint size = (*it)->vertices.size();
+		Vertex *vertex;
+
+		vertexCount += size;
+		if (vertexCount > VISIBILITY_GRAPH_MAX_VERTICES)
+			return nullptr;
+
+		key.push_back(size);
+		CLIST_FOREACH(vertex, &(*it)->vertices) {
+			key.push_back(vertex->v.x);
+			key.push_back(vertex->v.y);
+		}
+	}
+
+	for (uint i = 0; i < key.size(); i++)
+		hash = hash * 31 + (uint16)key[i];
+
+	Common::List<VisibilityGraph *> &graphs = s->_visibilityGraphs;
+
+	for (Common::List<VisibilityGraph *>::iterator it = graphs.begin(); it != graphs.end(); ++it) {
+		VisibilityGraph *graph = *it;
+
+		if (graph->hash == hash && graph->key == key) {
+			graphs.erase(it);
+			graphs.push_front(graph);
+			return graph;
+		}
+	}
+
+	if (graphs.size() == VISIBILITY_GRAPH_CACHE_SIZE) {
+		delete graphs.back();
+		graphs.pop_back();
+	}
+
+	VisibilityGraph *graph = new VisibilityGraph();
+	graph->hash = hash;
+	graph->key = key;
+	graph->vertexCount = vertexCount;
+	graph->pairs.resize(vertexCount * vertexCount);
+	for (uint i = 0; i < graph->pairs.size(); i++)
+		graph->pairs[i] = VisibilityGraph::kPairUnknown;
+
+	graphs.push_front(graph);
+	return graph;
+}
+
 /**
  * Converts the SCI input data for pathfinding
  * Parameters: (EngineState *) s: The game state
@@ -1326,6 +1549,9 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	VisibilityGraph *graph = lookup_visibility_graph(s, pf_s);
+	const uint polygonCount = pf_s->polygons.size();
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1343,11 +1569,27 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count;
 			pf_s->vertex_index[count++] = vertex;
 		}
 	}
 
 	pf_s->vertices = count;
+	pf_s->_edgeGrid = new EdgeGrid(pf_s->vertex_index, count);
+
+	// The cached graph stays valid as long as the start and end points were
+	// added as separate single-vertex polygons. These are inserted in front
+	// of the obstacles, so the obstacle vertices keep their relative order.
+	// If one of the points split an edge instead, all pairs are computed
+	// from scratch.
+	if (graph) {
+		const uint newVertices = pf_s->polygons.size() - polygonCount;
+
+		if ((uint)count == graph->vertexCount + newVertices) {
+			pf_s->_visibility = graph;
+			pf_s->_visibilityOffset = newVertices;
+		}
+	}
 
 	return pf_s;
 }
@@ -20,6 +20,7 @@
  */
 
 #include "sci/sci.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
 #include "sci/engine/script.h"
@@ -31,7 +32,8 @@ namespace Sci {
 
 
 SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
-	: _resMan(resMan), _scriptPatcher(scriptPatcher) {
+	: _resMan(resMan), _scriptPatcher(scriptPatcher), _incrementalGC(nullptr),
+	  _selectorLookupCacheEnabled(true), _selectorLookupHits(0), _selectorLookupMisses(0) {
 	_heap.push_back(0);
 
 	_clonesSegId = 0;
@@ -55,6 +57,10 @@ SegManager::~SegManager() {
 }
 
 void SegManager::resetSegMan() {
+	// Drop any partially completed garbage collection
+	if (_incrementalGC)
+		_incrementalGC->cancel(this);
+
 	// Free memory
 	for (uint i = 0; i < _heap.size(); i++) {
 		if (_heap[i])
@@ -79,6 +85,12 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	flushSelectorLookupCache();
+}
+
+void SegManager::flushSelectorLookupCache() {
+	_selectorLookupCache.clear(true);
 }
 
 void SegManager::initSysStrings() {
@@ -96,6 +108,10 @@ void SegManager::initSysStrings() {
 	}
 }
 
+void SegManager::shadeForGC(reg_t value) {
+	_incrementalGC->shade(this, value);
+}
+
 SegmentId SegManager::findFreeSegment() const {
 	// The following is a very crude approach: We find a free segment id by
 	// scanning from the start. This can be slow if the number of segments
@@ -141,6 +157,7 @@ Script *SegManager::allocateScript(int script_nr, SegmentId &segid) {
 	// Add the script to the "script id -> segment id" hashmap
 	_scriptSegMap[script_nr] = segid;
 
+	writeBarrier(make_reg(segid, 0));
 	return script;
 }
 
@@ -165,6 +182,7 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		flushSelectorLookupCache();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -467,6 +485,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	h.size = size;
 	h.type = hunk_type;
 
+	writeBarrier(addr);
 	return addr;
 }
 
@@ -494,6 +513,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	writeBarrier(*addr);
 	return &table->at(offset);
 }
 
@@ -510,6 +530,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	writeBarrier(*addr);
 	return &table->at(offset);
 }
 
@@ -526,6 +547,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	writeBarrier(*addr);
 	return &table->at(offset);
 }
 
@@ -535,6 +557,8 @@ reg_t SegManager::newNode(reg_t value, reg_t key) {
 	n->pred = n->succ = NULL_REG;
 	n->key = key;
 	n->value = value;
+	writeBarrier(key);
+	writeBarrier(value);
 
 	return nodeRef;
 }
@@ -922,6 +946,7 @@ byte *SegManager::allocDynmem(int size, const char *descr, reg_t *addr) {
 
 	dynmem->_description = descr;
 
+	writeBarrier(*addr);
 	return dynmem->_buf;
 }
 
@@ -952,6 +977,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	writeBarrier(*addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -1008,6 +1034,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_bitmapSegId, offset);
+	writeBarrier(*addr);
 	SciBitmap &bitmap = table->at(offset);
 
 	bitmap.create(width, height, skipColor, originX, originY, xResolution, yResolution, paletteSize, remap, gc);
@@ -1099,7 +1126,16 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 		scr = allocateScript(scriptNum, segmentId);
 	}
 
+	flushSelectorLookupCache();
+
 	scr->load(scriptNum, _resMan, _scriptPatcher, applyScriptPatches);
+
+	// The game sets the number of a new room before it loads the room
+	// script. Other scripts don't get their resources read ahead.
+	EngineState *s = g_sci->getEngineState();
+	if (s && s->variables[VAR_GLOBAL] && scriptNum == s->currentRoomNumber())
+		_resMan->prefetchRoom(scriptNum);
+
 	scr->initializeLocals(this);
 	scr->initializeObjects(this, segmentId, applyScriptPatches);
 #ifdef ENABLE_SCI32
@@ -1124,6 +1160,8 @@ void SegManager::uninstantiateScript(int script_nr) {
 	if (scr->getLockers() > 0)
 		return;
 
+	flushSelectorLookupCache();
+
 	// Free all classtable references to this script
 	for (uint i = 0; i < classTableSize(); i++)
 		if (getClass(i).reg.getSegment() == segmentId)
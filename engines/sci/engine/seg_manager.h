@@ -44,6 +44,7 @@ enum ScriptLoadType {
 };
 
 class Script;
+class IncrementalGC;
 
 class SegManager : public Common::Serializable {
 	friend class Console;
@@ -432,6 +433,53 @@ public:
 	 */
 	Common::Array<reg_t> findObjectsBySuperClass(const Common::String &superClassName);
 
+	// Selector lookup cache
+
+	/**
+	 * Looks up a cached lookupSelector() result for the object defined at
+	 * the given position.
+	 * @return true if the result was found in the cache
+	 */
+	bool getCachedSelectorLookup(reg_t objPos, Selector selector, SelectorLookupResult &result) {
+		if (!_selectorLookupCacheEnabled)
+			return false;
+
+		SelectorLookupCache::const_iterator it = _selectorLookupCache.find(SelectorLookupKey{objPos, selector});
+		if (it == _selectorLookupCache.end()) {
+			_selectorLookupMisses++;
+			return false;
+		}
+		_selectorLookupHits++;
+		result = it->_value;
+		return true;
+	}
+
+	void cacheSelectorLookup(reg_t objPos, Selector selector, const SelectorLookupResult &result) {
+		if (_selectorLookupCacheEnabled)
+			_selectorLookupCache.setVal(SelectorLookupKey{objPos, selector}, result);
+	}
+
+	/**
+	 * Switches the selector lookup cache on or off, to compare in benchmarks.
+	 * The cache is flushed, so it starts out empty.
+	 */
+	void setSelectorLookupCacheEnabled(bool enabled) {
+		flushSelectorLookupCache();
+		_selectorLookupCacheEnabled = enabled;
+	}
+
+	bool isSelectorLookupCacheEnabled() const { return _selectorLookupCacheEnabled; }
+
+	/**
+	 * Drops all cached selector lookups. Called whenever scripts are loaded
+	 * or unloaded, as this changes objects and their superclass chains.
+	 */
+	void flushSelectorLookupCache();
+
+	uint getSelectorLookupCacheSize() const { return _selectorLookupCache.size(); }
+	uint32 getSelectorLookupHits() const { return _selectorLookupHits; }
+	uint32 getSelectorLookupMisses() const { return _selectorLookupMisses; }
+
 	uint32 classTableSize() const { return _classTable.size(); }
 	Class getClass(int index) const { return _classTable[index]; }
 	void setClassOffset(int index, reg_t offset) { _classTable[index].reg = offset;	}
@@ -460,12 +508,42 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	// Garbage collection
+
+	/**
+	 * Write barrier for the incremental garbage collector. Must be called
+	 * whenever a reference is stored into an object property, a local or
+	 * global variable, a list node or an array, and for every newly
+	 * allocated object, so that a running mark phase does not miss it.
+	 * Does nothing if no incremental collection is in progress.
+	 * @param value The reference being stored
+	 */
+	void writeBarrier(reg_t value) {
+		if (_incrementalGC && value.getSegment())
+			shadeForGC(value);
+	}
+
+	IncrementalGC *getIncrementalGC() const { return _incrementalGC; }
+	void setIncrementalGC(IncrementalGC *gc) { _incrementalGC = gc; }
+
 private:
+	void shadeForGC(reg_t value);
+
+	/** The incremental collection in progress, or NULL if there is none */
+	IncrementalGC *_incrementalGC;
+
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
 	Common::HashMap<int, SegmentId> _scriptSegMap;
 
+	typedef Common::HashMap<SelectorLookupKey, SelectorLookupResult, SelectorLookupKey_Hash> SelectorLookupCache;
+	SelectorLookupCache _selectorLookupCache;
+	bool _selectorLookupCacheEnabled;
+	uint32 _selectorLookupHits;
+	uint32 _selectorLookupMisses;
+
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
 
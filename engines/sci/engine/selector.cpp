@@ -285,6 +285,7 @@ void writeSelector(SegManager *segMan, reg_t object, Selector selectorId, reg_t
 	}
 
 	*address.getPointer(segMan) = value;
+	segMan->writeBarrier(value);
 #ifdef ENABLE_SCI32
 	updateInfoFlagViewVisible(segMan->getObject(object), address.varindex);
 #endif
@@ -336,31 +337,45 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x", PRINT_REG(obj_location));
 	}
 
-	int index = obj->locateVarSelector(segMan, selectorId);
+	const reg_t objPos = obj->getPos();
+	SelectorLookupResult result;
+
+	if (!segMan->getCachedSelectorLookup(objPos, selectorId, result)) {
+		result.type = kSelectorNone;
+		result.varIndex = obj->locateVarSelector(segMan, selectorId);
+		result.func = NULL_REG;
+
+		if (result.varIndex >= 0) {
+			// Found it as a variable
+			result.type = kSelectorVariable;
+		} else {
+			// Check if it's a method, with recursive lookup in superclasses
+			while (obj) {
+				int index = obj->funcSelectorPosition(selectorId);
+				if (index >= 0) {
+					result.type = kSelectorMethod;
+					result.func = obj->getFunction(index);
+					break;
+				} else {
+					obj = segMan->getObject(obj->getSuperClassSelector());
+				}
+			}
+		}
+
+		segMan->cacheSelectorLookup(objPos, selectorId, result);
+	}
 
-	if (index >= 0) {
-		// Found it as a variable
+	if (result.type == kSelectorVariable) {
 		if (varp) {
 			varp->obj = obj_location;
-			varp->varindex = index;
+			varp->varindex = result.varIndex;
 		}
-		return kSelectorVariable;
-	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
-			}
-		}
-
-		return kSelectorNone;
+	} else if (result.type == kSelectorMethod) {
+		if (fptr)
+			*fptr = result.func;
 	}
+
+	return result.type;
 }
 
 } // End of namespace Sci
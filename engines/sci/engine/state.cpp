@@ -24,6 +24,7 @@
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/features.h"
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
@@ -68,14 +69,22 @@ static const uint16 s_halfWidthSJISMap[256] = {
 
 EngineState::EngineState(SegManager *segMan) :
 	_segMan(segMan),
+	_incrementalGC(new IncrementalGC()),
 	_msgState(nullptr),
 	_dirseeker() {
 
+	// The globals are set up once script 0 is loaded, see initGlobals()
+	memset(variables, 0, sizeof(variables));
+
 	reset(false);
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _incrementalGC;
+
+	for (Common::List<VisibilityGraph *>::iterator it = _visibilityGraphs.begin(); it != _visibilityGraphs.end(); ++it)
+		delete *it;
 }
 
 void EngineState::reset(bool isRestoring) {
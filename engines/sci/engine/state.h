@@ -44,6 +44,7 @@ namespace Sci {
 
 class FileHandle;
 class DirSeeker;
+class IncrementalGC;
 class EventManager;
 class MessageState;
 class SoundCommandParser;
@@ -97,6 +98,24 @@ struct SciCallOrigin {
 	}
 };
 
+/**
+ * Visibility between the vertices of a polygon set passed to kAvoidPath.
+ * Rooms pass the same obstacles on every call, so each pair of obstacle
+ * vertices only needs to be tested for intersections once.
+ */
+struct VisibilityGraph {
+	enum {
+		kPairUnknown = 0,
+		kPairBlocked = 1,
+		kPairVisible = 2
+	};
+
+	uint32 hash;
+	Common::Array<int16> key; ///< Vertex count and coordinates of each polygon
+	uint vertexCount;
+	Common::Array<byte> pairs; ///< vertexCount * vertexCount pair states, lower index first
+};
+
 struct EngineState : public Common::Serializable {
 	EngineState(SegManager *segMan);
 	~EngineState() override;
@@ -142,6 +161,8 @@ struct EngineState : public Common::Serializable {
 	Common::Point _cursorWorkaroundPoint;
 	Common::Rect _cursorWorkaroundRect;
 
+	Common::List<VisibilityGraph *> _visibilityGraphs; ///< Most recently used kAvoidPath visibility graphs, see kpathing.cpp
+
 	/* VM Information */
 
 	Common::List<ExecStack> _executionStack; /**< The execution stack */
@@ -188,6 +209,7 @@ struct EngineState : public Common::Serializable {
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	IncrementalGC *_incrementalGC; /**< Incremental collector state and gc statistics */
 
 	MessageState *_msgState;
 	void initMessageState();
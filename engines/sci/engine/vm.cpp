@@ -174,6 +174,7 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 			value.setSegment(0);
 
 		s->variables[type][index] = value;
+		s->_segMan->writeBarrier(value);
 
 		g_sci->_guestAdditions->writeVarHook(type, index, value);
 	}
@@ -223,6 +224,7 @@ static void _exec_varselectors(EngineState *s) {
 			// varselector access?
 			if (xs.argc) { // write?
 				*var = xs.variables_argp[1];
+				s->_segMan->writeBarrier(*var);
 
 #ifdef ENABLE_SCI32
 				updateInfoFlagViewVisible(s->_segMan->getObject(xs.addr.varp.obj), xs.addr.varp.varindex);
@@ -853,8 +855,14 @@ void run_vm(EngineState *s) {
 		case op_callk: { // 0x21 (33)
 			// Run the garbage collector, if needed
 			if (s->gcCountDown-- <= 0) {
-				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				if (s->_incrementalGC->isEnabled()) {
+					// Spread the collection over several kernel calls
+					s->_incrementalGC->step(s);
+					s->gcCountDown = s->_incrementalGC->isRunning() ? GC_STEP_INTERVAL : s->scriptGCInterval;
+				} else {
+					s->gcCountDown = s->scriptGCInterval;
+					run_gc(s);
+				}
 			}
 
 			// Call kernel function
@@ -935,6 +943,7 @@ void run_vm(EngineState *s) {
 					reg_t *var = old_xs->getVarPointer(s->_segMan);
 					if (old_xs->argc) { // write?
 						*var = old_xs->variables_argp[1];
+						s->_segMan->writeBarrier(*var);
 
 #ifdef ENABLE_SCI32
 						updateInfoFlagViewVisible(s->_segMan->getObject(old_xs->addr.varp.obj), old_xs->addr.varp.varindex);
@@ -1121,6 +1130,7 @@ void run_vm(EngineState *s) {
 			}
 
 			opProperty = s->r_acc;
+			s->_segMan->writeBarrier(opProperty);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1151,6 +1161,7 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORWRITE);
 			}
 			opProperty = newValue;
+			s->_segMan->writeBarrier(newValue);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
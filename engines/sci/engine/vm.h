@@ -61,6 +61,33 @@ struct Class {
 	reg_t reg; ///< offset; script-relative offset, segment: 0 if not instantiated
 };
 
+/**
+ * Key of the selector lookup cache. Clones share the position of the object
+ * they were cloned from, and have the same variable and method layout, so a
+ * cached lookup applies to all of them.
+ */
+struct SelectorLookupKey {
+	reg_t objPos;
+	Selector selector;
+
+	bool operator==(const SelectorLookupKey &other) const {
+		return objPos == other.objPos && selector == other.selector;
+	}
+};
+
+struct SelectorLookupKey_Hash {
+	uint operator()(const SelectorLookupKey &x) const {
+		return (x.objPos.getSegment() << 3) ^ x.objPos.getOffset() ^ ((uint)x.selector << 16) ^ (uint)x.selector;
+	}
+};
+
+/** A cached result of lookupSelector() */
+struct SelectorLookupResult {
+	SelectorType type;
+	int varIndex; ///< index of the variable, for kSelectorVariable
+	reg_t func; ///< address of the method, for kSelectorMethod
+};
+
 // A reference to an object's variable.
 // The object is stored as a reg_t, the variable as an index into _variables
 struct ObjVarRef {
@@ -190,7 +217,8 @@ enum GlobalVar {
 
 /** Number of kernel calls in between gcs; should be < 50000 */
 enum {
-	GC_INTERVAL = 0x8000
+	GC_INTERVAL = 0x8000,
+	GC_STEP_INTERVAL = 0x100 ///< Kernel calls in between incremental gc steps
 };
 
 enum SciOpcodes {
@@ -33,6 +33,7 @@
 #include "graphics/larryScale.h"
 #include "common/config-manager.h"
 #include "common/gui_options.h"
+#include "common/system.h"
 
 namespace Sci {
 #pragma mark CelScaler
@@ -81,13 +82,28 @@ const CelScalerTable &CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 	return _scaleTables[_activeIndex];
 }
 
+static void drawCelSkipRow(byte *target, const byte *source, const int16 width, const uint8 skipColor) {
+	for (int16 x = 0; x < width; ++x) {
+		if (source[x] != skipColor) {
+			target[x] = source[x];
+		}
+	}
+}
+
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
+CelSkipRowProc CelObj::_drawSkipRow = drawCelSkipRow;
 
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
+	_drawSkipRow = drawCelSkipRow;
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		_drawSkipRow = drawCelSkipRowSSE2;
+	}
+#endif
 	_nextCacheId = 1;
 	_scaler = new CelScaler();
 	_cache = new CelCache(100);
@@ -154,6 +170,27 @@ struct SCALER_NoScale {
 			return *_row++;
 		}
 	}
+
+	/**
+	 * Reads the next `width` pixels of the current row. Unflipped rows are
+	 * returned directly from the source; otherwise the pixels are copied into
+	 * `buffer`.
+	 */
+	inline const byte *readRow(byte *buffer, const int16 width) {
+		if (FLIP) {
+			for (int16 x = 0; x < width; ++x) {
+				buffer[x] = read();
+			}
+			return buffer;
+		} else {
+#ifndef RELEASE_BUILD
+			assert(_row + width <= _rowEdge);
+#endif
+			const byte *row = _row;
+			_row += width;
+			return row;
+		}
+	}
 };
 
 template<bool FLIP, typename READER>
@@ -314,6 +351,21 @@ struct SCALER_Scale {
 #endif
 		return _row[_valuesX[_x++]];
 	}
+
+	/**
+	 * Reads the next `width` pixels of the current row into `buffer`.
+	 */
+	inline const byte *readRow(byte *buffer, const int16 width) {
+#ifndef RELEASE_BUILD
+		assert(_x + width - 1 <= _maxX);
+#endif
+		const int16 *valuesX = _valuesX + _x;
+		for (int16 x = 0; x < width; ++x) {
+			buffer[x] = _row[valuesX[x]];
+		}
+		_x += width;
+		return buffer;
+	}
 };
 
 template<bool FLIP, typename READER>
@@ -449,6 +501,17 @@ public:
 #pragma mark -
 #pragma mark CelObj - Remappers
 
+/**
+ * How a mapper can draw an entire row at once. Rows are only drawn at once
+ * when the cel isn't from a Mac source, as those need their colors
+ * translated.
+ */
+enum MapperRowMode {
+	kMapperRowNone, ///< Every pixel must be drawn through the mapper
+	kMapperRowSkip, ///< Rows are copied, except for skip color pixels
+	kMapperRowCopy  ///< Rows are copied unchanged
+};
+
 /**
  * Translation for pixels from Mac pic and view cels to the PC palette.
  * The Mac OS palette required 0 to be white and 255 to be black, which is the
@@ -475,6 +538,8 @@ inline byte translateMacColor(bool isMacSource, byte color) {
  * remapping data.
  */
 struct MAPPER_NoMD {
+	static const MapperRowMode kRowMode = kMapperRowSkip;
+
 	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
 		if (pixel != skipColor) {
 			*target = translateMacColor(isMacSource, pixel);
@@ -487,6 +552,8 @@ struct MAPPER_NoMD {
  * no remapping data.
  */
 struct MAPPER_NoMDNoSkip {
+	static const MapperRowMode kRowMode = kMapperRowCopy;
+
 	inline void draw(byte *target, const byte pixel, const uint8, const bool isMacSource) const {
 		*target = translateMacColor(isMacSource, pixel);
 	}
@@ -497,6 +564,8 @@ struct MAPPER_NoMDNoSkip {
  * remapping data, and remapping enabled.
  */
 struct MAPPER_Map {
+	static const MapperRowMode kRowMode = kMapperRowNone;
+
 	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
 		if (pixel != skipColor) {
 			// For some reason, SSCI never checks if the source pixel is *above*
@@ -515,6 +584,8 @@ struct MAPPER_Map {
  * remapping data, and remapping disabled.
  */
 struct MAPPER_NoMap {
+	static const MapperRowMode kRowMode = kMapperRowNone;
+
 	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
 		// For some reason, SSCI never checks if the source pixel is *above* the
 		// range of remaps, so we do not either.
@@ -742,18 +813,26 @@ void CelObj::putCopyInCache(const int cacheIndex) const {
 #pragma mark -
 #pragma mark CelObj - Drawing
 
+/**
+ * Scratch row used when a scaler can't return pixels directly from the
+ * source.
+ */
+static byte rendererRowBuffer[kCelScalerTableSize];
+
 template<typename MAPPER, typename SCALER, bool DRAW_BLACK_LINES>
 struct RENDERER {
 	MAPPER &_mapper;
 	SCALER &_scaler;
 	const uint8 _skipColor;
 	const bool _isMacSource;
+	byte *const _rowBuffer;
 
 	RENDERER(MAPPER &mapper, SCALER &scaler, const uint8 skipColor, const bool isMacSource) :
 	_mapper(mapper),
 	_scaler(scaler),
 	_skipColor(skipColor),
-	_isMacSource(isMacSource) {}
+	_isMacSource(isMacSource),
+	_rowBuffer(rendererRowBuffer) {}
 
 	inline void draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
 		byte *targetPixel = (byte *)target.getPixels() + target.w * targetRect.top + targetRect.left;
@@ -761,6 +840,8 @@ struct RENDERER {
 		const int16 skipStride = target.w - targetRect.width();
 		const int16 targetWidth = targetRect.width();
 		const int16 targetHeight = targetRect.height();
+		const bool drawRows = MAPPER::kRowMode != kMapperRowNone && !_isMacSource;
+		assert(targetWidth <= kCelScalerTableSize);
 		for (int16 y = 0; y < targetHeight; ++y) {
 			if (DRAW_BLACK_LINES && (y % 2) == 0) {
 				memset(targetPixel, 0, targetWidth);
@@ -770,8 +851,18 @@ struct RENDERER {
 
 			_scaler.setTarget(targetRect.left, targetRect.top + y);
 
-			for (int16 x = 0; x < targetWidth; ++x) {
-				_mapper.draw(targetPixel++, _scaler.read(), _skipColor, _isMacSource);
+			if (drawRows) {
+				const byte *source = _scaler.readRow(_rowBuffer, targetWidth);
+				if (MAPPER::kRowMode == kMapperRowCopy) {
+					memcpy(targetPixel, source, targetWidth);
+				} else {
+					CelObj::_drawSkipRow(targetPixel, source, targetWidth, _skipColor);
+				}
+				targetPixel += targetWidth;
+			} else {
+				for (int16 x = 0; x < targetWidth; ++x) {
+					_mapper.draw(targetPixel++, _scaler.read(), _skipColor, _isMacSource);
+				}
 			}
 
 			targetPixel += skipStride;
@@ -234,6 +234,16 @@ public:
 #pragma mark -
 #pragma mark CelObj
 
+/**
+ * Copies a row of cel pixels to a target buffer, leaving the target pixels
+ * where the cel has its skip color untouched.
+ */
+typedef void (*CelSkipRowProc)(byte *target, const byte *source, const int16 width, const uint8 skipColor);
+
+#ifdef SCUMMVM_SSE2
+void drawCelSkipRowSSE2(byte *target, const byte *source, const int16 width, const uint8 skipColor);
+#endif
+
 class ScreenItem;
 /**
  * A cel object is the lowest-level rendering primitive in the SCI engine and
@@ -262,6 +272,12 @@ protected:
 public:
 	static CelScaler *_scaler;
 
+	/**
+	 * The row copier used to draw transparent cels without remapping, chosen
+	 * in `init` based on the CPU features of the host.
+	 */
+	static CelSkipRowProc _drawSkipRow;
+
 	/**
 	 * The basic identifying information for this cel. This information
 	 * effectively acts as a composite key for a cel object, and any cel object
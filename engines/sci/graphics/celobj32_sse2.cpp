@@ -0,0 +1,65 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sci/graphics/celobj32.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Sci {
+
+void drawCelSkipRowSSE2(byte *target, const byte *source, const int16 width, const uint8 skipColor) {
+	const __m128i skip = _mm_set1_epi8((char)skipColor);
+
+	int16 x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(source + x));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(target + x));
+		const __m128i mask = _mm_cmpeq_epi8(src, skip);
+		_mm_storeu_si128((__m128i *)(target + x), _mm_or_si128(_mm_and_si128(mask, dst), _mm_andnot_si128(mask, src)));
+	}
+
+	for (; x < width; ++x) {
+		if (source[x] != skipColor) {
+			target[x] = source[x];
+		}
+	}
+}
+
+} // End of namespace Sci
+
+#if !defined(__x86_64__)
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif // !defined(__x86_64__)
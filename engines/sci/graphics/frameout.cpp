@@ -1465,6 +1465,20 @@ void GfxFrameout::printVisiblePlaneList(Console *con) const {
 	printPlaneListInternal(con, _visiblePlanes);
 }
 
+uint32 GfxFrameout::benchmarkFrameOut(const int frameCount) {
+	const uint32 startTime = g_system->getMillis();
+
+	for (int i = 0; i < frameCount; ++i) {
+		for (PlaneList::iterator plane = _planes.begin(); plane != _planes.end(); ++plane) {
+			(*plane)->_redrawAllCount = getScreenCount();
+		}
+
+		frameOut(false);
+	}
+
+	return g_system->getMillis() - startTime;
+}
+
 void GfxFrameout::printPlaneItemListInternal(Console *con, const ScreenItemList &screenItemList) const {
 	ScreenItemList::size_type i = 0;
 	for (ScreenItemList::const_iterator sit = screenItemList.begin(); sit != screenItemList.end(); sit++) {
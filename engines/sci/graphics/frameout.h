@@ -442,6 +442,14 @@ public:
 	void printPlaneItemList(Console *con, const reg_t planeObject) const;
 	void printVisiblePlaneItemList(Console *con, const reg_t planeObject) const;
 	void printPlaneItemListInternal(Console *con, const ScreenItemList &screenItemList) const;
+
+	/**
+	 * Redraws every screen item of every plane `frameCount` times without
+	 * sending the result to hardware.
+	 *
+	 * @returns the time taken, in milliseconds.
+	 */
+	uint32 benchmarkFrameOut(const int frameCount);
 };
 
 } // End of namespace Sci
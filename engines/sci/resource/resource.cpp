@@ -25,6 +25,7 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
@@ -1002,13 +1003,16 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager(const bool detectionMode) :
-	_detectionMode(detectionMode) {}
+	_detectionMode(detectionMode), _prefetchEnabled(false) {}
 
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	_cacheStats.reset();
+	_prefetchEnabled = false;
+	_prefetchQueue.clear();
 	_resMap.clear();
 	_audioMapSCI1 = nullptr;
 #ifdef ENABLE_SCI32
@@ -1154,12 +1158,74 @@ void ResourceManager::freeOldResources() {
 		Resource *goner = _LRU.back();
 		removeFromLRU(goner);
 		goner->unalloc();
+		_cacheStats.evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
 	}
 }
 
+void ResourceManager::setMaxMemory(int bytes) {
+	_maxMemoryLRU = bytes;
+	freeOldResources();
+}
+
+void ResourceManager::loadCachedResource(Resource *res) {
+	const uint32 startTime = g_system->getMillis();
+	loadResource(res);
+	_cacheStats.loadTime += g_system->getMillis() - startTime;
+	_cacheStats.bytesLoaded += res->size();
+}
+
+void ResourceManager::setPrefetchEnabled(bool enabled) {
+	_prefetchEnabled = enabled;
+	if (!enabled)
+		_prefetchQueue.clear();
+}
+
+void ResourceManager::prefetchRoom(uint16 roomNumber) {
+	if (!_prefetchEnabled)
+		return;
+
+	prefetchResource(ResourceId(kResourceTypePic, roomNumber));
+	prefetchResource(ResourceId(kResourceTypeView, roomNumber));
+}
+
+void ResourceManager::prefetchResource(const ResourceId &id) {
+	Resource *res = testResource(id);
+
+	if (!res || res->_status != kResStatusNoMalloc)
+		return;
+
+	for (Common::List<ResourceId>::const_iterator it = _prefetchQueue.begin(); it != _prefetchQueue.end(); ++it) {
+		if (*it == id)
+			return;
+	}
+
+	_prefetchQueue.push_back(id);
+}
+
+void ResourceManager::processPrefetchQueue(uint32 deadline) {
+	// Leave room in the cache for the resources the game actually requests,
+	// prefetched ones are only a guess
+	while (!_prefetchQueue.empty() && _memoryLRU < _maxMemoryLRU / 4 * 3 && g_system->getMillis() < deadline) {
+		Resource *res = testResource(_prefetchQueue.front());
+		_prefetchQueue.pop_front();
+
+		// The game may have requested it in the meantime
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		loadCachedResource(res);
+		if (res->_status != kResStatusAllocated)
+			continue;
+
+		_cacheStats.prefetched++;
+		addToLRU(res);
+		freeOldResources();
+	}
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1196,9 +1262,14 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return nullptr;
 
-	if (retval->_status == kResStatusNoMalloc)
-		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheStats.misses++;
+		loadCachedResource(retval);
+	} else {
+		_cacheStats.hits++;
+	}
+
+	if (retval->_status == kResStatusEnqueued)
 		// The resource is removed from its current position
 		// in the LRU list because it has been requested
 		// again. Below, it will either be locked, or it
@@ -324,6 +324,25 @@ protected:
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
 class IntMapResourceSource;
+/**
+ * Statistics about the resource cache of the ResourceManager.
+ */
+struct ResourceCacheStatistics {
+	uint32 hits;		///< Lookups of resources that were already in memory
+	uint32 misses;		///< Lookups that had to read the resource from disk
+	uint32 evictions;	///< Resources freed to stay within the memory budget
+	uint32 prefetched;	///< Resources read ahead of time by the prefetcher
+	uint32 loadTime;	///< Total time in ms spent reading and decompressing resources
+	uint64 bytesLoaded;	///< Total uncompressed size of all resources read
+
+	ResourceCacheStatistics() { reset(); }
+
+	void reset() {
+		hits = misses = evictions = prefetched = loadTime = 0;
+		bytesLoaded = 0;
+	}
+};
+
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
 	// ease transition to the ResourceSource class system.
@@ -380,6 +399,52 @@ public:
 	 */
 	void unlockResource(Resource *res);
 
+	enum {
+		kMaxCacheSize = 1024 ///< Largest budget in MiB, so that it fits an int in bytes
+	};
+
+	/**
+	 * Sets the amount of memory unlocked resources may use before the least
+	 * recently used ones are freed.
+	 * @param bytes	The new budget in bytes
+	 */
+	void setMaxMemory(int bytes);
+	int getMaxMemory() const { return _maxMemoryLRU; }
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMemoryLocked() const { return _memoryLocked; }
+	uint getLRUSize() const { return _LRU.size(); }
+
+	/**
+	 * Enables reading resources which are likely to be needed soon while the
+	 * game is idle, see prefetchRoom().
+	 */
+	void setPrefetchEnabled(bool enabled);
+	bool isPrefetchEnabled() const { return _prefetchEnabled; }
+
+	/**
+	 * Queues the picture and view with the number of a room whose script
+	 * is being loaded, following Sierra's numbering convention. Does nothing
+	 * unless prefetching is enabled.
+	 * @param roomNumber	The number of the room script
+	 */
+	void prefetchRoom(uint16 roomNumber);
+
+	/**
+	 * Queues a resource to be read ahead of time.
+	 * @param id	The resource to read
+	 */
+	void prefetchResource(const ResourceId &id);
+
+	/**
+	 * Reads queued resources into the cache until the given time has passed
+	 * or the cache is mostly full.
+	 * @param deadline	Time (as returned by getMillis) to stop at
+	 */
+	void processPrefetchQueue(uint32 deadline);
+
+	const ResourceCacheStatistics &getCacheStatistics() const { return _cacheStats; }
+	void resetCacheStatistics() { _cacheStats.reset(); }
+
 	/**
 	 * Tests whether a resource exists.
 	 *
@@ -502,6 +567,9 @@ protected:
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	ResourceCacheStatistics _cacheStats;
+	bool _prefetchEnabled;
+	Common::List<ResourceId> _prefetchQueue; ///< Resources to read while the game is idle
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -647,6 +715,11 @@ protected:
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
 
+	/**
+	 * Reads a resource from its source and updates the cache statistics.
+	 */
+	void loadCachedResource(Resource *res);
+
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
 	bool hasSci0Voc999();
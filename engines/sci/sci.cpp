@@ -33,6 +33,7 @@
 #include "sci/event.h"
 
 #include "sci/engine/features.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/message.h"
 #include "sci/engine/object.h"
@@ -274,6 +275,12 @@ Common::Error SciEngine::run() {
 	_resMan->addAppropriateSources();
 	_resMan->init();
 
+	// Resource cache budget in MiB, 0 keeps the default for the SCI version
+	const int resourceCacheSize = ConfMan.getInt("resource_cache_size");
+	if (resourceCacheSize > 0)
+		_resMan->setMaxMemory(MIN<int>(resourceCacheSize, ResourceManager::kMaxCacheSize) * 1024 * 1024);
+	_resMan->setPrefetchEnabled(ConfMan.getBool("resource_prefetch"));
+
 	// TODO: Add error handling. Check return values of addAppropriateSources
 	// and init. We first have to *add* sensible return values, though ;).
 /*
@@ -337,6 +344,7 @@ Common::Error SciEngine::run() {
 	_vocabulary = hasParser() ? new Vocabulary(_resMan, false) : nullptr;
 
 	_gamestate = new EngineState(segMan);
+	_gamestate->_incrementalGC->setEnabled(ConfMan.getBool("incremental_gc"));
 	_guestAdditions = new GuestAdditions(_gamestate, _features, _kernel);
 	_eventMan = new EventManager(_resMan->detectFontExtended());
 #ifdef ENABLE_SCI32
@@ -977,6 +985,10 @@ void SciEngine::sleep(uint32 msecs) {
 
 	const uint32 wakeUpTime = _system->getMillis() + msecs;
 
+	// Use the time the game would spend waiting to read resources ahead
+	if (_resMan->isPrefetchEnabled())
+		_resMan->processPrefetchQueue(wakeUpTime);
+
 	for (;;) {
 		// let backend process events and update the screen
 		_eventMan->getSciEvent(kSciEventPeek);
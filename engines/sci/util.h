@@ -132,7 +132,7 @@ class SciSpanImpl : public Common::NamedSpanImpl<ValueType, Derived> {
 	typedef Derived<ValueType> derived_type;
 
 	template <typename T, template <typename> class U> friend class SciSpanImpl;
-#if defined(CXXTEST_RUNNING) && CXXTEST_RUNNING
+#ifdef CXXTEST_RUNNING
 	friend class ::SpanTestSuite;
 #endif
 
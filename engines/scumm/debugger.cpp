@@ -39,6 +39,8 @@
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 void debugC(int channel, const char *s, ...) {
 	char buf[STRINGBUFLEN];
 	va_list va;
@@ -111,6 +113,8 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 #endif
 
 	registerCmd("resetcursors",    WRAP_METHOD(ScummDebugger, Cmd_ResetCursors));
+	registerCmd("stripcache",      WRAP_METHOD(ScummDebugger, Cmd_StripCache));
+	registerCmd("heap",            WRAP_METHOD(ScummDebugger, Cmd_Heap));
 }
 
 void ScummDebugger::preEnter() {
@@ -1414,4 +1418,66 @@ bool ScummDebugger::Cmd_ResetCursors(int argc, const char **argv) {
 	return false;
 }
 
+bool ScummDebugger::Cmd_StripCache(int argc, const char **argv) {
+	Gdi *gdi = _vm->_gdi;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			gdi->setStripCacheEnabled(true);
+		} else if (!strcmp(argv[1], "off")) {
+			gdi->setStripCacheEnabled(false);
+		} else if (!strcmp(argv[1], "flush")) {
+			gdi->flushStripCache();
+		} else if (!strcmp(argv[1], "reset")) {
+			gdi->resetStripCacheStatistics();
+		} else {
+			debugPrintf("Usage: %s [on | off | flush | reset]\n", argv[0]);
+			return true;
+		}
+	}
+
+	const Gdi::StripCacheStatistics &stats = gdi->getStripCacheStatistics();
+	const uint32 lookups = stats.hits + stats.misses;
+
+	debugPrintf("Room strip cache: %s\n", gdi->isStripCacheEnabled() ? "enabled" : "disabled");
+	debugPrintf("Memory: %u of %u KB\n", gdi->getStripCacheMemory() / 1024, STRIP_CACHE_MEMORY_SIZE / 1024);
+	debugPrintf("Hits: %u, misses: %u (%u%% hit rate)\n", stats.hits, stats.misses,
+				lookups ? stats.hits * 100 / lookups : 0);
+	debugPrintf("Uncacheable strips: %u, flushes: %u\n", stats.rejected, stats.flushes);
+	return true;
+}
+
+bool ScummDebugger::Cmd_Heap(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+	ResourceEvictionPolicy policy;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			res->resetStatistics();
+		} else if (!strcmp(argv[1], "policy") && argc > 2 && ResourceManager::parseEvictionPolicy(argv[2], policy)) {
+			res->setEvictionPolicy(policy);
+		} else if (!strcmp(argv[1], "size") && argc > 2 && atoi(argv[2]) > 0) {
+			res->setHeapSize(atoi(argv[2]));
+		} else {
+			debugPrintf("Usage: %s [reset | policy <oldest | cost | frequency> | size <KB>]\n", argv[0]);
+			return true;
+		}
+	}
+
+	const ResourceStatistics &stats = res->getStatistics();
+
+	debugPrintf("Heap: %u KB allocated, expiring from %u KB down to %u KB\n", res->getHeapSize() / 1024,
+				res->getMaxHeapThreshold() / 1024, res->getMinHeapThreshold() / 1024);
+	debugPrintf("Eviction policy: %s\n", ResourceManager::getEvictionPolicyName(res->getEvictionPolicy()));
+	debugPrintf("Loads: %u (%u KB)\n", stats.loads, stats.bytesLoaded / 1024);
+	debugPrintf("Evictions: %u (%u KB)\n", stats.evictions, stats.bytesEvicted / 1024);
+	debugPrintf("Reloads: %u (%u KB)\n", stats.reloads, stats.bytesReloaded / 1024);
+
+	for (int type = rtFirst; type <= rtLast; type++) {
+		if (stats.typeReloads[type])
+			debugPrintf("  %-12s %u\n", nameOfResType((ResType)type), stats.typeReloads[type]);
+	}
+	return true;
+}
+
 } // End of namespace Scumm
@@ -216,22 +216,37 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+
+	_stripCacheSupported = true;
+	_stripCacheEnabled = true;
+	_stripCache.roomImage = nullptr;
+	_stripCache.room = 0;
+	_stripCache.height = 0;
+	_stripCache.numZBuffer = 0;
+	memset(_stripCache.palette, 0, sizeof(_stripCache.palette));
+	_stripCache.memoryUsed = 0;
+	_stripCacheStats.reset();
 }
 
 Gdi::~Gdi() {
+	flushStripCache();
 }
 
 GdiHE::GdiHE(ScummEngine *vm) : Gdi(vm), _tmskPtr(nullptr) {
+	// HE games draw transparency masks (TMSK) along with the strips
+	_stripCacheSupported = false;
 }
 
 
 GdiNES::GdiNES(ScummEngine *vm) : Gdi(vm) {
 	memset(&_NES, 0, sizeof(_NES));
+	_stripCacheSupported = false;
 }
 
 #ifdef USE_RGB_COLOR
 GdiPCEngine::GdiPCEngine(ScummEngine *vm) : Gdi(vm) {
 	memset(&_PCE, 0, sizeof(_PCE));
+	_stripCacheSupported = false;
 }
 
 GdiPCEngine::~GdiPCEngine() {
@@ -243,6 +258,7 @@ GdiPCEngine::~GdiPCEngine() {
 
 GdiV1::GdiV1(ScummEngine *vm) : Gdi(vm) {
 	memset(&_V1, 0, sizeof(_V1));
+	_stripCacheSupported = false;
 }
 
 void GdiV1::setRenderModeColorMap(const byte *map) {
@@ -256,6 +272,7 @@ byte GdiV1::remapColorToRenderMode(byte col) const {
 
 GdiV2::GdiV2(ScummEngine *vm) : Gdi(vm) {
 	_roomStrips = nullptr;
+	_stripCacheSupported = false;
 }
 
 GdiV2::~GdiV2() {
@@ -285,6 +302,7 @@ void Gdi::init() {
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	flushStripCache();
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -1178,7 +1196,7 @@ void ScummEngine::redrawBGStrip(int start, int num) {
 	else
 		room = getResourceAddress(rtRoom, _roomResource);
 
-	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, 0);
+	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, Gdi::dbRoomBackground);
 }
 
 void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
@@ -2347,6 +2365,8 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 
 	numzbuf = getZPlanes(ptr, zplane_list, false);
 
+	const bool useStripCache = (flag & dbRoomBackground) && validateStripCache(ptr, vs, y, height, numzbuf);
+
 	if (y + height > vs->h) {
 		warning("Gdi::drawBitmap, strip drawn to %d below window bottom %d", y + height, vs->h);
 	}
@@ -2395,7 +2415,18 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		else
 			dstPtr = (byte *)vs->getBasePtr(x * 8, y);
 
-		transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+		const byte *cachedStrip = useStripCache ? getCachedStrip(stripnr) : nullptr;
+		if (cachedStrip) {
+			_stripCacheStats.hits++;
+			restoreCachedStrip(cachedStrip, dstPtr, vs->pitch, x, y, height, numzbuf, zplane_list);
+			transpStrip = false;
+		} else {
+			transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+		}
+
+		// Only strips which overwrite every pixel can be cached, transparent
+		// ones depend on what was drawn below them.
+		const bool storeStrip = useStripCache && !cachedStrip && !transpStrip;
 
 		// COMI and HE games only uses flag value
 		if (_vm->_game.version == 8 || _vm->_game.heversion >= 60)
@@ -2409,7 +2440,15 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 				clear8Col(frontBuf, vs->pitch, height, vs->format.bytesPerPixel);
 		}
 
-		decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
+		if (!cachedStrip)
+			decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
+
+		if (storeStrip)
+			storeCachedStrip(stripnr, dstPtr, vs->pitch, x, y, height, numzbuf, zplane_list);
+		else if (useStripCache && !cachedStrip) {
+			_stripCacheStats.misses++;
+			_stripCacheStats.rejected++;
+		}
 
 #if 0
 		// HACK: blit mask(s) onto normal screen. Useful to debug masking
@@ -2930,6 +2969,117 @@ void ScummEngine_v70he::backgroundToForegroundBlit(Common::Rect rect, int dirtyb
 }
 #endif
 
+/**
+ * Drop all decoded strips, e.g. when the room image or its palette changes.
+ */
+void Gdi::flushStripCache() {
+	for (uint i = 0; i < _stripCache.strips.size(); i++)
+		free(_stripCache.strips[i]);
+
+	if (_stripCache.memoryUsed)
+		_stripCacheStats.flushes++;
+
+	_stripCache.strips.clear();
+	_stripCache.memoryUsed = 0;
+	_stripCache.roomImage = nullptr;
+}
+
+void Gdi::setStripCacheEnabled(bool enabled) {
+	_stripCacheEnabled = enabled;
+	if (!enabled)
+		flushStripCache();
+}
+
+bool Gdi::validateStripCache(const byte *ptr, VirtScreen *vs, int y, int height, int numzbuf) {
+	if (!_stripCacheEnabled || !_stripCacheSupported)
+		return false;
+
+	if (vs->number != kMainVirtScreen || vs->format.bytesPerPixel != 1 || y != 0)
+		return false;
+
+	// The decoded pixels go through the room palette, so compare it along
+	// with the image itself; scripts may remap room colors at any time.
+	if (ptr != _stripCache.roomImage || _vm->_roomResource != _stripCache.room ||
+		height != _stripCache.height || numzbuf != _stripCache.numZBuffer ||
+		memcmp(_stripCache.palette, _vm->_roomPalette, sizeof(_stripCache.palette))) {
+		flushStripCache();
+
+		_stripCache.roomImage = ptr;
+		_stripCache.room = _vm->_roomResource;
+		_stripCache.height = height;
+		_stripCache.numZBuffer = numzbuf;
+		memcpy(_stripCache.palette, _vm->_roomPalette, sizeof(_stripCache.palette));
+	}
+
+	return true;
+}
+
+const byte *Gdi::getCachedStrip(int stripnr) const {
+	if (stripnr < 0 || stripnr >= (int)_stripCache.strips.size())
+		return nullptr;
+
+	return _stripCache.strips[stripnr];
+}
+
+void Gdi::restoreCachedStrip(const byte *strip, byte *dstPtr, int dstPitch, int x, int y, int height,
+							 int numzbuf, const byte *zplane_list[9]) {
+	for (int h = 0; h < height; h++) {
+		memcpy(dstPtr, strip, 8);
+		dstPtr += dstPitch;
+		strip += 8;
+	}
+
+	// Z-plane 0 is never touched when drawing the room background, and
+	// missing planes are left alone just like decodeMask() does.
+	for (int i = 1; i < numzbuf; i++) {
+		if (zplane_list[i]) {
+			byte *mask_ptr = getMaskBuffer(x, y, i);
+			for (int h = 0; h < height; h++)
+				mask_ptr[h * _numStrips] = strip[h];
+		}
+		strip += height;
+	}
+}
+
+void Gdi::storeCachedStrip(int stripnr, const byte *dstPtr, int dstPitch, int x, int y, int height,
+						   int numzbuf, const byte *zplane_list[9]) {
+	const uint32 size = height * (8 + MAX(numzbuf - 1, 0));
+
+	_stripCacheStats.misses++;
+
+	if (_stripCache.memoryUsed + size > STRIP_CACHE_MEMORY_SIZE) {
+		_stripCacheStats.rejected++;
+		return;
+	}
+
+	byte *strip = (byte *)malloc(size);
+	if (!strip) {
+		_stripCacheStats.rejected++;
+		return;
+	}
+
+	if (stripnr >= (int)_stripCache.strips.size())
+		_stripCache.strips.resize(stripnr + 1);
+
+	_stripCache.strips[stripnr] = strip;
+	_stripCache.memoryUsed += size;
+
+	for (int h = 0; h < height; h++) {
+		memcpy(strip, dstPtr, 8);
+		dstPtr += dstPitch;
+		strip += 8;
+	}
+
+	for (int i = 1; i < numzbuf; i++) {
+		if (zplane_list[i]) {
+			const byte *mask_ptr = getMaskBuffer(x, y, i);
+			for (int h = 0; h < height; h++)
+				strip[h] = mask_ptr[h * _numStrips];
+		}
+		strip += height;
+	}
+}
+
 /**
  * Reset the background behind an actor or blast object.
  */
@@ -23,6 +23,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -286,6 +287,9 @@ struct ColorCycle {
 
 struct StripTable;
 
+/** Memory budget for decoded room background strips, see Gdi::drawBitmap */
+#define STRIP_CACHE_MEMORY_SIZE	(2 * 1024 * 1024)
+
 #define CHARSET_MASK_TRANSPARENCY	 0xFD
 #define CHARSET_MASK_TRANSPARENCY_32 0xFDFDFDFD
 
@@ -304,6 +308,47 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/** Flag which is true when the strip cache may be used by this renderer. */
+	bool _stripCacheSupported;
+
+public:
+	struct StripCacheStatistics {
+		uint32 hits;
+		uint32 misses;
+		uint32 rejected;
+		uint32 flushes;
+
+		void reset() { hits = misses = rejected = flushes = 0; }
+	};
+
+protected:
+	/**
+	 * Decoded room background strips, along with their z-plane masks. Camera
+	 * scrolls and dirty strips then only copy the cached data back instead of
+	 * decompressing the strip again. The cache is only valid for one room
+	 * image and room palette; any change to either flushes it.
+	 */
+	struct StripCache {
+		const byte *roomImage;
+		int room;
+		int height;
+		int numZBuffer;
+		byte palette[256];
+		uint32 memoryUsed;
+		Common::Array<byte *> strips;
+	};
+
+	StripCache _stripCache;
+	StripCacheStatistics _stripCacheStats;
+	bool _stripCacheEnabled;
+
+	bool validateStripCache(const byte *ptr, VirtScreen *vs, int y, int height, int numzbuf);
+	const byte *getCachedStrip(int stripnr) const;
+	void restoreCachedStrip(const byte *strip, byte *dstPtr, int dstPitch, int x, int y, int height,
+	                int numzbuf, const byte *zplane_list[9]);
+	void storeCachedStrip(int stripnr, const byte *dstPtr, int dstPitch, int x, int y, int height,
+	                int numzbuf, const byte *zplane_list[9]);
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -377,10 +422,18 @@ public:
 
 	void resetBackground(int top, int bottom, int strip);
 
+	void flushStripCache();
+	void setStripCacheEnabled(bool enabled);
+	bool isStripCacheEnabled() const { return _stripCacheEnabled && _stripCacheSupported; }
+	uint32 getStripCacheMemory() const { return _stripCache.memoryUsed; }
+	const StripCacheStatistics &getStripCacheStatistics() const { return _stripCacheStats; }
+	void resetStripCacheStatistics() { _stripCacheStats.reset(); }
+
 	enum DrawBitmapFlags {
-		dbAllowMaskOr   = 1 << 0,
-		dbDrawMaskOnAll = 1 << 1,
-		dbObjectMode    = 2 << 2
+		dbAllowMaskOr    = 1 << 0,
+		dbDrawMaskOnAll  = 1 << 1,
+		dbObjectMode     = 2 << 2,
+		dbRoomBackground = 1 << 4
 	};
 };
 
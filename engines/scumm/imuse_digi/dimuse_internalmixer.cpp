@@ -22,6 +22,7 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "common/serializer.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -49,6 +50,11 @@ IMuseDigiInternalMixer::IMuseDigiInternalMixer(Audio::Mixer *mixer, int sampleRa
 
 	_radioChatter = 0;
 	_amp8Table = nullptr;
+
+	_useSSE2 = false;
+#ifdef SCUMMVM_SSE2
+	_useSSE2 = g_system->hasFeature(OSystem::kFeatureCpuSSE2);
+#endif
 }
 
 IMuseDigiInternalMixer::~IMuseDigiInternalMixer() {
@@ -71,6 +77,37 @@ static const int8 _stereoVolumeTable[284] = {
 	14, 15, 15, 15, 0,  2,  3,  5,  6,  8,  9,  10, 11, 12, 13, 14, 15, 15, 16, 16, 16, 0,  0,  0
 };
 
+// The amplitude tables are linear: the entry for the sample x, centered on 0,
+// is trunc(x * scale / 127), so the entry for 127 is the scale itself
+static inline int ampTableScale(const int32 *ampTable, int zeroIndex) {
+	return ((const int16 *)ampTable)[zeroIndex + 127];
+}
+
+#ifdef SCUMMVM_SSE2
+// Unpacks 12-bit sample pairs into centered samples, one chunk at a time
+static void mixBits12SSE2(uint16 *mixBuf, const uint8 *srcBuf, int count, int leftScale, int rightScale, bool toStereo) {
+	int16 samples[512];
+
+	while (count > 0) {
+		const int chunk = MIN<int>(count, ARRAYSIZE(samples));
+		for (int i = 0; i < chunk; i += 2) {
+			samples[i] = (srcBuf[0] | ((srcBuf[1] & 0xF) << 8)) - 2048;
+			samples[i + 1] = (srcBuf[2] | ((srcBuf[1] & 0xF0) << 4)) - 2048;
+			srcBuf += 3;
+		}
+
+		if (toStereo) {
+			mixCenteredToStereoSSE2(mixBuf, samples, chunk, leftScale, rightScale);
+			mixBuf += 2 * chunk;
+		} else {
+			mixCenteredSSE2(mixBuf, samples, chunk, leftScale);
+			mixBuf += chunk;
+		}
+		count -= chunk;
+	}
+}
+#endif
+
 int IMuseDigiInternalMixer::init(int bytesPerSample, int numChannels, uint8 *mixBuf, int mixBufSize, int sizeSampleKB, int mixChannelsNum) {
 	int amplitudeValue;
 	int waveMixChannelsCount;
@@ -221,6 +258,12 @@ void IMuseDigiInternalMixer::mix(uint8 *srcBuf, int32 inFrameCount, int wordSize
 					// Linear volume quantization from the lookup table
 					rightChannelVolume = _stereoVolumeTable[17 * channelVolume + channelPan];
 					leftChannelVolume = _stereoVolumeTable[17 * channelVolume - channelPan];
+
+					// Amplitude table 0 is all zeroes: a track which is silent on both
+					// sides would leave the mixing buffer untouched, so skip it altogether.
+					if (leftChannelVolume == 0 && rightChannelVolume == 0)
+						return;
+
 					if (wordSize == 8) {
 						mixBits8ConvertToStereo(
 							srcBuf,
@@ -254,6 +297,10 @@ void IMuseDigiInternalMixer::mix(uint8 *srcBuf, int32 inFrameCount, int wordSize
 					if (channelVolume >= 17)
 						channelVolume = 16;
 
+					// See above: a zero volume track contributes nothing to the mix
+					if (channelVolume == 0)
+						return;
+
 					if (wordSize == 8)
 						ampTable = &_amp8Table[channelVolume * 128];
 					else
@@ -412,6 +459,12 @@ void IMuseDigiInternalMixer::mixBits8Mono(uint8 *srcBuf, int32 inFrameCount, int
 					}
 				}
 			} else {
+#ifdef SCUMMVM_SSE2
+				if (_useSSE2) {
+					mixBits8SSE2(mixBufCurCell, srcBuf_ptr, feedSize, ampTableScale(ampTable, 128));
+					return;
+				}
+#endif
 				if (feedSize) {
 					for (int i = 0; i < feedSize; i++) {
 						mixBufCurCell[i] += *((uint16 *)ampTable + srcBuf_ptr[i]);
@@ -464,6 +517,12 @@ void IMuseDigiInternalMixer::mixBits12Mono(uint8 *srcBuf, int32 inFrameCount, in
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[2 * mixBufStartIndex]);
 	if (feedSize == inFrameCount) {
+#ifdef SCUMMVM_SSE2
+		if (_useSSE2) {
+			mixBits12SSE2(mixBufCurCell, srcBuf, inFrameCount, ampTableScale(ampTable, 2048), 0, false);
+			return;
+		}
+#endif
 		if (inFrameCount / 2) {
 			srcBuf_ptr = srcBuf;
 			for (int i = 0; i < inFrameCount / 2; i++) {
@@ -539,6 +598,12 @@ void IMuseDigiInternalMixer::mixBits16Mono(uint8 *srcBuf, int32 inFrameCount, in
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[2 * mixBufStartIndex]);
 	if (feedSize == inFrameCount) {
+#ifdef SCUMMVM_SSE2
+		if (_useSSE2) {
+			mixBits16SSE2(mixBufCurCell, (uint16 *)srcBuf, feedSize, ampTableScale(ampTable, 2048));
+			return;
+		}
+#endif
 		if (feedSize) {
 			srcBuf_ptr = (uint16 *)srcBuf;
 			for (int i = 0; i < feedSize; i++) {
@@ -651,8 +716,8 @@ void IMuseDigiInternalMixer::mixBits12ConvertToMono(uint8 *srcBuf, int32 inFrame
 		srcBuf_ptr = srcBuf;
 		if (inFrameCount - 1 != 0) {
 			for (int i = 0; i < inFrameCount - 1; i++) {
-				term_1 = *((int16 *)ampTable + (srcBuf_ptr[0] | ((srcBuf_ptr[1] & 0xF0) << 8)));
-				term_2 = *((int16 *)ampTable + (srcBuf_ptr[2] | ((srcBuf_ptr[1] & 0xF)  << 4)));
+				term_1 = *((int16 *)ampTable + (srcBuf_ptr[0] | ((srcBuf_ptr[1] & 0xF)  << 8)));
+				term_2 = *((int16 *)ampTable + (srcBuf_ptr[2] | ((srcBuf_ptr[1] & 0xF0) << 4)));
 
 				mixBufCurCell[0] += (term_1 + term_2) >> 1;
 				mixBufCurCell[1] += (((term_1 + *((int16 *)ampTable + (srcBuf_ptr[3] | ((srcBuf_ptr[4] & 0xF)  << 8)))) >> 1)
@@ -806,6 +871,12 @@ void IMuseDigiInternalMixer::mixBits8ConvertToStereo(uint8 *srcBuf, int32 inFram
 					}
 				}
 			} else {
+#ifdef SCUMMVM_SSE2
+				if (_useSSE2) {
+					mixBits8ToStereoSSE2(mixBufCurCell, srcBuf, feedSize, ampTableScale(leftAmpTable, 128), ampTableScale(rightAmpTable, 128));
+					return;
+				}
+#endif
 				if (feedSize) {
 					srcBuf_ptr = srcBuf;
 					for (int i = 0; i < feedSize; i++) {
@@ -893,6 +964,12 @@ void IMuseDigiInternalMixer::mixBits12ConvertToStereo(uint8 *srcBuf, int32 inFra
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
 	if (feedSize == inFrameCount) {
+#ifdef SCUMMVM_SSE2
+		if (_useSSE2) {
+			mixBits12SSE2(mixBufCurCell, srcBuf, inFrameCount & ~1, ampTableScale(leftAmpTable, 2048), ampTableScale(rightAmpTable, 2048), true);
+			return;
+		}
+#endif
 		if (inFrameCount / 2) {
 			srcBuf_ptr = srcBuf;
 			for (int i = 0; i < (inFrameCount / 2); i++) {
@@ -1040,6 +1117,12 @@ void IMuseDigiInternalMixer::mixBits16ConvertToStereo(uint8 *srcBuf, int32 inFra
 	mixBufCurCell = (uint16 *)(&_mixBuf[2 * mixBufStartIndex]);
 
 	if (feedSize == inFrameCount) {
+#ifdef SCUMMVM_SSE2
+		if (_useSSE2) {
+			mixBits16ToStereoSSE2(mixBufCurCell, (uint16 *)srcBuf, feedSize, ampTableScale(leftAmpTable, 2048), ampTableScale(rightAmpTable, 2048));
+			return;
+		}
+#endif
 		if (feedSize) {
 			srcBuf_tmp = (uint16 *)srcBuf;
 			for (int i = 0; i < feedSize; i++) {
@@ -1128,6 +1211,12 @@ void IMuseDigiInternalMixer::mixBits8Stereo(uint8 *srcBuf, int32 inFrameCount, i
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
 	if (feedSize == inFrameCount) {
+#ifdef SCUMMVM_SSE2
+		if (_useSSE2) {
+			mixBits8SSE2(mixBufCurCell, srcBuf, 2 * feedSize, ampTableScale(ampTable, 128));
+			return;
+		}
+#endif
 		if (feedSize) {
 			srcBuf_ptr = srcBuf;
 			for (int i = 0; i < feedSize; i++) {
@@ -1212,6 +1301,12 @@ void IMuseDigiInternalMixer::mixBits12Stereo(uint8 *srcBuf, int32 inFrameCount,
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
 	if (feedSize == inFrameCount) {
+#ifdef SCUMMVM_SSE2
+		if (_useSSE2) {
+			mixBits12SSE2(mixBufCurCell, srcBuf, 2 * feedSize, ampTableScale(ampTable, 2048), 0, false);
+			return;
+		}
+#endif
 		if (feedSize) {
 			srcBuf_ptr = srcBuf;
 
@@ -1305,6 +1400,12 @@ void IMuseDigiInternalMixer::mixBits16Stereo(uint8 *srcBuf, int32 inFrameCount,
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
 	if (feedSize == inFrameCount) {
+#ifdef SCUMMVM_SSE2
+		if (_useSSE2) {
+			mixBits16SSE2(mixBufCurCell, (uint16 *)srcBuf, 2 * feedSize, ampTableScale(ampTable, 2048));
+			return;
+		}
+#endif
 		if (feedSize) {
 			srcBuf_ptr = (uint16 *)srcBuf;
 
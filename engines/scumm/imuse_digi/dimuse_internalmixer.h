@@ -42,6 +42,19 @@ class QueuingAudioStream;
 
 namespace Scumm {
 
+#ifdef SCUMMVM_SSE2
+// SSE2 mixing loops for sources at the output rate. They add the amplitude
+// table entries for count samples, computed from the table's scale, to the
+// mixing buffer; the ToStereo versions add them to both channels. Centered
+// samples are 12-bit samples which are already unpacked and centered on 0.
+void mixBits8SSE2(uint16 *mixBuf, const uint8 *src, int count, int scale);
+void mixBits8ToStereoSSE2(uint16 *mixBuf, const uint8 *src, int count, int leftScale, int rightScale);
+void mixBits16SSE2(uint16 *mixBuf, const uint16 *src, int count, int scale);
+void mixBits16ToStereoSSE2(uint16 *mixBuf, const uint16 *src, int count, int leftScale, int rightScale);
+void mixCenteredSSE2(uint16 *mixBuf, const int16 *src, int count, int scale);
+void mixCenteredToStereoSSE2(uint16 *mixBuf, const int16 *src, int count, int leftScale, int rightScale);
+#endif
+
 class IMuseDigiInternalMixer {
 
 private:
@@ -87,6 +100,10 @@ public:
 	void clearRadioChatter();
 	int  clearMixerBuffer();
 
+	// Whether the mixing loops for sources at the output rate use SSE2,
+	// which is set up from the CPU features
+	bool _useSSE2;
+
 	void mix(uint8 *srcBuf, int32 inFrameCount, int wordSize, int channelCount, int feedSize, int32 mixBufStartIndex, int volume, int pan, bool ftIs11025Hz);
 	int  loop(uint8 **destBuffer, int len);
 	Audio::QueuingAudioStream *_stream;
@@ -0,0 +1,168 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scumm/imuse_digi/dimuse_engine.h"
+#include "scumm/imuse_digi/dimuse_internalmixer.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Scumm {
+
+namespace {
+
+// Loads 8 samples and centers them on 0, as the amplitude tables are indexed
+struct Bits8 {
+	typedef uint8 Sample;
+
+	static __m128i load(const uint8 *src) {
+		const __m128i samples = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+		return _mm_sub_epi16(samples, _mm_set1_epi16(128));
+	}
+
+	static int center(uint8 sample) {
+		return sample - 128;
+	}
+};
+
+// 16-bit samples use the 12-bit table, with the lowest 4 bits dropped
+struct Bits16 {
+	typedef uint16 Sample;
+
+	static __m128i load(const uint16 *src) {
+		return _mm_srai_epi16(_mm_loadu_si128((const __m128i *)src), 4);
+	}
+
+	static int center(uint16 sample) {
+		return (int16)sample >> 4;
+	}
+};
+
+struct Centered {
+	typedef int16 Sample;
+
+	static __m128i load(const int16 *src) {
+		return _mm_loadu_si128((const __m128i *)src);
+	}
+
+	static int center(int16 sample) {
+		return sample;
+	}
+};
+
+// Computes trunc(p / 127) for the products p of samples and scales. Adding
+// 0.5 to |p| keeps the quotient at least 0.5/127 away from any integer, which
+// is far more than the error of multiplying by the rounded reciprocal, so it
+// still truncates to the integer the division does.
+inline __m128i divideBy127(__m128i products) {
+	const __m128 p = _mm_cvtepi32_ps(products);
+	const __m128 half = _mm_or_ps(_mm_and_ps(p, _mm_set1_ps(-0.0f)), _mm_set1_ps(0.5f));
+	return _mm_cvttps_epi32(_mm_mul_ps(_mm_add_ps(p, half), _mm_set1_ps(1.0f / 127)));
+}
+
+// Computes the amplitude table entries trunc(x * scale / 127) for 8 centered
+// samples x. The products fit into a float mantissa, so they are exact.
+inline __m128i amplitudes(__m128i samples, __m128i scales) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(samples, zero), _mm_unpacklo_epi16(scales, zero));
+	const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(samples, zero), _mm_unpackhi_epi16(scales, zero));
+	return _mm_packs_epi32(divideBy127(lo), divideBy127(hi));
+}
+
+inline void addAmplitudes(uint16 *mixBuf, __m128i samples, __m128i scales) {
+	const __m128i mix = _mm_loadu_si128((const __m128i *)mixBuf);
+	_mm_storeu_si128((__m128i *)mixBuf, _mm_add_epi16(mix, amplitudes(samples, scales)));
+}
+
+template<class Format>
+void mixSamples(uint16 *mixBuf, const typename Format::Sample *src, int count, int scale) {
+	const __m128i scales = _mm_set1_epi16(scale);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+		addAmplitudes(mixBuf + i, Format::load(src + i), scales);
+
+	for (; i < count; i++)
+		mixBuf[i] += Format::center(src[i]) * scale / 127;
+}
+
+template<class Format>
+void mixSamplesToStereo(uint16 *mixBuf, const typename Format::Sample *src, int count, int leftScale, int rightScale) {
+	const __m128i scales = _mm_unpacklo_epi16(_mm_set1_epi16(leftScale), _mm_set1_epi16(rightScale));
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i samples = Format::load(src + i);
+		addAmplitudes(mixBuf + 2 * i, _mm_unpacklo_epi16(samples, samples), scales);
+		addAmplitudes(mixBuf + 2 * i + 8, _mm_unpackhi_epi16(samples, samples), scales);
+	}
+
+	for (; i < count; i++) {
+		mixBuf[2 * i] += Format::center(src[i]) * leftScale / 127;
+		mixBuf[2 * i + 1] += Format::center(src[i]) * rightScale / 127;
+	}
+}
+
+} // End of anonymous namespace
+
+void mixBits8SSE2(uint16 *mixBuf, const uint8 *src, int count, int scale) {
+	mixSamples<Bits8>(mixBuf, src, count, scale);
+}
+
+void mixBits8ToStereoSSE2(uint16 *mixBuf, const uint8 *src, int count, int leftScale, int rightScale) {
+	mixSamplesToStereo<Bits8>(mixBuf, src, count, leftScale, rightScale);
+}
+
+void mixBits16SSE2(uint16 *mixBuf, const uint16 *src, int count, int scale) {
+	mixSamples<Bits16>(mixBuf, src, count, scale);
+}
+
+void mixBits16ToStereoSSE2(uint16 *mixBuf, const uint16 *src, int count, int leftScale, int rightScale) {
+	mixSamplesToStereo<Bits16>(mixBuf, src, count, leftScale, rightScale);
+}
+
+void mixCenteredSSE2(uint16 *mixBuf, const int16 *src, int count, int scale) {
+	mixSamples<Centered>(mixBuf, src, count, scale);
+}
+
+void mixCenteredToStereoSSE2(uint16 *mixBuf, const int16 *src, int count, int leftScale, int rightScale) {
+	mixSamplesToStereo<Centered>(mixBuf, src, count, leftScale, rightScale);
+}
+
+} // End of namespace Scumm
+
+#if !defined(__x86_64__)
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif // !defined(__x86_64__)
@@ -949,6 +949,9 @@ void ScummMetaEngine::registerDefaultSettings(const Common::String &) const {
 			ConfMan.registerDefault(engineOptions[i].configOption, engineOptions[i].defaultState);
 	}
 	ConfMan.registerDefault("gamma_correction", true);
+	ConfMan.registerDefault("smush_read_ahead", true);
+	ConfMan.registerDefault("resource_heap_size", 0);
+	ConfMan.registerDefault("resource_eviction", "oldest");
 }
 
 Common::KeymapArray ScummMetaEngine::initKeymaps(const char *target) const {
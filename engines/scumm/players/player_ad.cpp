@@ -76,6 +76,11 @@ Player_AD::Player_AD(ScummEngine *scumm, Common::Mutex &mutex)
 
 Player_AD::~Player_AD() {
 	stopAllSounds();
+
+	// Stop the OPL timer. Not under the lock, as stopping waits for a
+	// running onTimer(), which takes it.
+	_opl2->stop();
+
 	Common::StackLock lock(_mutex);
 	delete _opl2;
 	_opl2 = nullptr;
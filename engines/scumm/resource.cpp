@@ -49,6 +49,7 @@ enum {
 	RF_USAGE_MAX = RF_USAGE,
 
 	RS_MODIFIED = 0x10,
+	RS_EVICTED = 0x20,
 	RF_OFFHEAP = 0x40
 };
 
@@ -784,7 +785,7 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 		return nullptr;
 	}
 
-	_res->setResourceCounter(type, idx, 1);
+	_res->markResourceUsed(type, idx);
 
 	debugC(DEBUG_RESOURCE, "getResourceAddress(%s,%d) == %p", nameOfResType(type), idx, (void *)ptr);
 	return ptr;
@@ -834,6 +835,14 @@ void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter)
 	_types[type][idx].setResourceCounter(counter);
 }
 
+void ResourceManager::markResourceUsed(ResType type, ResId idx) {
+	Common::StackLock lock(*_mutex);
+	Resource &res = _types[type][idx];
+	if (res.getResourceCounter() > 1 && res._uses < 0xFFFF)
+		res._uses++;
+	res.setResourceCounter(1);
+}
+
 void ResourceManager::Resource::setResourceCounter(byte counter) {
 	_flags &= RF_LOCK;	// Clear lower 7 bits, preserve the lock bit.
 	_flags |= counter;	// Update the usage counter
@@ -873,6 +882,18 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 
 	_allocatedSize += size;
 
+	if (_types[type]._mode != kDynamicResTypeMode) {
+		_stats.loads++;
+		_stats.bytesLoaded += size;
+
+		if (_types[type][idx].wasEvicted()) {
+			_stats.reloads++;
+			_stats.bytesReloaded += size;
+			_stats.typeReloads[type]++;
+			_types[type][idx].setEvicted(false);
+		}
+	}
+
 	_types[type][idx]._address = ptr;
 	_types[type][idx]._size = size;
 	setResourceCounter(type, idx, 1);
@@ -889,6 +910,7 @@ ResourceManager::Resource::Resource() {
 	_status = 0;
 	_roomno = 0;
 	_roomoffs = 0;
+	_uses = 0;
 }
 
 ResourceManager::Resource::~Resource() {
@@ -918,6 +940,8 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_evictionPolicy = kEvictOldest;
+	_stats.reset();
 }
 
 ResourceManager::~ResourceManager() {
@@ -931,6 +955,12 @@ void ResourceManager::setHeapThreshold(int min, int max) {
 	_minHeapThreshold = min;
 }
 
+void ResourceManager::setHeapSize(uint32 kilobytes) {
+	// Keep the thresholds in bytes within the range of setHeapThreshold()
+	const int max = CLIP<uint32>(kilobytes, 1, kMaxHeapSize) * 1024;
+	setHeapThreshold(max / 4 * 3, max);
+}
+
 bool ResourceManager::validateResource(const char *str, ResType type, ResId idx) const {
 	if (type < rtFirst || type > rtLast || (uint)idx >= (uint)_types[type].size()) {
 		warning("%s Illegal Glob type %s (%d) num %d", str, nameOfResType(type), type, idx);
@@ -1088,8 +1118,65 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
+void ResourceManager::Resource::setEvicted(bool evicted) {
+	if (evicted)
+		_status |= RS_EVICTED;
+	else
+		_status &= ~RS_EVICTED;
+}
+
+bool ResourceManager::Resource::wasEvicted() const {
+	return (_status & RS_EVICTED) != 0;
+}
+
+static const char *const evictionPolicyNames[] = { "oldest", "cost", "frequency" };
+
+const char *ResourceManager::getEvictionPolicyName(ResourceEvictionPolicy policy) {
+	return evictionPolicyNames[policy];
+}
+
+bool ResourceManager::parseEvictionPolicy(const Common::String &name, ResourceEvictionPolicy &policy) {
+	for (int i = 0; i < ARRAYSIZE(evictionPolicyNames); i++) {
+		if (name == evictionPolicyNames[i]) {
+			policy = (ResourceEvictionPolicy)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+uint64 ResourceManager::getExpireScore(ResourceEvictionPolicy policy, ResType type, byte counter, uint32 size, uint16 uses) {
+	switch (policy) {
+	case kEvictCostAware:
+		return (uint64)counter * size / getReloadCost(type);
+	case kEvictLeastFrequent:
+		// Scaled, so that the age still decides between resources with
+		// many uses
+		return ((uint64)counter << 16) / (uses + 1);
+	default:
+		return counter;
+	}
+}
+
+uint32 ResourceManager::getReloadCost(ResType type) {
+	switch (type) {
+	case rtRoom:
+	case rtRoomImage:
+	case rtRoomScripts:
+	case rtImage:
+		// Rooms are needed again as soon as the room is entered, and HE
+		// images usually have to be decompressed again after loading.
+		return 4;
+	case rtCostume:
+	case rtCharset:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
+	uint64 best_score;
 	ResType best_type;
 	int best_res = 0;
 	uint32 oldAllocatedSize;
@@ -1106,7 +1193,7 @@ void ResourceManager::expireResources(uint32 size) {
 
 	do {
 		best_type = rtInvalid;
-		best_counter = 2;
+		best_score = 0;
 
 		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
 			if (_types[type]._mode != kDynamicResTypeMode) {
@@ -1116,8 +1203,12 @@ void ResourceManager::expireResources(uint32 size) {
 				while (idx-- > 0) {
 					Resource &tmp = _types[type][idx];
 					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
+					if (tmp.isLocked() || counter < 2 || !tmp._address || tmp.isOffHeap())
+						continue;
+
+					const uint64 score = getExpireScore(_evictionPolicy, type, counter, tmp._size, tmp._uses);
+					if (score >= best_score && !_vm->isResourceInUse(type, idx)) {
+						best_score = score;
 						best_type = type;
 						best_res = idx;
 					}
@@ -1127,9 +1218,19 @@ void ResourceManager::expireResources(uint32 size) {
 
 		if (!best_type)
 			break;
+
+		_stats.evictions++;
+		_stats.bytesEvicted += _types[best_type][best_res]._size;
+		_types[best_type][best_res].setEvicted(true);
 		nukeResource(best_type, best_res);
 	} while (size + _allocatedSize > _minHeapThreshold);
 
+	// Resources which were used a lot long ago are not kept forever
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		for (uint idx = 0; idx < _types[type].size(); idx++)
+			_types[type][idx]._uses >>= 1;
+	}
+
 	increaseResourceCounters();
 
 	debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d", oldAllocatedSize, _allocatedSize);
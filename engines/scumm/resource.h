@@ -73,6 +73,48 @@ enum ResTypeMode {
 	kSoundResTypeMode = 2		///< Resource comes from data files, but may change
 };
 
+/**
+ * The strategy used by ResourceManager::expireResources to pick the resources
+ * which are thrown out once the heap threshold is reached.
+ */
+enum ResourceEvictionPolicy {
+	/** Throw out the oldest resources first, as the original interpreters do. */
+	kEvictOldest = 0,
+	/**
+	 * Weigh the age of each resource by its size and by how expensive it is to
+	 * load it again, so that big resources which are cheap to reload go first
+	 * and e.g. rooms and HE images are kept around longer.
+	 */
+	kEvictCostAware = 1,
+	/**
+	 * Weigh the age of each resource by how often it was used, so that
+	 * resources which are needed again and again are kept around longer.
+	 */
+	kEvictLeastFrequent = 2
+};
+
+/**
+ * Counters of the resource manager, mostly useful to tune the heap threshold
+ * and eviction policy of a game.
+ */
+struct ResourceStatistics {
+	uint32 loads;
+	uint32 bytesLoaded;
+	uint32 evictions;
+	uint32 bytesEvicted;
+	uint32 reloads;
+	uint32 bytesReloaded;
+	uint32 typeReloads[rtLast + 1];
+
+	void reset() {
+		loads = bytesLoaded = 0;
+		evictions = bytesEvicted = 0;
+		reloads = bytesReloaded = 0;
+		for (int i = 0; i <= rtLast; i++)
+			typeReloads[i] = 0;
+	}
+};
+
 /**
  * The 'resource manager' class. Currently doesn't really deserve to be called
  * a 'class', at least until somebody gets around to OOfying this more.
@@ -131,6 +173,13 @@ public:
 		 */
 		uint32 _roomoffs;
 
+		/**
+		 * How often the resource was used, counting at most one use between
+		 * two increments of the usage counter. It is kept when the resource
+		 * is expired, and halved every time resources are expired.
+		 */
+		uint16 _uses;
+
 	public:
 		Resource();
 		~Resource();
@@ -150,6 +199,9 @@ public:
 		void setOffHeap();
 		void setOnHeap();
 		bool isOffHeap() const;
+
+		void setEvicted(bool evicted);
+		bool wasEvicted() const;
 	};
 
 	/**
@@ -181,12 +233,44 @@ protected:
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	ResourceEvictionPolicy _evictionPolicy;
+	ResourceStatistics _stats;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
+
+	enum {
+		kMaxHeapSize = 1024 * 1024	///< The largest heap budget in KB
+	};
+
+	/**
+	 * Set the heap budget in KB, the resources being expired down to 3/4 of
+	 * it. The budget is limited to kMaxHeapSize.
+	 */
+	void setHeapSize(uint32 kilobytes);
+
 	uint32 getHeapSize() { return _allocatedSize; }
+	uint32 getMinHeapThreshold() const { return _minHeapThreshold; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
+
+	void setEvictionPolicy(ResourceEvictionPolicy policy) { _evictionPolicy = policy; }
+	ResourceEvictionPolicy getEvictionPolicy() const { return _evictionPolicy; }
+
+	/** The name of a policy, as used by the "resource_eviction" setting. */
+	static const char *getEvictionPolicyName(ResourceEvictionPolicy policy);
+	static bool parseEvictionPolicy(const Common::String &name, ResourceEvictionPolicy &policy);
+
+	/**
+	 * How much a policy wants to expire a resource which is not in use.
+	 * The resource with the highest score is expired first.
+	 */
+	static uint64 getExpireScore(ResourceEvictionPolicy policy, ResType type, byte counter, uint32 size, uint16 uses);
+
+	const ResourceStatistics &getStatistics() const { return _stats; }
+	void resetStatistics() { _stats.reset(); }
 
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
 	void freeResources();
@@ -222,6 +306,12 @@ public:
 	 */
 	void setResourceCounter(ResType type, ResId idx, byte counter);
 
+	/**
+	 * Reset the specified resource's counter on an access, and count a use
+	 * if the counter was incremented since the last access.
+	 */
+	void markResourceUsed(ResType type, ResId idx);
+
 	/**
 	 * Increment the counter of all unlocked loaded resources.
 	 * The maximal count is 255.
@@ -236,6 +326,12 @@ public:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
 	void expireResources(uint32 size);
+
+	/**
+	 * Relative cost of loading a resource of the given type again once it
+	 * has been expired, used by the kEvictCostAware policy.
+	 */
+	static uint32 getReloadCost(ResType type);
 };
 
 } // End of namespace Scumm
@@ -1717,6 +1717,15 @@ void ScummEngine::setupScumm(const Common::Path &macResourceFile) {
 	_res->setHeapThreshold(16 * 1024 * 1024, 32 * 1024 * 1024);
 #endif
 
+	// The heap budget (in KB) and eviction policy can be tuned per game
+	int heapSize = ConfMan.getInt("resource_heap_size");
+	if (heapSize > 0)
+		_res->setHeapSize(heapSize);
+
+	ResourceEvictionPolicy policy;
+	if (ResourceManager::parseEvictionPolicy(ConfMan.get("resource_eviction"), policy))
+		_res->setEvictionPolicy(policy);
+
 	free(_compositeBuf);
 	_compositeBuf = (byte *)malloc(_screenWidth * _textSurfaceMultiplier * _screenHeight * _textSurfaceMultiplier * _outputPixelFormat.bytesPerPixel);
 }
@@ -324,6 +324,28 @@ void SmushDeltaBlocksDecoder::makeTable(int pitch, int index) {
 		dst += 4;                                             \
 	} while (0)
 
+/*
+ * Copy a run of 4x4 pixel blocks from the same place in the other buffer.
+ * The blocks of the run which are on one block row are copied together,
+ * so unchanged areas are copied line by line instead of block by block.
+ */
+
+static void copyBlockRun(byte *&dst, int32 nextOffs, int32 length, int32 &i, int &bh, int bw, int pitch) {
+	while (length > 0) {
+		const int32 blocks = MIN(length, i);
+		for (int x = 0; x < 4; x++)
+			memcpy(dst + pitch * x, dst + nextOffs + pitch * x, blocks * 4);
+		dst += blocks * 4;
+		length -= blocks;
+		i -= blocks;
+		if (i == 0) {
+			dst += pitch * 3;
+			bh--;
+			i = bw;
+		}
+	}
+}
+
 void SmushDeltaBlocksDecoder::proc1(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
 	uint8 code;
 	bool filling, skipCode;
@@ -438,16 +460,7 @@ void SmushDeltaBlocksDecoder::proc4WithFDFE(byte *dst, const byte *src, int32 ne
 				LITERAL_1X1(src, dst, pitch);
 			} else if (code == 0x00) {
 				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + nextOffs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
-					if (i == 0) {
-						dst += pitch * 3;
-						bh--;
-						i = bw;
-					}
-				}
+				copyBlockRun(dst, nextOffs, length, i, bh, bw, pitch);
 				if (bh == 0) {
 					return;
 				}
@@ -470,16 +483,7 @@ void SmushDeltaBlocksDecoder::proc4WithoutFDFE(byte *dst, const byte *src, int32
 				LITERAL_1X1(src, dst, pitch);
 			} else if (code == 0x00) {
 				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + nextOffs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
-					if (i == 0) {
-						dst += pitch * 3;
-						bh--;
-						i = bw;
-					}
-				}
+				copyBlockRun(dst, nextOffs, length, i, bh, bw, pitch);
 				if (bh == 0) {
 					return;
 				}
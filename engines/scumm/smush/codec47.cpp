@@ -44,24 +44,47 @@ namespace Scumm {
 		(dst)[1] = (src)[1];    \
 	} while (0)
 
+#define COPY_8X1_LINE(dst, src)              \
+	do {                                     \
+		COPY_4X1_LINE(dst, src);             \
+		COPY_4X1_LINE((dst) + 4, (src) + 4); \
+	} while (0)
+
+#define FILL_4X1_LINE(dst, val) \
+	do {                        \
+		(dst)[0] = val;         \
+		(dst)[1] = val;         \
+		(dst)[2] = val;         \
+		(dst)[3] = val;         \
+	} while (0)
+
+#define FILL_8X1_LINE(dst, val)        \
+	do {                               \
+		FILL_4X1_LINE(dst, val);       \
+		FILL_4X1_LINE((dst) + 4, val); \
+	} while (0)
 
 #else /* SCUMM_NEED_ALIGNMENT */
 
+// Whole block lines are moved as single machine words. The fill value is
+// replicated to every byte of the word by the multiplication.
+
 #define COPY_4X1_LINE(dst, src)               \
 	*(uint32 *)(dst) = *(const uint32 *)(src)
 
 #define COPY_2X1_LINE(dst, src)               \
 	*(uint16 *)(dst) = *(const uint16 *)(src)
 
-#endif
+#define COPY_8X1_LINE(dst, src)               \
+	*(uint64 *)(dst) = *(const uint64 *)(src)
 
-#define FILL_4X1_LINE(dst, val) \
-	do {                        \
-		(dst)[0] = val;         \
-		(dst)[1] = val;         \
-		(dst)[2] = val;         \
-		(dst)[3] = val;         \
-	} while (0)
+#define FILL_4X1_LINE(dst, val)               \
+	*(uint32 *)(dst) = (uint32)(val) * 0x01010101U
+
+#define FILL_8X1_LINE(dst, val)               \
+	*(uint64 *)(dst) = (uint64)(val) * 0x0101010101010101ULL
+
+#endif
 
 #define FILL_2X1_LINE(dst, val) \
 	do {                        \
@@ -463,8 +486,7 @@ void SmushDeltaGlyphsDecoder::level1(byte *d_dst) {
 	if (code < MOTION_OFFSET_TABLE_SIZE) {
 		tmp = _table[code] + _offset1;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp + 4);
+			COPY_8X1_LINE(d_dst, d_dst + tmp);
 			d_dst += _dPitch;
 		}
 	} else if (code == PROCESS_SUBBLOCKS) {
@@ -478,8 +500,7 @@ void SmushDeltaGlyphsDecoder::level1(byte *d_dst) {
 	} else if (code == FILL_SINGLE_COLOR) {
 		byte t = *_dSrc++;
 		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
+			FILL_8X1_LINE(d_dst, t);
 			d_dst += _dPitch;
 		}
 	} else if (code == DRAW_GLYPH) {
@@ -502,15 +523,13 @@ void SmushDeltaGlyphsDecoder::level1(byte *d_dst) {
 	} else if (code == COPY_PREV_BUFFER) {
 		tmp = _offset2;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp + 4);
+			COPY_8X1_LINE(d_dst, d_dst + tmp);
 			d_dst += _dPitch;
 		}
 	} else {
 		byte t = _paramPtr[code];
 		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
+			FILL_8X1_LINE(d_dst, t);
 			d_dst += _dPitch;
 		}
 	}
@@ -21,6 +21,7 @@
 
 #include "common/config-manager.h"
 #include "common/file.h"
+#include "common/memstream.h"
 #include "common/system.h"
 #include "common/util.h"
 #include "common/rect.h"
@@ -232,6 +233,11 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm, IMuseDigital *imuseDigital, Insa
 	_sf[3] = nullptr;
 	_sf[4] = nullptr;
 	_base = nullptr;
+	_readAhead = false;
+	_readAheadBuf = nullptr;
+	_readAheadBufSize = 0;
+	_readAheadSize = 0;
+	_readAheadPos = -1;
 	_frameBuffer = nullptr;
 	_specialBuffer = nullptr;
 
@@ -323,6 +329,11 @@ void SmushPlayer::release() {
 	delete _base;
 	_base = nullptr;
 
+	free(_readAheadBuf);
+	_readAheadBuf = nullptr;
+	_readAheadBufSize = 0;
+	_readAheadPos = -1;
+
 	free(_specialBuffer);
 	_specialBuffer = nullptr;
 
@@ -1033,6 +1044,9 @@ void SmushPlayer::parseNextFrame() {
 			if (!_vm->openFile(*tmp, Common::Path(_seekFile)))
 				error("SmushPlayer: Unable to open file %s", _seekFile.c_str());
 			_base = tmp;
+			// A frame read ahead from the old file is stale, even where the
+			// new file happens to be at the same position
+			_readAheadPos = -1;
 			_base->readUint32BE();
 			_baseSize = _base->readUint32BE();
 
@@ -1069,30 +1083,46 @@ void SmushPlayer::parseNextFrame() {
 
 	assert(_base);
 
-	const uint32 subType = _base->readUint32BE();
-	const int32 subSize = _base->readUint32BE();
-	const int32 subOffset = _base->pos();
+	// A frame read ahead is only valid if nothing has seeked in the meantime
+	if (_readAheadPos >= 0 && _readAheadPos != _base->pos())
+		_readAheadPos = -1;
 
-	if (_base->pos() >= (int32)_baseSize) {
-		_vm->_smushVideoShouldFinish = true;
-		_endOfFile = true;
-		return;
-	}
+	if (_readAheadPos >= 0) {
+		const int32 subOffset = _readAheadPos + 8;
+		_readAheadPos = -1;
 
-	debug(3, "Chunk: %s at %x", tag2str(subType), subOffset);
+		debug(3, "Chunk: FRME at %x (read ahead)", subOffset);
 
-	switch (subType) {
-	case MKTAG('A','H','D','R'): // FT INSANE may seek file to the beginning
-		handleAnimHeader(subSize, *_base);
-		break;
-	case MKTAG('F','R','M','E'):
-		handleFrame(subSize, *_base);
-		break;
-	default:
-		error("Unknown Chunk found at %x: %s, %d", subOffset, tag2str(subType), subSize);
-	}
+		Common::MemoryReadStream frame(_readAheadBuf, _readAheadSize);
+		handleFrame(_readAheadSize, frame);
+
+		_base->seek(subOffset + _readAheadSize, SEEK_SET);
+	} else {
+		const uint32 subType = _base->readUint32BE();
+		const int32 subSize = _base->readUint32BE();
+		const int32 subOffset = _base->pos();
+
+		if (_base->pos() >= (int32)_baseSize) {
+			_vm->_smushVideoShouldFinish = true;
+			_endOfFile = true;
+			return;
+		}
+
+		debug(3, "Chunk: %s at %x", tag2str(subType), subOffset);
+
+		switch (subType) {
+		case MKTAG('A','H','D','R'): // FT INSANE may seek file to the beginning
+			handleAnimHeader(subSize, *_base);
+			break;
+		case MKTAG('F','R','M','E'):
+			handleFrame(subSize, *_base);
+			break;
+		default:
+			error("Unknown Chunk found at %x: %s, %d", subOffset, tag2str(subType), subSize);
+		}
 
-	_base->seek(subOffset + subSize, SEEK_SET);
+		_base->seek(subOffset + subSize, SEEK_SET);
+	}
 
 	if (_insanity)
 		_vm->_sound->processSound();
@@ -1100,6 +1130,34 @@ void SmushPlayer::parseNextFrame() {
 	_vm->_imuseDigital->flushTracks();
 }
 
+void SmushPlayer::readAheadFrame() {
+	if (!_base || _readAheadPos >= 0 || _seekPos >= 0 || _endOfFile)
+		return;
+
+	const int32 pos = _base->pos();
+	if (pos + 8 >= (int32)_baseSize)
+		return;
+
+	const uint32 subType = _base->readUint32BE();
+	const int32 subSize = _base->readUint32BE();
+
+	// Only frames are read ahead; an AHDR chunk means INSANE is rewinding
+	if (subType == MKTAG('F','R','M','E') && subSize > 0 && pos + 8 + subSize <= (int32)_baseSize) {
+		if ((uint32)subSize > _readAheadBufSize) {
+			free(_readAheadBuf);
+			_readAheadBuf = (byte *)malloc(subSize);
+			_readAheadBufSize = _readAheadBuf ? subSize : 0;
+		}
+
+		if (_readAheadBuf && _base->read(_readAheadBuf, subSize) == (uint32)subSize) {
+			_readAheadSize = subSize;
+			_readAheadPos = pos;
+		}
+	}
+
+	_base->seek(pos, SEEK_SET);
+}
+
 void SmushPlayer::setPalette(const byte *palette) {
 	memcpy(_pal, palette, 0x300);
 	setDirtyColors(0, 255);
@@ -1230,6 +1288,8 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 
 	_pauseTime = 0;
 
+	_readAhead = ConfMan.getBool("smush_read_ahead");
+
 	// This piece of code is used to ensure there are
 	// no audio hiccups while loading the SMUSH video;
 	// Each version of the engine does it in its own way.
@@ -1350,6 +1410,10 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 			_vm->_system->updateScreen();
 		}
 
+		// Read the next frame from disk while waiting for it to be due
+		if (_readAhead && !_paused)
+			readAheadFrame();
+
 		_vm->_system->delayMillis(10);
 	}
 
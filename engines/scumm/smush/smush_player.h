@@ -138,6 +138,15 @@ private:
 	SmushDeltaGlyphsDecoder *_deltaGlyphsCodec;
 	Common::SeekableReadStream *_base;
 	uint32 _baseSize;
+
+	// The next frame chunk of _base, read while waiting to show the current
+	// frame. _readAheadPos is the position of its chunk header in _base, or
+	// -1 if nothing is buffered.
+	bool _readAhead;
+	byte *_readAheadBuf;
+	uint32 _readAheadBufSize;
+	uint32 _readAheadSize;
+	int32 _readAheadPos;
 	byte *_frameBuffer;
 	byte *_specialBuffer;
 
@@ -229,6 +238,7 @@ protected:
 private:
 	SmushFont *getFont(int font);
 	void parseNextFrame();
+	void readAheadFrame();
 	void init(int32 spped);
 	void setupAnim(const char *file);
 	void updateScreen();
@@ -75,6 +75,9 @@ public:
 	void        onMouseDouble(int button, int32 mx, int32 my) override;
 
 	void IncSortOrder(int count);
+	ItemSorter *getDisplayList() const {
+		return _displayList;
+	}
 
 	bool loadData(Common::ReadStream *rs, uint32 version);
 	void saveData(Common::WriteStream *ws) override;
@@ -34,6 +34,7 @@
 #include "ultima/ultima8/gfx/texture.h"
 #include "ultima/ultima8/gumps/fast_area_vis_gump.h"
 #include "ultima/ultima8/gumps/game_map_gump.h"
+#include "ultima/ultima8/world/item_sorter.h"
 #include "ultima/ultima8/gumps/minimap_gump.h"
 #include "ultima/ultima8/gumps/movie_gump.h"
 #include "ultima/ultima8/gumps/quit_gump.h"
@@ -97,6 +98,7 @@ Debugger::Debugger() : GUI::Debugger() {
 	registerCmd("GameMapGump::dumpAllMaps", WRAP_METHOD(Debugger, cmdDumpAllMaps));
 	registerCmd("GameMapGump::incrementSortOrder", WRAP_METHOD(Debugger, cmdIncrementSortOrder));
 	registerCmd("GameMapGump::decrementSortOrder", WRAP_METHOD(Debugger, cmdDecrementSortOrder));
+	registerCmd("GameMapGump::benchmarkSort", WRAP_METHOD(Debugger, cmdBenchmarkSort));
 
 	registerCmd("Kernel::processTypes", WRAP_METHOD(Debugger, cmdProcessTypes));
 	registerCmd("Kernel::processInfo", WRAP_METHOD(Debugger, cmdProcessInfo));
@@ -879,6 +881,24 @@ bool Debugger::cmdDecrementSortOrder(int argc, const char **argv) {
 	return false;
 }
 
+bool Debugger::cmdBenchmarkSort(int argc, const char **argv) {
+	int32 count = argc > 1 ? strtol(argv[1], 0, 0) : 100;
+	GameMapGump *gump = Ultima8Engine::get_instance()->getGameMapGump();
+	if (!gump || count <= 0) {
+		debugPrintf("Usage: %s [count]\n", argv[0]);
+		return true;
+	}
+
+	ItemSorter *sorter = gump->getDisplayList();
+	uint32 gridTime, fullTime, gridTests, fullTests;
+	bool same = sorter->Benchmark(count, gridTime, fullTime, gridTests, fullTests);
+	debugPrintf("Display list of %u items, sorted %d times\n", sorter->getItemCount(), count);
+	debugPrintf("Without grid: %u ms, %u item pairs compared per sort\n", fullTime, fullTests);
+	debugPrintf("With grid:    %u ms, %u item pairs compared per sort\n", gridTime, gridTests);
+	debugPrintf("Paint order %s\n", same ? "identical" : "DIFFERS");
+	return true;
+}
+
 
 bool Debugger::cmdProcessTypes(int argc, const char **argv) {
 	Kernel::get_instance()->processTypes();
@@ -75,6 +75,7 @@ private:
 	bool cmdDumpAllMaps(int argc, const char **argv);
 	bool cmdIncrementSortOrder(int argc, const char **argv);
 	bool cmdDecrementSortOrder(int argc, const char **argv);
+	bool cmdBenchmarkSort(int argc, const char **argv);
 
 	// Kernel
 	bool cmdProcessTypes(int argc, const char **argv);
@@ -19,6 +19,8 @@
  *
  */
 
+#include "common/algorithm.h"
+#include "common/system.h"
 #include "ultima/ultima.h"
 #include "ultima/ultima8/misc/common_types.h"
 #include "ultima/ultima8/world/item_sorter.h"
@@ -45,10 +47,18 @@ namespace Ultima8 {
 static const uint32 TRANSPARENT_COLOR = TEX32_PACK_RGBA(0x7F, 0x00, 0x00, 0x7F);
 static const uint32 HIGHLIGHT_COLOR = TEX32_PACK_RGBA(0xFF, 0xFF, 0x00, 0x1F);
 
+// Size of the screenspace grid cells, in pixels
+static const int32 GRID_CELL_SIZE = 64;
+
 ItemSorter::ItemSorter(int capacity) :
 	_shapes(nullptr), _clipWindow(0, 0, 0, 0), _items(nullptr), _itemsTail(nullptr),
 	_itemsUnused(nullptr), _painted(nullptr), _camSx(0), _camSy(0),
-	_sortLimit(0), _sortLimitChanged(false) {
+	_sortLimit(0), _sortLimitChanged(false), _useGrid(true), _gridCols(0),
+	_gridRows(0), _listCount(0), _stamp(0), _reusing(false), _pairTests(0) {
+#ifdef SORTITEM_OCCLUSION_EXPERIMENTAL
+	// Adjoining items are looked for among all the items in the list
+	_useGrid = false;
+#endif
 	int i = capacity;
 	while (i--) {
 		SortItem *next = _itemsUnused;
@@ -76,9 +86,34 @@ void ItemSorter::BeginDisplayList(const Rect &clipWindow, const Point3 &cam) {
 	// Get the _shapes, if required
 	if (!_shapes) _shapes = GameData::get_instance()->getMainShapes();
 
+	// Screenspace bounding box bottom x coord (RNB x coord)
+	int32 camSx = (cam.x - cam.y) / 4;
+	// Screenspace bounding box bottom extent  (RNB y coord)
+	int32 camSy = (cam.x + cam.y) / 8 - cam.z;
+
+	// Keep the previous frame's list, until an item turns out to be different
+	_inputs.swap(_prevInputs);
+	_inputs.resize(0);
+	_reusing = _items && clipWindow == _clipWindow && camSx == _camSx && camSy == _camSy;
+	_painted = nullptr;
+
+	if (_reusing)
+		return;
+
 	// Set the clip window, and reset the item list
 	_clipWindow = clipWindow;
+	ResetList();
 
+	if (camSx != _camSx || camSy != _camSy) {
+		_camSx = camSx;
+		_camSy = camSy;
+
+		// Reset sort limit debugging on camera move
+		_sortLimit = 0;
+	}
+}
+
+void ItemSorter::ResetList() {
 	if (_itemsTail) {
 		_itemsTail->_next = _itemsUnused;
 		_itemsUnused = _items;
@@ -87,32 +122,132 @@ void ItemSorter::BeginDisplayList(const Rect &clipWindow, const Point3 &cam) {
 	_items = nullptr;
 	_itemsTail = nullptr;
 	_painted = nullptr;
+	_listCount = 0;
+	_pairTests = 0;
+
+	_gridCols = MAX<int32>(1, (_clipWindow.width() + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE);
+	_gridRows = MAX<int32>(1, (_clipWindow.height() + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE);
+	_grid.resize(_gridCols * _gridRows);
+	for (uint i = 0; i < _grid.size(); i++)
+		_grid[i].resize(0);
+}
 
-	// Screenspace bounding box bottom x coord (RNB x coord)
-	int32 camSx = (cam.x - cam.y) / 4;
-	// Screenspace bounding box bottom extent  (RNB y coord)
-	int32 camSy = (cam.x + cam.y) / 8 - cam.z;
+void ItemSorter::RebuildList() {
+	_reusing = false;
+	ResetList();
+	for (uint i = 0; i < _inputs.size(); i++)
+		AddSortItem(_inputs[i]);
+}
 
-	if (camSx != _camSx || camSy != _camSy) {
-		_camSx = camSx;
-		_camSy = camSy;
+void ItemSorter::FinishDisplayList() {
+	if (!_reusing)
+		return;
 
-		// Reset sort limit debugging on camera move
-		_sortLimit = 0;
+	if (_inputs.size() != _prevInputs.size()) {
+		// Some items of the previous frame are gone
+		RebuildList();
+		return;
 	}
+
+	// Same items as in the previous frame, just repaint them
+	for (SortItem *si = _items; si != nullptr; si = si->_next)
+		si->_order = -1;
+	_reusing = false;
 }
 
 void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, uint32 flags, uint32 ext_flags, uint16 itemNum) {
+	ItemInput input;
+	input._pt = pt;
+	input._shapeNum = shapeNum;
+	input._frameNum = frame_num;
+	input._flags = flags;
+	input._extFlags = ext_flags;
+	input._itemNum = itemNum;
+
+	if (_reusing) {
+		if (_inputs.size() < _prevInputs.size() && _prevInputs[_inputs.size()] == input) {
+			_inputs.push_back(input);
+			return;
+		}
+		RebuildList();
+	}
+
+	_inputs.push_back(input);
+	AddSortItem(input);
+}
+
+bool ItemSorter::AddDependency(SortItem *si, SortItem *si2) {
+	_pairTests++;
+
+#ifdef SORTITEM_OCCLUSION_EXPERIMENTAL
+	// Find adjoining rects for better occlusion
+	if (si->_occl && si2->_occl && si->_z == si2->_z) {
+		// Does this share an edge?
+		if (si->_y == si2->_y && si->_yFar == si2->_yFar) {
+			if (si->_xLeft == si2->_x) {
+				si->_xAdjoin = si2;
+			} else if (si->_x == si2->_xLeft) {
+				si2->_xAdjoin = si;
+			}
+		}
+		else if (si->_x == si2->_x && si->_xLeft == si2->_xLeft) {
+			if (si->_yFar == si2->_y) {
+				si->_yAdjoin = si2;
+			} else if (si->_y == si2->_yFar) {
+				si2->_yAdjoin = si;
+			}
+		}
+	}
+#endif // SORTITEM_OCCLUSION_EXPERIMENTAL
+
+	// Attempt to find paint dependency order
+	if (si->overlap(*si2)) {
+		if (si->below(*si2)) {
+			if (si2->_occl && si2->occludes(*si)) {
+				// No need to do any more checks, this isn't visible
+				si->_occluded = true;
+				return true;
+			} else {
+				// si1 is behind si2, so add it to si2's dependency list
+				si2->_depends.insert_sorted(si);
+			}
+		} else {
+			if (si->_occl && si->occludes(*si2)) {
+				// Occluded, but we can't remove it from the list
+				si2->_occluded = true;
+			} else {
+				// si2 is behind si1, so add it to si1's dependency list
+				si->_depends.insert_sorted(si2);
+			}
+		}
+	}
+	return false;
+}
+
+// Order of the items in the list: the list is sorted with listLessThan,
+// and items which compare equal are kept in the order they were added
+static bool listOrderLessThan(const SortItem *si1, const SortItem *si2) {
+	if (si1->listLessThan(*si2))
+		return true;
+	if (si2->listLessThan(*si1))
+		return false;
+	return si1->_listIndex < si2->_listIndex;
+}
+
+void ItemSorter::AddSortItem(const ItemInput &input) {
+	const Point3 &pt = input._pt;
+	uint32 shapeNum = input._shapeNum;
+	uint32 flags = input._flags;
 
 	// First thing, get a SortItem to use (first of unused)
 	if (!_itemsUnused)
 		_itemsUnused = new SortItem();
 	SortItem *si = _itemsUnused;
 
-	si->_itemNum = itemNum;
+	si->_itemNum = input._itemNum;
 	si->_shape = _shapes->getShape(shapeNum);
 	si->_shapeNum = shapeNum;
-	si->_frame = frame_num;
+	si->_frame = input._frameNum;
 	const ShapeFrame *frame = si->_shape ? si->_shape->getFrame(si->_frame) : nullptr;
 	if (!frame) {
 		// Keep the last shape we skipped so we don't spam the warnings too much
@@ -127,7 +262,7 @@ void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, ui
 	}
 
 	si->_flags = flags;
-	si->_extFlags = ext_flags;
+	si->_extFlags = input._extFlags;
 
 	const ShapeInfo *info = _shapes->getShapeInfo(shapeNum);
 	// Dimensions
@@ -181,70 +316,82 @@ void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, ui
 
 	si->_occluded = false;
 	si->_order = -1;
+	si->_listIndex = _listCount;
 
 	// We will clear all the vector memory
 	// Stictly speaking the vector will sort of leak memory, since they
 	// are never deleted
 	si->_depends.clear();
 
+	// Grid cells covered by the shape frame. Cells are clamped to the grid,
+	// which keeps any two intersecting rects in at least one common cell.
+	const int32 cx0 = CLIP<int32>((si->_sr.left - _clipWindow.left) / GRID_CELL_SIZE, 0, _gridCols - 1);
+	const int32 cx1 = CLIP<int32>((MAX(si->_sr.left, si->_sr.right - 1) - _clipWindow.left) / GRID_CELL_SIZE, 0, _gridCols - 1);
+	const int32 cy0 = CLIP<int32>((si->_sr.top - _clipWindow.top) / GRID_CELL_SIZE, 0, _gridRows - 1);
+	const int32 cy1 = CLIP<int32>((MAX(si->_sr.top, si->_sr.bottom - 1) - _clipWindow.top) / GRID_CELL_SIZE, 0, _gridRows - 1);
+
 	// Iterate the list and compare _shapes
 
 	// Ok,
 	SortItem *addpoint = nullptr;
-	for (SortItem *si2 = _items; si2 != nullptr; si2 = si2->_next) {
+	if (_useGrid) {
 		// Get the insert point... which is before the first item that has higher z than us
-		if (!addpoint && si->listLessThan(*si2))
-			addpoint = si2;
-
-		if (si2->_occluded)
-			continue;
-
-#ifdef SORTITEM_OCCLUSION_EXPERIMENTAL
-		// Find adjoining rects for better occlusion
-		if (si->_occl && si2->_occl && si->_z == si2->_z) {
-			// Does this share an edge?
-			if (si->_y == si2->_y && si->_yFar == si2->_yFar) {
-				if (si->_xLeft == si2->_x) {
-					si->_xAdjoin = si2;
-				} else if (si->_x == si2->_xLeft) {
-					si2->_xAdjoin = si;
-				}
-			}
-			else if (si->_x == si2->_x && si->_xLeft == si2->_xLeft) {
-				if (si->_yFar == si2->_y) {
-					si->_yAdjoin = si2;
-				} else if (si->_y == si2->_yFar) {
-					si2->_yAdjoin = si;
+		if (_itemsTail && si->listLessThan(*_itemsTail)) {
+			for (SortItem *si2 = _items; si2 != nullptr; si2 = si2->_next) {
+				if (si->listLessThan(*si2)) {
+					addpoint = si2;
+					break;
 				}
 			}
 		}
-#endif // SORTITEM_OCCLUSION_EXPERIMENTAL
 
-		// Attempt to find paint dependency order
-		if (si->overlap(*si2)) {
-			if (si->below(*si2)) {
-				if (si2->_occl && si2->occludes(*si)) {
-					// No need to do any more checks, this isn't visible
-					si->_occluded = true;
-					break;
-				} else {
-					// si1 is behind si2, so add it to si2's dependency list
-					si2->_depends.insert_sorted(si);
-				}
-			} else {
-				if (si->_occl && si->occludes(*si2)) {
-					// Occluded, but we can't remove it from the list
-					si2->_occluded = true;
-				} else {
-					// si2 is behind si1, so add it to si1's dependency list
-					si->_depends.insert_sorted(si2);
+		// Only items with an intersecting screenspace rect may overlap, and they
+		// must be compared in list order, as the comparison stops when occluded
+		_stamp++;
+		_candidates.resize(0);
+		for (int32 cy = cy0; cy <= cy1; cy++) {
+			for (int32 cx = cx0; cx <= cx1; cx++) {
+				const Common::Array<SortItem *> &cell = _grid[cy * _gridCols + cx];
+				for (uint i = 0; i < cell.size(); i++) {
+					SortItem *si2 = cell[i];
+					if (si2->_stamp != _stamp && si->_sr.intersects(si2->_sr)) {
+						si2->_stamp = _stamp;
+						_candidates.push_back(si2);
+					}
 				}
 			}
 		}
+		Common::sort(_candidates.begin(), _candidates.end(), listOrderLessThan);
+
+		for (uint i = 0; i < _candidates.size(); i++) {
+			SortItem *si2 = _candidates[i];
+			if (si2->_occluded)
+				continue;
+			if (AddDependency(si, si2))
+				break;
+		}
+	} else {
+		for (SortItem *si2 = _items; si2 != nullptr; si2 = si2->_next) {
+			// Get the insert point... which is before the first item that has higher z than us
+			if (!addpoint && si->listLessThan(*si2))
+				addpoint = si2;
+
+			if (si2->_occluded)
+				continue;
+
+			if (AddDependency(si, si2))
+				break;
+		}
 	}
 
 	// Add it to the list
 	_itemsUnused = _itemsUnused->_next;
+	_listCount++;
+
+	for (int32 cy = cy0; cy <= cy1; cy++) {
+		for (int32 cx = cx0; cx <= cx1; cx++)
+			_grid[cy * _gridCols + cx].push_back(si);
+	}
 
 	// have a position
 	//addpoint = 0;
@@ -274,7 +421,59 @@ void ItemSorter::AddItem(const Item *add) {
 			add->getFlags(), add->getExtFlags(), add->getObjId());
 }
 
+void ItemSorter::GetPaintOrder(Common::Array<uint32> &order) {
+	for (SortItem *si = _items; si != nullptr; si = si->_next)
+		si->_order = -1;
+
+	_painted = nullptr;
+	for (SortItem *si = _items; si != nullptr; si = si->_next) {
+		if (si->_order == -1)
+			if (PaintSortItem(nullptr, si, false, 0))
+				break;
+	}
+
+	// The position of an item in the list differs between the two ways of
+	// building it, if the comparisons stopped early because it is occluded
+	order.resize(0);
+	for (SortItem *si = _items; si != nullptr; si = si->_next) {
+		if (si->_order < 0)
+			continue;
+		if (order.size() <= (uint)si->_order)
+			order.resize(si->_order + 1);
+		order[si->_order] = si->_listIndex;
+	}
+}
+
+bool ItemSorter::Benchmark(int count, uint32 &gridTime, uint32 &fullTime, uint32 &gridTests, uint32 &fullTests) {
+	FinishDisplayList();
+
+	Common::Array<uint32> gridOrder, fullOrder;
+	const bool useGrid = _useGrid;
+
+	_useGrid = false;
+	uint32 start = g_system->getMillis();
+	for (int i = 0; i < count; i++)
+		RebuildList();
+	fullTime = g_system->getMillis() - start;
+	fullTests = _pairTests;
+	GetPaintOrder(fullOrder);
+
+	_useGrid = true;
+	start = g_system->getMillis();
+	for (int i = 0; i < count; i++)
+		RebuildList();
+	gridTime = g_system->getMillis() - start;
+	gridTests = _pairTests;
+	GetPaintOrder(gridOrder);
+
+	_useGrid = useGrid;
+	RebuildList();
+	return gridOrder == fullOrder;
+}
+
 void ItemSorter::PaintDisplayList(RenderSurface *surf, bool item_highlight, bool showFootpads, int gridlines) {
+	FinishDisplayList();
+
 	if (_sortLimit) {
 		// Clear the surface when debugging the sorter
 		uint32 color = TEX32_PACK_RGB(0, 0, 0);
@@ -541,6 +740,8 @@ uint16 ItemSorter::Trace(int32 x, int32 y, HitFace *face, bool item_highlight) {
 	SortItem *it;
 	SortItem *selected;
 
+	FinishDisplayList();
+
 	if (!_painted) { // If no painted item found, we need to sort the items
 		it = _items;
 		_painted = nullptr;
@@ -22,6 +22,9 @@
 #ifndef ULTIMA8_WORLD_ITEMSORTER_H
 #define ULTIMA8_WORLD_ITEMSORTER_H
 
+#include "common/array.h"
+#include "common/stream.h"
+#include "ultima/ultima8/misc/point3.h"
 #include "ultima/ultima8/misc/rect.h"
 
 namespace Ultima {
@@ -31,9 +34,23 @@ class MainShapeArchive;
 class Item;
 class RenderSurface;
 struct SortItem;
-struct Point3;
 
 class ItemSorter {
+	// Arguments of a single AddItem call
+	struct ItemInput {
+		Point3 _pt;
+		uint32 _shapeNum;
+		uint32 _frameNum;
+		uint32 _flags;
+		uint32 _extFlags;
+		uint16 _itemNum;
+
+		bool operator==(const ItemInput &o) const {
+			return _pt == o._pt && _shapeNum == o._shapeNum && _frameNum == o._frameNum &&
+				_flags == o._flags && _extFlags == o._extFlags && _itemNum == o._itemNum;
+		}
+	};
+
 	MainShapeArchive    *_shapes;
 	Rect        _clipWindow;
 
@@ -46,6 +63,23 @@ class ItemSorter {
 	int32       _sortLimit;
 	bool        _sortLimitChanged;
 
+	// Screenspace grid of the items in the list, so that a new item is only
+	// compared against the items sharing a cell with it
+	bool        _useGrid;
+	int32       _gridCols, _gridRows;
+	Common::Array<Common::Array<SortItem *> > _grid;
+	Common::Array<SortItem *> _candidates;
+	uint32      _listCount;     // Items added to the list since it was reset
+	uint32      _stamp;         // Incremented for each item looking up the grid
+
+	// The AddItem calls of this frame and of the previous one. While they
+	// match, the list sorted in the previous frame is kept as it is.
+	Common::Array<ItemInput> _inputs;
+	Common::Array<ItemInput> _prevInputs;
+	bool        _reusing;
+
+	uint32      _pairTests;     // Item pairs compared since the list was reset
+
 public:
 	ItemSorter(int capacity);
 	~ItemSorter();
@@ -69,8 +103,30 @@ public:
 
 	void IncSortLimit(int count);
 
+	// Rebuild the current display list a number of times, with and without
+	// the screenspace grid, and check that both give the same paint order.
+	// Times are in milliseconds.
+	bool Benchmark(int count, uint32 &gridTime, uint32 &fullTime, uint32 &gridTests, uint32 &fullTests);
+
+	uint32 getItemCount() const { return _listCount; }
+
 private:
 	bool PaintSortItem(RenderSurface *surf, SortItem *si, bool showFootpad, int gridlines);
+
+	// Add an item to the list, without recording the call
+	void AddSortItem(const ItemInput &input);
+	// Compare a new item with one already in the list, and set up their
+	// paint dependency. Returns true if the new item is occluded.
+	bool AddDependency(SortItem *si, SortItem *si2);
+	// Move all items to the unused list and clear the grid
+	void ResetList();
+	// Rebuild the list from the calls recorded in this frame, after they
+	// stopped matching the previous frame
+	void RebuildList();
+	// Make sure the list is ready for painting or tracing
+	void FinishDisplayList();
+	// The items in the order they are painted, by the order they were added
+	void GetPaintOrder(Common::Array<uint32> &order);
 };
 
 } // End of namespace Ultima8
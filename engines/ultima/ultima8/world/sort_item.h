@@ -50,7 +50,7 @@ struct SortItem {
 			_occl(false), _solid(false), _draw(false), _roof(false),
 			_noisy(false), _anim(false), _trans(false), _fixed(false),
 			_land(false), _occluded(false), _sprite(false),
-			_invitem(false) { }
+			_invitem(false), _listIndex(0), _stamp(0) { }
 
 	SortItem                *_next;
 	SortItem                *_prev;
@@ -120,6 +120,9 @@ struct SortItem {
 
 	int32   _order;      // Rendering _order. -1 is not yet drawn
 
+	uint32  _listIndex;  // Order in which the item was added to the sorter's list
+	uint32  _stamp;      // Last sorter lookup which found this item
+
 	// Note that Std::priority_queue could be used here, BUT there is no guarantee that it's implementation
 	// will be friendly to insertions
 	// Alternatively i could use Std::list, BUT there is no guarantee that it will keep won't delete
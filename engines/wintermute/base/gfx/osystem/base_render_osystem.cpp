@@ -40,6 +40,14 @@
 #include "common/config-manager.h"
 
 #define DIRTY_RECT_LIMIT 800
+// Max number of disjoint dirty regions, before they are merged into one
+#define DIRTY_REGION_LIMIT 16
+// Max number of unused tickets kept for recycling
+#define TICKET_POOL_LIMIT 256
+// Surface copies larger than this are freed when their ticket is pooled
+#define TICKET_POOL_SURFACE_LIMIT (64 * 1024)
+// Max size of the surface copies kept by all pooled tickets together
+#define TICKET_POOL_MEMORY_LIMIT (1024 * 1024)
 
 namespace Wintermute {
 
@@ -53,10 +61,10 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 	_lastFrameIter = _renderQueue.end();
 	_needsFlip = true;
 	_skipThisFrame = false;
+	_ticketPoolSurfaceSize = 0;
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -73,8 +81,9 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 		it = _renderQueue.erase(it);
 		delete ticket;
 	}
-
-	delete _dirtyRect;
+	for (uint i = 0; i < _ticketPool.size(); i++) {
+		delete _ticketPool[i];
+	}
 
 	_renderSurface->free();
 	delete _renderSurface;
@@ -148,8 +157,7 @@ bool BaseRenderOSystem::forcedFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.clear();
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -172,7 +180,7 @@ bool BaseRenderOSystem::flip() {
 			if ((*it)->_wantsDraw == false) {
 				RenderTicket *ticket = *it;
 				it = _renderQueue.erase(it);
-				delete ticket;
+				releaseTicket(ticket);
 			} else {
 				(*it)->_wantsDraw = false;
 				++it;
@@ -188,8 +196,7 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen(_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.clear();
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
@@ -256,7 +263,7 @@ Graphics::PixelFormat BaseRenderOSystem::getPixelFormat() const {
 void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::Surface *surf,
                                     Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform) {
 	if (_disableDirtyRects) {
-		RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, transform);
+		RenderTicket *ticket = createTicket(owner, surf, srcRect, dstRect, transform);
 		ticket->_wantsDraw = true;
 		_renderQueue.push_back(ticket);
 		drawFromSurface(ticket);
@@ -288,7 +295,7 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 			}
 		}
 	}
-	RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, transform);
+	RenderTicket *ticket = createTicket(owner, surf, srcRect, dstRect, transform);
 	if (!_disableDirtyRects) {
 		drawFromTicket(ticket);
 	} else {
@@ -298,6 +305,36 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 	}
 }
 
+RenderTicket *BaseRenderOSystem::createTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf,
+                                             Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform) {
+	if (_ticketPool.empty()) {
+		return new RenderTicket(owner, surf, srcRect, dstRect, transform);
+	}
+	RenderTicket *ticket = _ticketPool.back();
+	_ticketPool.pop_back();
+	_ticketPoolSurfaceSize -= ticket->getSurfaceSize();
+	ticket->reset(owner, surf, srcRect, dstRect, transform);
+	return ticket;
+}
+
+void BaseRenderOSystem::releaseTicket(RenderTicket *ticket) {
+	if (_ticketPool.size() >= TICKET_POOL_LIMIT) {
+		delete ticket;
+		return;
+	}
+	// Keep the pixel buffers of small tickets around, as these are
+	// typically animation frames that get replaced on every frame.
+	// The pool only holds on to a limited amount of them in total.
+	const uint32 surfaceSize = ticket->getSurfaceSize();
+	if (surfaceSize > TICKET_POOL_SURFACE_LIMIT || _ticketPoolSurfaceSize + surfaceSize > TICKET_POOL_MEMORY_LIMIT) {
+		ticket->freeSurface();
+	} else {
+		_ticketPoolSurfaceSize += surfaceSize;
+	}
+	ticket->_owner = nullptr;
+	_ticketPool.push_back(ticket);
+}
+
 void BaseRenderOSystem::invalidateTicket(RenderTicket *renderTicket) {
 	addDirtyRect(renderTicket->_dstRect);
 	renderTicket->_isValid = false;
@@ -350,12 +387,36 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 }
 
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
+	Common::Rect region(rect);
+	region.clip(_renderRect);
+	if (region.isEmpty()) {
+		return;
 	}
-	_dirtyRect->clip(_renderRect);
+
+	// Keep the regions disjoint: merge the new one with every region it
+	// touches, or which is close enough that a single rect wastes little.
+	for (uint i = 0; i < _dirtyRects.size();) {
+		const Common::Rect &other = _dirtyRects[i];
+		Common::Rect merged(region);
+		merged.extend(other);
+		const int32 separateArea = (int32)region.width() * region.height() + (int32)other.width() * other.height();
+		if (region.intersects(other) || (int32)merged.width() * merged.height() <= separateArea + separateArea / 4) {
+			region = merged;
+			_dirtyRects.remove_at(i);
+			// The grown region may now touch one of the earlier ones
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+
+	if (_dirtyRects.size() >= DIRTY_REGION_LIMIT) {
+		for (uint i = 0; i < _dirtyRects.size(); i++) {
+			region.extend(_dirtyRects[i]);
+		}
+		_dirtyRects.clear();
+	}
+	_dirtyRects.push_back(region);
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -369,12 +430,12 @@ void BaseRenderOSystem::drawTickets() {
 			RenderTicket *ticket = *it;
 			addDirtyRect((*it)->_dstRect);
 			it = _renderQueue.erase(it);
-			delete ticket;
+			releaseTicket(ticket);
 		} else {
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
+	if (_dirtyRects.empty()) {
 		it = _renderQueue.begin();
 		while (it != _renderQueue.end()) {
 			RenderTicket *ticket = *it;
@@ -384,6 +445,13 @@ void BaseRenderOSystem::drawTickets() {
 		return;
 	}
 
+	// Bounding box of all the dirty regions, to quickly reject the tickets
+	// which are far from any of them
+	Common::Rect dirtyBounds(_dirtyRects[0]);
+	for (uint i = 1; i < _dirtyRects.size(); i++) {
+		dirtyBounds.extend(_dirtyRects[i]);
+	}
+
 	it = _renderQueue.begin();
 	_lastFrameIter = _renderQueue.end();
 	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
@@ -391,36 +459,49 @@ void BaseRenderOSystem::drawTickets() {
 	// Caveat: The FPS-counter will invalidate this.
 	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
 		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
-			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+		if (_dirtyRects.size() != 1 || _dirtyRects[0] != (*it)->_dstRect) {
+			// Apply the clear-color to the dirty rects.
+			for (uint i = 0; i < _dirtyRects.size(); i++) {
+				_renderSurface->fillRect(_dirtyRects[i], _clearColor);
+			}
 		}
 		// Otherwise Do NOT fill.
 	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
+		// Apply the clear-color to the dirty rects.
+		for (uint i = 0; i < _dirtyRects.size(); i++) {
+			_renderSurface->fillRect(_dirtyRects[i], _clearColor);
+		}
 	}
 	for (; it != _renderQueue.end(); ++it) {
 		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
+		if (ticket->_dstRect.intersects(dirtyBounds)) {
+			// The dirty regions are disjoint, so each part of the ticket is drawn only once
+			for (uint i = 0; i < _dirtyRects.size(); i++) {
+				if (!ticket->_dstRect.intersects(_dirtyRects[i])) {
+					continue;
+				}
+				// dstClip is the area we want redrawn.
+				Common::Rect dstClip(ticket->_dstRect);
+				// reduce it to the dirty rect
+				dstClip.clip(_dirtyRects[i]);
+				// we need to keep track of the position to redraw the dirty rect
+				Common::Rect pos(dstClip);
+				int16 offsetX = ticket->_dstRect.left;
+				int16 offsetY = ticket->_dstRect.top;
+				// convert from screen-coords to surface-coords.
+				dstClip.translate(-offsetX, -offsetY);
+
+				drawFromSurface(ticket, &pos, &dstClip);
+				_needsFlip = true;
+			}
 		}
 		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldn't become clear-color)
 		ticket->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen(_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
+	for (uint i = 0; i < _dirtyRects.size(); i++) {
+		const Common::Rect &dirtyRect = _dirtyRects[i];
+		g_system->copyRectToScreen(_renderSurface->getBasePtr(dirtyRect.left, dirtyRect.top), _renderSurface->pitch, dirtyRect.left, dirtyRect.top, dirtyRect.width(), dirtyRect.height());
+	}
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
@@ -429,7 +510,7 @@ void BaseRenderOSystem::drawTickets() {
 			RenderTicket *ticket = *it;
 			addDirtyRect((*it)->_dstRect);
 			it = _renderQueue.erase(it);
-			delete ticket;
+			releaseTicket(ticket);
 		} else {
 			++it;
 		}
@@ -530,7 +611,7 @@ void BaseRenderOSystem::endSaveLoad() {
 	while (it != _renderQueue.end()) {
 		RenderTicket *ticket = *it;
 		it = _renderQueue.erase(it);
-		delete ticket;
+		releaseTicket(ticket);
 	}
 	// HACK: After a save the buffer will be drawn before the scripts get to update it,
 	// so just skip this single frame.
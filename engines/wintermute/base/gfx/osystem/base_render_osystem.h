@@ -30,6 +30,7 @@
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 #include "common/list.h"
 
@@ -54,6 +55,11 @@ class RenderTicket;
  * being equal, this information is then used to check whether the draw order changed,
  * which will then create a need for redrawing, as we draw with an alpha-channel here.
  *
+ * The regions that need redrawing are kept as a short list of disjoint rects,
+ * so that small changes in distant parts of the screen don't force redrawing
+ * everything in between. Tickets that are no longer used are kept in a pool
+ * and recycled for the following draw-calls.
+ *
  * There is also a draw path that draws without tickets, for debugging purposes,
  * as well as to accommodate situations with large enough amounts of draw calls,
  * that there will be too much overhead involved with comparing the generated tickets.
@@ -119,6 +125,14 @@ private:
 	 * @param rect the region to be marked as dirty
 	 */
 	void addDirtyRect(const Common::Rect &rect);
+	/**
+	 * Get a ticket for a draw-call, recycling a pooled one if possible.
+	 */
+	RenderTicket *createTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform);
+	/**
+	 * Return a ticket which is no longer in the queue to the pool.
+	 */
+	void releaseTicket(RenderTicket *ticket);
 	/**
 	 * Traverse the tickets that are dirty, and draw them
 	 */
@@ -127,8 +141,10 @@ private:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+	Common::Array<Common::Rect> _dirtyRects;
 	Common::List<RenderTicket *> _renderQueue;
+	Common::Array<RenderTicket *> _ticketPool;
+	uint32 _ticketPoolSurfaceSize; // Size of the surface copies held by the pooled tickets
 
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
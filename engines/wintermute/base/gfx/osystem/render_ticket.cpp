@@ -38,12 +38,22 @@ namespace Wintermute {
 
 RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf,
                            Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct transform) :
-	        _owner(owner),
-	        _srcRect(*srcRect),
-	        _dstRect(*dstRect),
 	        _isValid(true),
 	        _wantsDraw(true),
-	        _transform(transform) {
+	        _owner(nullptr),
+	        _surface(nullptr) {
+	reset(owner, surf, srcRect, dstRect, transform);
+}
+
+void RenderTicket::reset(BaseSurfaceOSystem *owner, const Graphics::Surface *surf,
+                         Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct transform) {
+	_owner = owner;
+	_srcRect = *srcRect;
+	_dstRect = *dstRect;
+	_isValid = true;
+	_wantsDraw = true;
+	_transform = transform;
+
 	if (surf) {
 		assert(surf->format.bytesPerPixel == 4);
 
@@ -59,27 +69,41 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 		// (Mirroring should most likely be done before rotation. See also
 		// TransformTools.)
 		if (_transform._angle != Graphics::kDefaultAngle) {
+			freeSurface();
 			_surface = temp.rotoscale(transform, owner->_gameRef->getBilinearFiltering());
 		} else if ((dstRect->width() != srcRect->width() ||
 			    dstRect->height() != srcRect->height()) &&
 			    _transform._numTimesX * _transform._numTimesY == 1) {
+			freeSurface();
 			_surface = temp.scale(dstRect->width(), dstRect->height(), owner->_gameRef->getBilinearFiltering());
+		} else if (_surface && _surface->w == temp.w && _surface->h == temp.h && _surface->format == temp.format) {
+			_surface->copyRectToSurface(temp, 0, 0, Common::Rect(temp.w, temp.h));
 		} else {
+			freeSurface();
 			_surface = new Graphics::Surface();
 			_surface->copyFrom(temp);
 		}
 	} else {
-		_surface = nullptr;
+		freeSurface();
 	}
 }
 
 RenderTicket::~RenderTicket() {
+	freeSurface();
+}
+
+void RenderTicket::freeSurface() {
 	if (_surface) {
 		_surface->free();
 		delete _surface;
+		_surface = nullptr;
 	}
 }
 
+uint32 RenderTicket::getSurfaceSize() const {
+	return _surface ? _surface->pitch * _surface->h : 0;
+}
+
 bool RenderTicket::operator==(const RenderTicket &t) const {
 	if ((t._owner != _owner) ||
 		(t._transform != _transform)  ||
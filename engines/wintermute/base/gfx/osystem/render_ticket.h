@@ -51,8 +51,18 @@ class BaseSurfaceOSystem;
 class RenderTicket {
 public:
 	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, Graphics::TransformStruct transform);
-	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()) {}
+	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()), _owner(nullptr), _surface(nullptr) {}
 	~RenderTicket();
+	/**
+	 * Re-initialize the ticket for a new draw-call, so that tickets can be
+	 * recycled instead of reallocated every frame. The pixel buffer of the
+	 * previous surface copy is reused when the new copy has the same size.
+	 */
+	void reset(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct transform);
+	// Frees the copy of the surface data, keeping the ticket itself
+	void freeSurface();
+	// Size of the copy of the surface data held by the ticket, in bytes
+	uint32 getSurfaceSize() const;
 	const Graphics::Surface *getSurface() const { return _surface; }
 	// Non-dirty-rects:
 	void drawToSurface(Graphics::ManagedSurface *_targetSurface) const;
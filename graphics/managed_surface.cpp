@@ -729,6 +729,7 @@ static byte *createPaletteLookup(const Palette *srcPalette, const Palette *dstPa
 			}
 		}
 
+		// Each color is looked up once, which is faster without a PaletteLookup
 		lookup[i] = dstPalette->findBestColor(rSrc, gSrc, bSrc);
 	}
 
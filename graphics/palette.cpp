@@ -188,12 +188,44 @@ void Palette::grab(Palette &p, uint start, uint num) const {
 	memcpy(p._data, _data + 3 * start, 3 * num);
 }
 
+// The smallest and largest weights of the color components in each distance,
+// used to bound the distance between a palette entry and the colors of a cell
+static const struct {
+	int lower[3];
+	int upper[3];
+} distanceWeights[] = {
+	{ { 1, 1, 1 }, { 1, 1, 1 } },   // kColorDistanceEuclidean
+	{ { 3, 5, 2 }, { 3, 5, 2 } },   // kColorDistanceNaive
+	{ { 2, 4, 2 }, { 3, 4, 3 } }    // kColorDistanceRedmean
+};
+
+// Same as the distances of Palette::findBestColor()
+static inline uint32 colorDistance(ColorDistanceMethod method, const byte *color, byte cr, byte cg, byte cb) {
+	int r = color[0] - cr;
+	int g = color[1] - cg;
+	int b = color[2] - cb;
+
+	switch (method) {
+	case kColorDistanceEuclidean:
+		return r * r + g * g + b * b;
+	case kColorDistanceNaive:
+		return 3 * r * r + 5 * g * g + 2 * b * b;
+	case kColorDistanceRedmean:
+	default: {
+		int rmean = (color[0] + cr) / 2;
+		return (((512 + rmean) * r * r) >> 8) + 4 * g * g + (((767 - rmean) * b * b) >> 8);
+	}
+	}
+}
+
 PaletteLookup::PaletteLookup(): _palette(256) {
 	_paletteSize = 0;
+	_method = kColorDistanceRedmean;
 }
 
 PaletteLookup::PaletteLookup(const byte *palette, uint len) : _palette(256) {
 	_paletteSize = len;
+	_method = kColorDistanceRedmean;
 
 	_palette.set(palette, 0, len);
 }
@@ -205,7 +237,8 @@ bool PaletteLookup::setPalette(const byte *palette, uint len)  {
 
 	_paletteSize = len;
 	_palette.set(palette, 0, len);
-	_colorHash.clear();
+	_cells.clear();
+	_candidates.clear();
 
 	return true;
 }
@@ -216,17 +249,81 @@ byte PaletteLookup::findBestColor(byte cr, byte cg, byte cb, ColorDistanceMethod
 		return 0;
 	}
 
-	uint32 color = cr << 16 | cg << 8 | cb;
-
-	if (_colorHash.contains(color))
-		return _colorHash[color];
+	if (method != _method) {
+		_method = method;
+		_cells.clear();
+		_candidates.clear();
+	}
 
-	uint bestColor = _palette.findBestColor(cr, cg, cb, method);
-	_colorHash[color] = bestColor;
+	const Cell &cell = getCell(cr, cg, cb);
+	const byte *candidate = &_candidates[cell.offset];
+	const byte *data = _palette.data();
+
+	// The candidates are in palette order, so ties go to the first entry
+	uint bestColor = candidate[0];
+	uint32 min = colorDistance(method, data + 3 * bestColor, cr, cg, cb);
+	for (uint i = 1; i < cell.count && min != 0; i++) {
+		uint32 dist = colorDistance(method, data + 3 * candidate[i], cr, cg, cb);
+		if (dist < min) {
+			bestColor = candidate[i];
+			min = dist;
+		}
+	}
 
 	return bestColor;
 }
 
+const PaletteLookup::Cell &PaletteLookup::getCell(byte r, byte g, byte b) {
+	if (_cells.empty())
+		_cells.resize(kCellCount);
+
+	const int shift = 8 - kCellBits;
+	Cell &cell = _cells[(((r >> shift) << kCellBits | (g >> shift)) << kCellBits) | (b >> shift)];
+	if (cell.count == 0)
+		buildCell(cell, r, g, b);
+
+	return cell;
+}
+
+void PaletteLookup::buildCell(Cell &cell, byte r, byte g, byte b) {
+	const byte color[3] = { r, g, b };
+	const int *lowerWeights = distanceWeights[_method].lower;
+	const int *upperWeights = distanceWeights[_method].upper;
+	const byte *data = _palette.data();
+
+	// Every color of the cell is at most minUpper away from some entry, so
+	// the entries which are further than that from the whole cell are never
+	// the closest one
+	uint32 lower[256];
+	uint32 minUpper = 0xFFFFFFFF;
+
+	for (uint i = 0; i < _paletteSize; i++) {
+		uint32 lowerDist = 0, upperDist = 0;
+
+		for (int c = 0; c < 3; c++) {
+			int low = color[c] & ~(kCellSize - 1);
+			int high = low + kCellSize - 1;
+			int value = data[3 * i + c];
+
+			int nearest = value < low ? low - value : (value > high ? value - high : 0);
+			int farthest = MAX(value - low, high - value);
+
+			lowerDist += lowerWeights[c] * nearest * nearest;
+			upperDist += upperWeights[c] * farthest * farthest;
+		}
+
+		lower[i] = lowerDist;
+		minUpper = MIN(minUpper, upperDist);
+	}
+
+	cell.offset = _candidates.size();
+	for (uint i = 0; i < _paletteSize; i++) {
+		if (lower[i] <= minUpper)
+			_candidates.push_back(i);
+	}
+	cell.count = _candidates.size() - cell.offset;
+}
+
 uint32 *PaletteLookup::createMap(const byte *srcPalette, uint len, ColorDistanceMethod method) {
 	if (len <= _paletteSize && memcmp(_palette.data(), srcPalette, len * 3) == 0)
 		return nullptr;
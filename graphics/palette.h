@@ -22,6 +22,7 @@
 #ifndef GRAPHICS_PALETTE_H
 #define GRAPHICS_PALETTE_H
 
+#include "common/array.h"
 #include "common/hashmap.h"
 #include "common/types.h"
 
@@ -183,6 +184,21 @@ public:
 	void grab(Palette &p, uint start, uint num) const;
 };
 
+/**
+ * @brief Finds the closest colors of a palette.
+ *
+ * The RGB cube is split into cells, and each cell keeps the palette entries
+ * which can be the closest one to any of its colors. A lookup then only
+ * compares the color against the few candidates of its cell instead of the
+ * whole palette, while giving the same result as Palette::findBestColor().
+ * The candidates of a cell are gathered the first time one of its colors is
+ * looked up, and dropped when the palette or the distance method changes.
+ *
+ * Gathering the candidates of a cell costs about as much as a scan of the
+ * whole palette, so this only pays off when the lookup is kept for many
+ * colors, like the pixels of a frame. Mapping a few hundred colors once,
+ * like one palette to another, is faster with Palette::findBestColor().
+ */
 class PaletteLookup {
 public:
 	PaletteLookup();
@@ -207,7 +223,7 @@ public:
 
 	/**
 	 * @brief This method returns closest color from the palette
-	 *        and it uses cache for faster lookups
+	 *        and it uses the candidates of the color's cell for faster lookups
 	 *
 	 * @param method           the method used to determine the closest color
 	 *
@@ -228,9 +244,25 @@ public:
 	uint32 *createMap(const byte *srcPalette, uint len, ColorDistanceMethod method = kColorDistanceRedmean);
 
 private:
+	enum {
+		kCellBits = 4,      // per color component
+		kCellSize = 1 << (8 - kCellBits),
+		kCellCount = 1 << (3 * kCellBits)
+	};
+
+	struct Cell {
+		uint32 offset;      // of the candidates in _candidates
+		uint16 count;       // 0 until the candidates are gathered
+	};
+
+	const Cell &getCell(byte r, byte g, byte b);
+	void buildCell(Cell &cell, byte r, byte g, byte b);
+
 	Palette _palette;
 	uint _paletteSize;
-	Common::HashMap<int, byte> _colorHash;
+	ColorDistanceMethod _method;
+	Common::Array<Cell> _cells;
+	Common::Array<byte> _candidates;
 };
 
 } //  // end of namespace Graphics
@@ -0,0 +1,583 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/crc.h"
+#include "common/endian.h"
+#include "common/fs.h"
+#include "common/stream.h"
+
+#include "gui/ThemeCache.h"
+#include "gui/ThemeEval.h"
+#include "gui/ThemeParser.h"
+
+namespace GUI {
+
+#define THEME_CACHE_TAG MKTAG('S', 'T', 'H', 'C')
+#define THEME_CACHE_VERSION 2
+
+// Converts between native and little endian pixels, which is the same swap
+// both ways. It does nothing on little endian machines.
+static void swapPixelsLE(byte *pixels, int count, int bytesPerPixel) {
+	switch (bytesPerPixel) {
+	case 2:
+		for (int i = 0; i < count; ++i, pixels += 2)
+			WRITE_LE_UINT16(pixels, READ_UINT16(pixels));
+		break;
+	case 3:
+		for (int i = 0; i < count; ++i, pixels += 3)
+			WRITE_LE_UINT24(pixels, READ_UINT24(pixels));
+		break;
+	case 4:
+		for (int i = 0; i < count; ++i, pixels += 4)
+			WRITE_LE_UINT32(pixels, READ_UINT32(pixels));
+		break;
+	default:
+		break;
+	}
+}
+
+void ThemeCache::recordDrawData(const Common::String &data, bool cached) {
+	_ops.writeByte(kOpDrawData);
+	writeString(data);
+	_ops.writeByte(cached);
+}
+
+void ThemeCache::recordDrawStep(const Common::String &drawDataId, const Graphics::DrawStep &step, const Common::String &bitmap) {
+	const char *function = ThemeParser::getDrawingFunctionName(step.drawingCall);
+	assert(function);
+
+	_ops.writeByte(kOpDrawStep);
+	writeString(drawDataId);
+	writeString(function);
+	writeString(bitmap);
+	_ops.writeByte(step.alphaType);
+	writeColor(step.fgColor);
+	writeColor(step.bgColor);
+	writeColor(step.gradColor1);
+	writeColor(step.gradColor2);
+	writeColor(step.bevelColor);
+	_ops.writeByte(step.autoWidth);
+	_ops.writeByte(step.autoHeight);
+	_ops.writeSint16LE(step.x);
+	_ops.writeSint16LE(step.y);
+	_ops.writeSint16LE(step.w);
+	_ops.writeSint16LE(step.h);
+	writeRect(step.padding);
+	writeRect(step.clip);
+	_ops.writeByte(step.xAlign);
+	_ops.writeByte(step.yAlign);
+	_ops.writeByte(step.shadow);
+	_ops.writeByte(step.stroke);
+	_ops.writeByte(step.factor);
+	_ops.writeByte(step.radius);
+	_ops.writeByte(step.bevel);
+	_ops.writeByte(step.fillMode);
+	_ops.writeByte(step.shadowFillMode);
+	_ops.writeUint32LE(step.extraData);
+	_ops.writeUint32LE(step.scale);
+	_ops.writeUint32LE(step.shadowIntensity);
+	_ops.writeByte(step.autoscale);
+}
+
+void ThemeCache::recordTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, ThemeEngine::TextAlignVertical alignV) {
+	_ops.writeByte(kOpTextData);
+	writeString(drawDataId);
+	_ops.writeSint32LE(textId);
+	_ops.writeSint32LE(colorId);
+	_ops.writeSint32LE(alignH);
+	_ops.writeSint32LE(alignV);
+}
+
+void ThemeCache::recordFont(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, int pointsize) {
+	_ops.writeByte(kOpFont);
+	_ops.writeSint32LE(textId);
+	writeString(language);
+	writeString(file);
+	writeString(scalableFile);
+	_ops.writeSint32LE(pointsize);
+}
+
+void ThemeCache::recordFontNames(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, int pointsize) {
+	_ops.writeByte(kOpFontNames);
+	_ops.writeSint32LE(textId);
+	writeString(language);
+	writeString(file);
+	writeString(scalableFile);
+	_ops.writeSint32LE(pointsize);
+}
+
+void ThemeCache::recordTextColor(TextColor colorId, int r, int g, int b) {
+	_ops.writeByte(kOpTextColor);
+	_ops.writeSint32LE(colorId);
+	_ops.writeSint32LE(r);
+	_ops.writeSint32LE(g);
+	_ops.writeSint32LE(b);
+}
+
+void ThemeCache::recordBitmap(const Common::String &filename, const Graphics::ManagedSurface *surf) {
+	const Graphics::PixelFormat &format = surf->format;
+
+	_ops.writeByte(kOpBitmap);
+	writeString(filename);
+	_ops.writeByte(format.bytesPerPixel);
+	_ops.writeByte(format.rLoss);
+	_ops.writeByte(format.gLoss);
+	_ops.writeByte(format.bLoss);
+	_ops.writeByte(format.aLoss);
+	_ops.writeByte(format.rShift);
+	_ops.writeByte(format.gShift);
+	_ops.writeByte(format.bShift);
+	_ops.writeByte(format.aShift);
+	_ops.writeUint16LE(surf->w);
+	_ops.writeUint16LE(surf->h);
+	_ops.writeByte(surf->hasTransparentColor());
+	_ops.writeUint32LE(surf->hasTransparentColor() ? surf->getTransparentColor() : 0);
+
+	const int rowSize = surf->w * format.bytesPerPixel;
+	byte *row = (byte *)malloc(rowSize);
+	for (int y = 0; y < surf->h; ++y) {
+		memcpy(row, surf->getBasePtr(0, y), rowSize);
+		swapPixelsLE(row, surf->w, format.bytesPerPixel);
+		_ops.write(row, rowSize);
+	}
+	free(row);
+}
+
+void ThemeCache::recordCursor(const Common::String &filename, int hotspotX, int hotspotY) {
+	_ops.writeByte(kOpCursor);
+	writeString(filename);
+	_ops.writeSint32LE(hotspotX);
+	_ops.writeSint32LE(hotspotY);
+}
+
+void ThemeCache::recordVar(const Common::String &name, int val) {
+	_ops.writeByte(kOpVar);
+	writeString(name);
+	_ops.writeSint32LE(val);
+}
+
+void ThemeCache::recordDialog(const Common::String &name, const Common::String &overlays, int16 maxWidth, int16 maxHeight, int inset) {
+	_ops.writeByte(kOpDialog);
+	writeString(name);
+	writeString(overlays);
+	_ops.writeSint16LE(maxWidth);
+	_ops.writeSint16LE(maxHeight);
+	_ops.writeSint32LE(inset);
+}
+
+void ThemeCache::recordLayout(ThemeLayout::LayoutType type, int spacing, ThemeLayout::ItemAlign itemAlign) {
+	_ops.writeByte(kOpLayout);
+	_ops.writeSint32LE(type);
+	_ops.writeSint32LE(spacing);
+	_ops.writeSint32LE(itemAlign);
+}
+
+void ThemeCache::recordWidget(const Common::String &name, const Common::String &type, int w, int h, Graphics::TextAlign align, bool useRTL) {
+	_ops.writeByte(kOpWidget);
+	writeString(name);
+	writeString(type);
+	_ops.writeSint32LE(w);
+	_ops.writeSint32LE(h);
+	_ops.writeSint32LE(align);
+	_ops.writeByte(useRTL);
+}
+
+void ThemeCache::recordImportedLayout(const Common::String &name) {
+	_ops.writeByte(kOpImportedLayout);
+	writeString(name);
+}
+
+void ThemeCache::recordSpace(int size) {
+	_ops.writeByte(kOpSpace);
+	_ops.writeSint32LE(size);
+}
+
+void ThemeCache::recordPadding(int16 l, int16 r, int16 t, int16 b) {
+	_ops.writeByte(kOpPadding);
+	_ops.writeSint16LE(l);
+	_ops.writeSint16LE(r);
+	_ops.writeSint16LE(t);
+	_ops.writeSint16LE(b);
+}
+
+void ThemeCache::recordCloseLayout() {
+	_ops.writeByte(kOpCloseLayout);
+}
+
+void ThemeCache::recordCloseDialog() {
+	_ops.writeByte(kOpCloseDialog);
+}
+
+static void writeKey(Common::WriteStream &stream, const ThemeCache::Key &key) {
+	uint32 scaleFactor;
+	memcpy(&scaleFactor, &key.scaleFactor, sizeof(scaleFactor));
+
+	stream.writeUint32LE(key.contentHash);
+	stream.writeUint32LE(scaleFactor);
+	stream.writeSint16LE(key.baseWidth);
+	stream.writeSint16LE(key.baseHeight);
+	stream.writeByte(key.format.bytesPerPixel);
+	stream.writeByte(key.format.rLoss);
+	stream.writeByte(key.format.gLoss);
+	stream.writeByte(key.format.bLoss);
+	stream.writeByte(key.format.aLoss);
+	stream.writeByte(key.format.rShift);
+	stream.writeByte(key.format.gShift);
+	stream.writeByte(key.format.bShift);
+	stream.writeByte(key.format.aShift);
+}
+
+bool ThemeCache::save(const Common::FSNode &node, const Key &key) {
+	Common::SeekableWriteStream *stream = node.createWriteStream();
+	if (!stream)
+		return false;
+
+	bool result = save(*stream, key);
+	stream->finalize();
+	delete stream;
+
+	return result;
+}
+
+bool ThemeCache::save(Common::WriteStream &stream, const Key &key) {
+	_ops.writeByte(kOpEnd);
+
+	Common::CRC32 crc;
+	Common::MemoryWriteStreamDynamic header(DisposeAfterUse::YES);
+	header.writeUint32BE(THEME_CACHE_TAG);
+	header.writeUint32BE(THEME_CACHE_VERSION);
+	writeKey(header, key);
+	header.writeUint32LE(_ops.size());
+	header.writeUint32LE(crc.crcFast(_ops.getData(), _ops.size()));
+
+	stream.write(header.getData(), header.size());
+	stream.write(_ops.getData(), _ops.size());
+	return stream.flush() && !stream.err();
+}
+
+bool ThemeCache::load(const Common::FSNode &node, const Key &key, ThemeEngine *engine) {
+	if (!node.exists())
+		return false;
+
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream)
+		return false;
+
+	bool result = load(*stream, key, engine);
+	delete stream;
+
+	return result;
+}
+
+bool ThemeCache::load(Common::SeekableReadStream &stream, const Key &key, ThemeEngine *engine) {
+	// Compare the whole header at once
+	Common::MemoryWriteStreamDynamic expected(DisposeAfterUse::YES);
+	expected.writeUint32BE(THEME_CACHE_TAG);
+	expected.writeUint32BE(THEME_CACHE_VERSION);
+	writeKey(expected, key);
+
+	byte *header = new byte[expected.size()];
+	bool valid = stream.read(header, expected.size()) == expected.size() &&
+		memcmp(header, expected.getData(), expected.size()) == 0;
+	delete[] header;
+
+	const uint32 size = stream.readUint32LE();
+	const uint32 checksum = stream.readUint32LE();
+	if (!valid || stream.eos() || size > stream.size() - stream.pos())
+		return false;
+
+	byte *payload = (byte *)malloc(size);
+	valid = stream.read(payload, size) == size;
+
+	Common::CRC32 crc;
+	if (!valid || crc.crcFast(payload, size) != checksum) {
+		free(payload);
+		return false;
+	}
+
+	// The theme is rebuilt as the ops are read, so one that can't be
+	// replayed leaves a partial theme behind
+	Common::MemoryReadStream ops(payload, size, DisposeAfterUse::YES);
+	if (!replay(ops, engine)) {
+		engine->resetThemeData();
+		return false;
+	}
+
+	return true;
+}
+
+bool ThemeCache::replay(Common::SeekableReadStream &stream, ThemeEngine *engine) {
+	ThemeEval *eval = engine->getEvaluator();
+
+	while (!stream.eos()) {
+		const byte op = stream.readByte();
+
+		switch (op) {
+		case kOpEnd:
+			return true;
+
+		case kOpDrawData: {
+			Common::String data = readString(stream);
+			if (!engine->addDrawData(data, stream.readByte()))
+				return false;
+			break;
+		}
+
+		case kOpDrawStep: {
+			Graphics::DrawStep step;
+			Common::String drawDataId = readString(stream);
+			step.drawingCall = ThemeParser::getDrawingFunctionCallback(readString(stream));
+			Common::String bitmap = readString(stream);
+			if (!bitmap.empty())
+				step.blitSrc = engine->getImageSurface(bitmap);
+			if (!step.drawingCall || (!bitmap.empty() && !step.blitSrc))
+				return false;
+			step.alphaType = (Graphics::AlphaType)stream.readByte();
+			readColor(stream, step.fgColor);
+			readColor(stream, step.bgColor);
+			readColor(stream, step.gradColor1);
+			readColor(stream, step.gradColor2);
+			readColor(stream, step.bevelColor);
+			step.autoWidth = stream.readByte();
+			step.autoHeight = stream.readByte();
+			step.x = stream.readSint16LE();
+			step.y = stream.readSint16LE();
+			step.w = stream.readSint16LE();
+			step.h = stream.readSint16LE();
+			readRect(stream, step.padding);
+			readRect(stream, step.clip);
+			step.xAlign = (Graphics::DrawStep::VectorAlignment)stream.readByte();
+			step.yAlign = (Graphics::DrawStep::VectorAlignment)stream.readByte();
+			step.shadow = stream.readByte();
+			step.stroke = stream.readByte();
+			step.factor = stream.readByte();
+			step.radius = stream.readByte();
+			step.bevel = stream.readByte();
+			step.fillMode = stream.readByte();
+			step.shadowFillMode = stream.readByte();
+			step.extraData = stream.readUint32LE();
+			step.scale = stream.readUint32LE();
+			step.shadowIntensity = stream.readUint32LE();
+			step.autoscale = (ThemeEngine::AutoScaleMode)stream.readByte();
+			engine->addDrawStep(drawDataId, step);
+			break;
+		}
+
+		case kOpTextData: {
+			Common::String drawDataId = readString(stream);
+			TextData textId = (TextData)stream.readSint32LE();
+			TextColor colorId = (TextColor)stream.readSint32LE();
+			Graphics::TextAlign alignH = (Graphics::TextAlign)stream.readSint32LE();
+			ThemeEngine::TextAlignVertical alignV = (ThemeEngine::TextAlignVertical)stream.readSint32LE();
+			if (!engine->addTextData(drawDataId, textId, colorId, alignH, alignV))
+				return false;
+			break;
+		}
+
+		case kOpFont:
+		case kOpFontNames: {
+			TextData textId = (TextData)stream.readSint32LE();
+			Common::String language = readString(stream);
+			Common::String file = readString(stream);
+			Common::String scalableFile = readString(stream);
+			int pointsize = stream.readSint32LE();
+			if (op == kOpFontNames)
+				engine->storeFontNames(textId, language, file, scalableFile, pointsize);
+			else if (!engine->addFont(textId, language, file, scalableFile, pointsize))
+				return false;
+			break;
+		}
+
+		case kOpTextColor: {
+			TextColor colorId = (TextColor)stream.readSint32LE();
+			int r = stream.readSint32LE();
+			int g = stream.readSint32LE();
+			int b = stream.readSint32LE();
+			if (!engine->addTextColor(colorId, r, g, b))
+				return false;
+			break;
+		}
+
+		case kOpBitmap:
+			if (!readBitmap(stream, engine))
+				return false;
+			break;
+
+		case kOpCursor: {
+			Common::String filename = readString(stream);
+			int hotspotX = stream.readSint32LE();
+			int hotspotY = stream.readSint32LE();
+			if (!engine->createCursor(filename, hotspotX, hotspotY))
+				return false;
+			break;
+		}
+
+		case kOpVar: {
+			Common::String name = readString(stream);
+			eval->setVar(name, stream.readSint32LE());
+			break;
+		}
+
+		case kOpDialog: {
+			Common::String name = readString(stream);
+			Common::String overlays = readString(stream);
+			int16 maxWidth = stream.readSint16LE();
+			int16 maxHeight = stream.readSint16LE();
+			eval->addDialog(name, overlays, maxWidth, maxHeight, stream.readSint32LE());
+			break;
+		}
+
+		case kOpLayout: {
+			ThemeLayout::LayoutType type = (ThemeLayout::LayoutType)stream.readSint32LE();
+			int spacing = stream.readSint32LE();
+			eval->addLayout(type, spacing, (ThemeLayout::ItemAlign)stream.readSint32LE());
+			break;
+		}
+
+		case kOpWidget: {
+			Common::String name = readString(stream);
+			Common::String type = readString(stream);
+			int w = stream.readSint32LE();
+			int h = stream.readSint32LE();
+			Graphics::TextAlign align = (Graphics::TextAlign)stream.readSint32LE();
+			eval->addWidget(name, type, w, h, align, stream.readByte());
+			break;
+		}
+
+		case kOpImportedLayout: {
+			Common::String name = readString(stream);
+			if (!eval->hasDialog(name))
+				return false;
+			eval->addImportedLayout(name);
+			break;
+		}
+
+		case kOpSpace:
+			eval->addSpace(stream.readSint32LE());
+			break;
+
+		case kOpPadding: {
+			int16 l = stream.readSint16LE();
+			int16 r = stream.readSint16LE();
+			int16 t = stream.readSint16LE();
+			eval->addPadding(l, r, t, stream.readSint16LE());
+			break;
+		}
+
+		case kOpCloseLayout:
+			eval->closeLayout();
+			break;
+
+		case kOpCloseDialog:
+			eval->closeDialog();
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	return false;
+}
+
+bool ThemeCache::readBitmap(Common::SeekableReadStream &stream, ThemeEngine *engine) {
+	Common::String filename = readString(stream);
+
+	Graphics::PixelFormat format;
+	format.bytesPerPixel = stream.readByte();
+	format.rLoss = stream.readByte();
+	format.gLoss = stream.readByte();
+	format.bLoss = stream.readByte();
+	format.aLoss = stream.readByte();
+	format.rShift = stream.readByte();
+	format.gShift = stream.readByte();
+	format.bShift = stream.readByte();
+	format.aShift = stream.readByte();
+	const uint16 w = stream.readUint16LE();
+	const uint16 h = stream.readUint16LE();
+	const bool transparent = stream.readByte();
+	const uint32 transparentColor = stream.readUint32LE();
+
+	// Bitmaps are kept over refreshes of the theme
+	if (engine->getImageSurface(filename)) {
+		stream.skip(w * h * format.bytesPerPixel);
+		return !stream.eos();
+	}
+
+	Graphics::ManagedSurface *surf = new Graphics::ManagedSurface(w, h, format);
+	for (int y = 0; y < h; ++y) {
+		byte *row = (byte *)surf->getBasePtr(0, y);
+		stream.read(row, w * format.bytesPerPixel);
+		swapPixelsLE(row, w, format.bytesPerPixel);
+	}
+
+	if (stream.eos()) {
+		delete surf;
+		return false;
+	}
+
+	if (transparent)
+		surf->setTransparentColor(transparentColor);
+
+	engine->_bitmaps[filename] = surf;
+	return true;
+}
+
+void ThemeCache::writeString(const Common::String &str) {
+	_ops.writeUint16LE(str.size());
+	_ops.writeString(str);
+}
+
+void ThemeCache::writeColor(const Graphics::DrawStep::Color &color) {
+	_ops.writeByte(color.r);
+	_ops.writeByte(color.g);
+	_ops.writeByte(color.b);
+	_ops.writeByte(color.set);
+}
+
+void ThemeCache::writeRect(const Common::Rect &rect) {
+	_ops.writeSint16LE(rect.left);
+	_ops.writeSint16LE(rect.top);
+	_ops.writeSint16LE(rect.right);
+	_ops.writeSint16LE(rect.bottom);
+}
+
+Common::String ThemeCache::readString(Common::SeekableReadStream &stream) {
+	const uint16 size = stream.readUint16LE();
+	return stream.readString(0, size);
+}
+
+void ThemeCache::readColor(Common::SeekableReadStream &stream, Graphics::DrawStep::Color &color) {
+	color.r = stream.readByte();
+	color.g = stream.readByte();
+	color.b = stream.readByte();
+	color.set = stream.readByte();
+}
+
+void ThemeCache::readRect(Common::SeekableReadStream &stream, Common::Rect &rect) {
+	rect.left = stream.readSint16LE();
+	rect.top = stream.readSint16LE();
+	rect.right = stream.readSint16LE();
+	rect.bottom = stream.readSint16LE();
+}
+
+} // End of namespace GUI
@@ -0,0 +1,145 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GUI_THEME_CACHE_H
+#define GUI_THEME_CACHE_H
+
+#include "common/scummsys.h"
+#include "common/memstream.h"
+#include "common/str.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/VectorRenderer.h"
+
+#include "gui/ThemeEngine.h"
+#include "gui/ThemeLayout.h"
+
+namespace Common {
+class FSNode;
+}
+
+namespace GUI {
+
+/**
+ * Binary cache of a parsed theme.
+ *
+ * While the STX files of a theme are parsed, every call the parser makes
+ * into the ThemeEngine and the ThemeEval is recorded, together with the
+ * pixels of the bitmaps loaded at the current scale. Replaying the
+ * recording rebuilds the same draw data, colors, fonts and layouts without
+ * parsing any XML or decoding and scaling the bitmaps again.
+ *
+ * The parse result depends on the theme contents, the scale factor, the
+ * base resolution and the overlay format, so a cache file is only used
+ * when all of them match the ones it was recorded with. Everything is
+ * stored little endian, pixels included.
+ */
+class ThemeCache {
+public:
+	struct Key {
+		uint32 contentHash;
+		float scaleFactor;
+		int16 baseWidth;
+		int16 baseHeight;
+		Graphics::PixelFormat format;
+	};
+
+	ThemeCache() : _ops(DisposeAfterUse::YES) {}
+
+	void recordDrawData(const Common::String &data, bool cached);
+	void recordDrawStep(const Common::String &drawDataId, const Graphics::DrawStep &step, const Common::String &bitmap);
+	void recordTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, ThemeEngine::TextAlignVertical alignV);
+	void recordFont(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, int pointsize);
+	void recordFontNames(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, int pointsize);
+	void recordTextColor(TextColor colorId, int r, int g, int b);
+	void recordBitmap(const Common::String &filename, const Graphics::ManagedSurface *surf);
+	void recordCursor(const Common::String &filename, int hotspotX, int hotspotY);
+
+	void recordVar(const Common::String &name, int val);
+	void recordDialog(const Common::String &name, const Common::String &overlays, int16 maxWidth, int16 maxHeight, int inset);
+	void recordLayout(ThemeLayout::LayoutType type, int spacing, ThemeLayout::ItemAlign itemAlign);
+	void recordWidget(const Common::String &name, const Common::String &type, int w, int h, Graphics::TextAlign align, bool useRTL);
+	void recordImportedLayout(const Common::String &name);
+	void recordSpace(int size);
+	void recordPadding(int16 l, int16 r, int16 t, int16 b);
+	void recordCloseLayout();
+	void recordCloseDialog();
+
+	/**
+	 * Write the recording to a cache file.
+	 *
+	 * @param node File to write.
+	 * @param key  Parameters the theme was parsed with.
+	 */
+	bool save(const Common::FSNode &node, const Key &key);
+	bool save(Common::WriteStream &stream, const Key &key);
+
+	/**
+	 * Rebuild a theme from a cache file.
+	 *
+	 * If the file turns out to be unusable partway through, the theme data
+	 * rebuilt so far is reset again.
+	 *
+	 * @return false if there is no usable cache file for the key, in which
+	 *         case the theme has to be parsed.
+	 */
+	static bool load(const Common::FSNode &node, const Key &key, ThemeEngine *engine);
+	static bool load(Common::SeekableReadStream &stream, const Key &key, ThemeEngine *engine);
+
+private:
+	enum Op {
+		kOpEnd,
+		kOpDrawData,
+		kOpDrawStep,
+		kOpTextData,
+		kOpFont,
+		kOpFontNames,
+		kOpTextColor,
+		kOpBitmap,
+		kOpCursor,
+		kOpVar,
+		kOpDialog,
+		kOpLayout,
+		kOpWidget,
+		kOpImportedLayout,
+		kOpSpace,
+		kOpPadding,
+		kOpCloseLayout,
+		kOpCloseDialog
+	};
+
+	void writeString(const Common::String &str);
+	void writeColor(const Graphics::DrawStep::Color &color);
+	void writeRect(const Common::Rect &rect);
+
+	static bool replay(Common::SeekableReadStream &stream, ThemeEngine *engine);
+	static bool readBitmap(Common::SeekableReadStream &stream, ThemeEngine *engine);
+	static Common::String readString(Common::SeekableReadStream &stream);
+	static void readColor(Common::SeekableReadStream &stream, Graphics::DrawStep::Color &color);
+	static void readRect(Common::SeekableReadStream &stream, Common::Rect &rect);
+
+	Common::MemoryWriteStreamDynamic _ops;
+};
+
+} // End of namespace GUI
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "common/system.h"
 #include "common/config-manager.h"
+#include "common/crc.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/compression/unzip.h"
@@ -41,6 +42,7 @@
 #include "image/png.h"
 
 #include "gui/widget.h"
+#include "gui/ThemeCache.h"
 #include "gui/ThemeEngine.h"
 #include "gui/ThemeEval.h"
 #include "gui/ThemeParser.h"
@@ -189,7 +191,7 @@ ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(nullptr), _vectorRenderer(nullptr),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
 	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
-	_cursor(nullptr), _scaleFactor(1.0f) {
+	_cursor(nullptr), _scaleFactor(1.0f), _cacheRecorder(nullptr) {
 
 	_baseWidth = 640;	// Default sane values
 	_baseHeight = 480;
@@ -507,10 +509,26 @@ void ThemeEngine::addDrawStep(const Common::String &drawDataId, const Graphics::
 	DrawData id = parseDrawDataId(drawDataId);
 
 	assert(id != kDDNone && _widgets[id] != nullptr);
+
+	if (_cacheRecorder) {
+		// The cache refers to the bitmap by its file name
+		Common::String bitmap;
+		for (auto &i : _bitmaps) {
+			if (step.blitSrc && i._value == step.blitSrc) {
+				bitmap = i._key;
+				break;
+			}
+		}
+		_cacheRecorder->recordDrawStep(drawDataId, step, bitmap);
+	}
+
 	_widgets[id]->_steps.push_back(step);
 }
 
 bool ThemeEngine::addTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, TextAlignVertical alignV) {
+	if (_cacheRecorder)
+		_cacheRecorder->recordTextData(drawDataId, textId, colorId, alignH, alignV);
+
 	DrawData id = parseDrawDataId(drawDataId);
 
 	if (id == -1 || textId == -1 || colorId == kTextColorMAX || !_widgets[id])
@@ -525,6 +543,9 @@ bool ThemeEngine::addTextData(const Common::String &drawDataId, TextData textId,
 }
 
 bool ThemeEngine::addFont(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, const int pointsize) {
+	if (_cacheRecorder)
+		_cacheRecorder->recordFont(textId, language, file, scalableFile, pointsize);
+
 	if (textId == -1)
 		return false;
 
@@ -604,6 +625,9 @@ Common::Array<Common::Language> getLangIdentifiers(const Common::String &languag
 }
 
 void ThemeEngine::storeFontNames(TextData textId, const Common::String &language, const Common::String &file, const Common::String &scalableFile, const int pointsize) {
+	if (_cacheRecorder)
+		_cacheRecorder->recordFontNames(textId, language, file, scalableFile, pointsize);
+
 	if (language.empty())
 		return;
 
@@ -630,6 +654,9 @@ bool ThemeEngine::loadExtraFont(FontStyle style, Common::Language lang) {
 }
 
 bool ThemeEngine::addTextColor(TextColor colorId, int r, int g, int b) {
+	if (_cacheRecorder)
+		_cacheRecorder->recordTextColor(colorId, r, g, b);
+
 	if (colorId >= kTextColorMAX)
 		return false;
 
@@ -646,6 +673,17 @@ bool ThemeEngine::addTextColor(TextColor colorId, int r, int g, int b) {
 }
 
 bool ThemeEngine::addBitmap(const Common::String &filename, const Common::String &scalablefile, int width, int height) {
+	if (!loadBitmap(filename, scalablefile, width, height))
+		return false;
+
+	// The cache keeps the pixels so the bitmap is not decoded and scaled again
+	if (_cacheRecorder)
+		_cacheRecorder->recordBitmap(filename, _bitmaps[filename]);
+
+	return true;
+}
+
+bool ThemeEngine::loadBitmap(const Common::String &filename, const Common::String &scalablefile, int width, int height) {
 	// Nothing has to be done if the bitmap already has been loaded.
 	Graphics::ManagedSurface *surf = _bitmaps[filename];
 	if (surf) {
@@ -738,6 +776,9 @@ bool ThemeEngine::addBitmap(const Common::String &filename, const Common::String
 }
 
 bool ThemeEngine::addDrawData(const Common::String &data, bool cached) {
+	if (_cacheRecorder)
+		_cacheRecorder->recordDrawData(data, cached);
+
 	DrawData id = parseDrawDataId(data);
 
 	if (id == -1)
@@ -789,6 +830,11 @@ void ThemeEngine::unloadTheme() {
 	if (!_themeOk)
 		return;
 
+	resetThemeData();
+	_themeOk = false;
+}
+
+void ThemeEngine::resetThemeData() {
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = nullptr;
@@ -808,7 +854,6 @@ void ThemeEngine::unloadTheme() {
 	}
 
 	_themeEval->reset();
-	_themeOk = false;
 }
 
 void ThemeEngine::unloadExtraFont() {
@@ -887,30 +932,132 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 	}
 
 	//
-	// Loop over all STX files, load and parse them
+	// Read all STX files, their contents are part of the cache key
 	//
+	Common::Array<byte *> stxData;
+	Common::Array<uint32> stxSize;
+	Common::CRC32 crc;
+	ThemeCache::Key key;
+	key.contentHash = crc.crcFast((const byte *)stxHeader.c_str(), stxHeader.size());
+	key.scaleFactor = _scaleFactor;
+	key.baseWidth = _baseWidth;
+	key.baseHeight = _baseHeight;
+	key.format = _overlayFormat;
+
 	for (auto &member : members) {
 		assert(member->getName().hasSuffix(".stx"));
 
-		if (_parser->loadStream(member->createReadStream()) == false) {
+		Common::SeekableReadStream *stream = member->createReadStream();
+		byte *data = stream ? (byte *)malloc(stream->size()) : nullptr;
+		if (!data || stream->read(data, stream->size()) != stream->size()) {
 			warning("Failed to load STX file '%s'", member->getName().c_str());
-			_parser->close();
+			delete stream;
+			free(data);
+			for (uint i = 0; i < stxData.size(); ++i)
+				free(stxData[i]);
 			return false;
 		}
 
+		stxData.push_back(data);
+		stxSize.push_back(stream->size());
+		key.contentHash = key.contentHash * 31 + Common::hashit(member->getName().c_str()) + crc.crcFast(data, stream->size());
+		delete stream;
+	}
+
+	//
+	// The cache also holds the bitmaps, so the other files are part of the
+	// key too. The archive lists them in no fixed order, so their hashes
+	// are added up.
+	//
+	Common::ArchiveMemberList files;
+	_themeArchive->listMembers(files);
+	uint32 filesHash = 0;
+	for (auto &file : files) {
+		if (file->isDirectory() || file->getName().hasSuffix(".stx"))
+			continue;
+
+		Common::SeekableReadStream *stream = file->createReadStream();
+		if (!stream)
+			continue;
+
+		const uint32 size = stream->size();
+		byte *data = (byte *)malloc(size);
+		if (data && stream->read(data, size) == size)
+			filesHash += Common::hashit(file->getName().c_str()) * 31 + crc.crcFast(data, size);
+		else
+			filesHash += Common::hashit(file->getName().c_str());
+		free(data);
+		delete stream;
+	}
+	key.contentHash = key.contentHash * 31 + filesHash;
+
+	Common::FSNode cacheNode;
+	const bool useCache = getThemeCacheNode(cacheNode);
+	// A cache file that fails to load leaves nothing behind to parse over
+	if (useCache && ThemeCache::load(cacheNode, key, this)) {
+		debug(6, "Loaded theme '%s' from its cache", themeId.c_str());
+		for (uint i = 0; i < stxData.size(); ++i)
+			free(stxData[i]);
+		return true;
+	}
+
+	//
+	// Loop over all STX files and parse them, recording the result for the cache
+	//
+	ThemeCache recorder;
+	if (useCache) {
+		_cacheRecorder = &recorder;
+		_themeEval->setCacheRecorder(&recorder);
+	}
+
+	bool result = true;
+	uint i = 0;
+	for (auto &member : members) {
+		// The parser frees the data
+		_parser->loadBuffer(stxData[i], stxSize[i], DisposeAfterUse::YES);
+		++i;
+
 		if (_parser->parse() == false) {
 			warning("Failed to parse STX file '%s'", member->getName().c_str());
-			_parser->close();
-			return false;
+			result = false;
 		}
 
 		_parser->close();
+
+		if (!result)
+			break;
 	}
 
+	for (; i < stxData.size(); ++i)
+		free(stxData[i]);
+
+	_cacheRecorder = nullptr;
+	_themeEval->setCacheRecorder(nullptr);
+
+	if (!result)
+		return false;
+
+	if (useCache && !recorder.save(cacheNode, key))
+		debug(6, "Couldn't write the cache of theme '%s'", themeId.c_str());
+
 	assert(!_themeName.empty());
 	return true;
 }
 
+bool ThemeEngine::getThemeCacheNode(Common::FSNode &node) const {
+	// The cache is stored next to the theme, so only themes with a location
+	// in the file system are cached
+	if (_themeFile.empty())
+		return false;
+
+	Common::FSNode themeNode(_themeFile);
+	if (!themeNode.exists())
+		return false;
+
+	node = themeNode.getParent().getChild(themeNode.getName() + ".stc");
+	return true;
+}
+
 
 
 /**********************************************************
@@ -1580,6 +1727,9 @@ void ThemeEngine::applyScreenShading(ShadingStyle style) {
 }
 
 bool ThemeEngine::createCursor(const Common::String &filename, int hotspotX, int hotspotY) {
+	if (_cacheRecorder)
+		_cacheRecorder->recordCursor(filename, hotspotX, hotspotY);
+
 	// Try to locate the specified file among all loaded bitmaps
 	const Graphics::ManagedSurface *cursor = _bitmaps[filename];
 	if (!cursor)
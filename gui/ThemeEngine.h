@@ -51,6 +51,7 @@ struct WidgetDrawData;
 struct TextDrawData;
 class Dialog;
 class GuiObject;
+class ThemeCache;
 class ThemeEval;
 class ThemeParser;
 
@@ -212,6 +213,7 @@ protected:
 
 	friend class GUI::Dialog;
 	friend class GUI::GuiObject;
+	friend class GUI::ThemeCache;
 
 public:
 	/// Vertical alignment of the text.
@@ -675,6 +677,17 @@ protected:
 	 */
 	bool loadThemeXML(const Common::String &themeId);
 
+	/**
+	 * Get the binary cache file of the current theme, which keeps the
+	 * result of parsing its STX files.
+	 *
+	 * @returns false if the theme can't be cached.
+	 */
+	bool getThemeCacheNode(Common::FSNode &node) const;
+
+	/** Decode a bitmap and scale it for the current scale factor. */
+	bool loadBitmap(const Common::String &filename, const Common::String &scalablefile, int width, int height);
+
 	/**
 	 * Loads the default theme file (the embedded XML file found
 	 * in ThemeDefaultXML.cpp).
@@ -688,6 +701,12 @@ protected:
 	 */
 	void unloadTheme();
 
+	/**
+	 * Deletes the draw data, fonts, text colors and layouts of the theme.
+	 * The bitmaps are kept, as for a refresh.
+	 */
+	void resetThemeData();
+
 	/**
 	 * Unload the language specific font loaded via loadExtraFont()
 	*/
@@ -802,6 +821,9 @@ protected:
 
 	ImagesMap _bitmaps;
 	Graphics::PixelFormat _overlayFormat;
+
+	/** Records the theme while it is parsed, to write its binary cache. */
+	ThemeCache *_cacheRecorder;
 	Graphics::PixelFormat _cursorFormat;
 
 	/** List of all the dirty screens that must be blitted to the overlay. */
@@ -34,13 +34,15 @@
 
 namespace GUI {
 
+class ThemeCache;
+
 class ThemeEval {
 
 	typedef Common::HashMap<Common::String, int> VariablesMap;
 	typedef Common::HashMap<Common::String, ThemeLayout *> LayoutsMap;
 
 public:
-	ThemeEval() : _scaleFactor(1.0f) {
+	ThemeEval() : _scaleFactor(1.0f), _cacheRecorder(nullptr) {
 		buildBuiltinVars();
 	}
 
@@ -71,7 +73,10 @@ public:
 
 	void setScaleFactor(float s) { _scaleFactor = s; }
 
-	void setVar(const Common::String &name, int val) { _vars[name] = val; }
+	/** Record all changes made by the theme parser into the given theme cache. */
+	void setCacheRecorder(ThemeCache *recorder) { _cacheRecorder = recorder; }
+
+	void setVar(const Common::String &name, int val);
 
 	bool hasVar(const Common::String &name) { return _vars.contains(name) || _builtin.contains(name); }
 
@@ -83,8 +88,8 @@ public:
 
 	ThemeEval &addPadding(int16 l, int16 r, int16 t, int16 b);
 
-	ThemeEval &closeLayout() { _curLayout.pop(); return *this; }
-	ThemeEval &closeDialog() { _curLayout.pop(); _curDialog.clear(); return *this; }
+	ThemeEval &closeLayout();
+	ThemeEval &closeDialog();
 
 	bool hasDialog(const Common::String &name);
 
@@ -120,6 +125,8 @@ private:
 	Common::String _curDialog;
 
 	float _scaleFactor;
+
+	ThemeCache *_cacheRecorder;
 };
 
 } // End of namespace GUI
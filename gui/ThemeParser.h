@@ -25,6 +25,8 @@
 #include "common/scummsys.h"
 #include "common/formats/xmlparser.h"
 
+#include "graphics/VectorRenderer.h"
+
 namespace GUI {
 
 class ThemeEngine;
@@ -52,6 +54,12 @@ public:
 		return true;
 	}
 
+	/** Look up the drawing function for a "func" value of a draw step, or nullptr. */
+	static Graphics::DrawingFunctionCallback getDrawingFunctionCallback(const Common::String &name);
+
+	/** The "func" value selecting the given drawing function, or nullptr. */
+	static const char *getDrawingFunctionName(Graphics::DrawingFunctionCallback callback);
+
 protected:
 	ThemeEngine *_theme;
 
@@ -127,54 +127,9 @@ static Common::String buildQualifiedGameName(const Common::String &engineId, con
 	return Common::String::format("%s:%s", engineId.c_str(), gameId.c_str());
 }
 
-bool LauncherFilterMatcher(void *boss, int idx, const Common::U32String &item, const Common::U32String &token_) {
-	bool invert = false;
-	Common::U32String token(token_);
-
-	while (token.size() && token[0] == '!') {
-		token = token.substr(1);
-		invert = !invert;
-	}
-
-	bool result = false;
-	Common::String token8 = token;
-	size_t pos = token8.findFirstOf(":=~");
-	if (pos != token8.npos) {
-		Common::String key = token8.substr(0, token8.findFirstOf(token8[pos]));
-		Common::String filter = token8.substr(token8.findFirstOf(token8[pos]) + 1);
-
-		if (key.size()) {
-			if (Common::String("description").hasPrefix(key)) {
-				key = "description";
-			} else if (Common::String("engineid").hasPrefix(key)) {
-				key = "engineid";
-			} else if (Common::String("gameid").hasPrefix(key)) {
-				key = "gameid";
-			} else if (Common::String("language").hasPrefix(key)) {
-				key = "language";
-			} else if (Common::String("path").hasPrefix(key)) {
-				key = "path";
-			} else if (Common::String("platform").hasPrefix(key)) {
-				key = "platform";
-			}
-		}
-
-		LauncherDialog *launcher = (LauncherDialog *)(boss);
-		Common::String data = launcher->getGameConfig(idx, key);
-		data.toLowercase();
-
-		if (token8[pos] == ':') {
-			result = data.contains(filter);
-		} else if (token8[pos] == '=') {
-			result = data == filter;
-		} else if (token8[pos] == '~') {
-			result = data.matchString(filter);
-		}
-	} else {
-		result = item.contains(token);
-	}
-
-	return invert ? !result : result;
+static void LauncherFilterSearcher(void *boss, const Common::U32String &filter, Common::Array<bool> &matches) {
+	LauncherDialog *launcher = (LauncherDialog *)(boss);
+	launcher->searchTargets(filter, matches);
 }
 
 LauncherDialog::LauncherDialog(const Common::String &dialogName)
@@ -439,11 +394,8 @@ void LauncherDialog::massAddGame() {
 	}
 }
 
-Common::String LauncherDialog::getGameConfig(int item, Common::String key) {
-	if (ConfMan.hasKey(key, _domains[item])) {
-		return ConfMan.get(key, _domains[item]);
-	}
-	return "";
+void LauncherDialog::searchTargets(const Common::U32String &filter, Common::Array<bool> &matches) const {
+	_searchIndex.search(filter, matches);
 }
 
 void LauncherDialog::removeGame(int item) {
@@ -1096,7 +1048,7 @@ void LauncherSimple::build() {
 	_list->setEditable(false);
 	_list->enableDictionarySelect(true);
 	_list->setNumberingMode(kListNumberingOff);
-	_list->setFilterMatcher(LauncherFilterMatcher, this);
+	_list->setFilterSearcher(LauncherFilterSearcher, this);
 
 	// Populate the list
 	updateListing();
@@ -1120,6 +1072,7 @@ void LauncherSimple::updateListing(int selPos) {
 
 	// Turn it into a sorted list of entries
 	Common::Array<LauncherEntry> domainList = generateEntries(domains);
+	_searchIndex.update(domainList, false);
 
 	// And fill out our structures
 	for (const auto &curDomain : domainList) {
@@ -1543,6 +1496,7 @@ void LauncherGrid::handleCommand(CommandSender *sender, uint32 cmd, uint32 data)
 		reflowLayout();
 		break;
 	case kIconsSetLoadedCmd:
+		_grid->invalidateIcons();
 		rebuild();
 		break;
 	default:
@@ -1557,6 +1511,8 @@ void LauncherGrid::updateListing(int selPos) {
 
 	// Turn it into a sorted list of entries
 	Common::Array<LauncherEntry> domainList = generateEntries(domains);
+	// The grid shows the titles, so words are matched against them as before
+	_searchIndex.update(domainList, true);
 
 	Common::Array<GridItemInfo> gridList;
 
@@ -1633,6 +1589,9 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	_grid->setFilterSearcher(LauncherFilterSearcher, this);
+	// Shows the icons once they are loaded, even if the grid is not focused
+	setTickleWidget(_grid);
 	// Populate the list
 	updateListing();
 
@@ -32,6 +32,7 @@
 
 #include "gui/dialog.h"
 #include "gui/widgets/popup.h"
+#include "gui/launchersearch.h"
 #include "gui/MetadataParser.h"
 
 #include "engines/game.h"
@@ -121,7 +122,7 @@ public:
 	void handleKeyUp(Common::KeyState state) override;
 	void handleOtherEvent(const Common::Event &evt) override;
 	bool doGameDetection(const Common::Path &path);
-	Common::String getGameConfig(int item, Common::String key);
+	void searchTargets(const Common::U32String &filter, Common::Array<bool> &matches) const;
 protected:
 	EditTextWidget  *_searchWidget;
 #ifndef DISABLE_FANCY_THEMES
@@ -145,6 +146,7 @@ protected:
 	Common::String	_title;
 	Common::String	_search;
 	MetadataParser	_metadataParser;
+	LauncherSearchIndex	_searchIndex;
 
 #ifndef DISABLE_LAUNCHERDISPLAY_GRID
 	ButtonWidget		*_listButton;
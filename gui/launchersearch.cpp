@@ -0,0 +1,312 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gui/launchersearch.h"
+#include "gui/launcher.h"
+
+#include "common/algorithm.h"
+#include "common/config-manager.h"
+#include "common/tokenizer.h"
+
+namespace GUI {
+
+// In the order in which abbreviated keys are resolved
+static const char *const fieldNames[] = {
+	"description",
+	"engineid",
+	"gameid",
+	"language",
+	"path",
+	"platform"
+};
+
+static bool matchValue(const Common::String &data, char op, const Common::String &filter) {
+	if (op == ':')
+		return data.contains(filter);
+	else if (op == '=')
+		return data == filter;
+	else
+		return data.matchString(filter);
+}
+
+LauncherSearchIndex::LauncherSearchIndex() {
+	STATIC_ASSERT(ARRAYSIZE(fieldNames) == kFieldCount, fieldNames_must_match_Field);
+}
+
+bool LauncherSearchIndex::isIndexedField(int field) {
+	// Descriptions are indexed by their grams, paths are rarely searched
+	return field != kFieldDescription && field != kFieldPath;
+}
+
+uint64 LauncherSearchIndex::makeGram(const Common::U32String &text, uint pos, uint length) {
+	// Code points fit into 21 bits. They are offset by one, so grams of
+	// different lengths never have the same value.
+	uint64 gram = 0;
+	for (uint i = 0; i < length; ++i)
+		gram = (gram << 21) | ((text[pos + i] + 1) & 0x1FFFFF);
+	return gram;
+}
+
+void LauncherSearchIndex::removePosting(Postings &postings, uint slot) {
+	// The order of the postings does not matter
+	for (uint i = 0; i < postings.size(); ++i) {
+		if (postings[i] == slot) {
+			postings[i] = postings.back();
+			postings.pop_back();
+			return;
+		}
+	}
+}
+
+void LauncherSearchIndex::update(const Common::Array<LauncherEntry> &entries, bool matchTitles) {
+	for (auto &target : _targets)
+		target.item = -1;
+
+	_items.resize(entries.size());
+
+	for (uint i = 0; i < entries.size(); ++i) {
+		const LauncherEntry &entry = entries[i];
+		const Common::String &name = matchTitles ? entry.title : entry.description;
+
+		Common::String values[kFieldCount];
+		for (int field = 0; field < kFieldCount; ++field)
+			entry.domain->tryGetVal(fieldNames[field], values[field]);
+
+		uint slot;
+		bool changed = true;
+		if (_slots.tryGetVal(entry.key, slot)) {
+			// Only index the target again if its configuration changed
+			changed = _targets[slot].name != name;
+			for (int field = 0; field < kFieldCount && !changed; ++field)
+				changed = _targets[slot].values[field] != values[field];
+
+			if (changed)
+				removeTarget(slot);
+		} else if (!_freeSlots.empty()) {
+			slot = _freeSlots.back();
+			_freeSlots.pop_back();
+			_slots[entry.key] = slot;
+		} else {
+			slot = _targets.size();
+			_targets.push_back(Target());
+			_slots[entry.key] = slot;
+		}
+
+		if (changed) {
+			Target &target = _targets[slot];
+			target.key = entry.key;
+			target.name = name;
+			target.text = Common::U32String(name);
+			target.text.toLowercase();
+			for (int field = 0; field < kFieldCount; ++field) {
+				target.values[field] = values[field];
+				target.lowerValues[field] = values[field];
+				target.lowerValues[field].toLowercase();
+			}
+			addTarget(slot);
+		}
+
+		_targets[slot].item = i;
+		_items[i] = slot;
+	}
+
+	// Drop the targets which are not listed anymore
+	for (uint slot = 0; slot < _targets.size(); ++slot) {
+		Target &target = _targets[slot];
+		if (target.key.empty() || target.item != -1)
+			continue;
+
+		removeTarget(slot);
+		_slots.erase(target.key);
+		target = Target();
+		_freeSlots.push_back(slot);
+	}
+}
+
+void LauncherSearchIndex::addTarget(uint slot) {
+	const Target &target = _targets[slot];
+
+	for (uint length = 1; length <= kMaxGramLength; ++length) {
+		for (uint i = 0; i + length <= target.text.size(); ++i) {
+			Postings &postings = _grams[makeGram(target.text, i, length)];
+			// Grams occurring more than once are only added once
+			if (postings.empty() || postings.back() != slot)
+				postings.push_back(slot);
+		}
+	}
+
+	for (int field = 0; field < kFieldCount; ++field) {
+		if (isIndexedField(field))
+			_values[field][target.lowerValues[field]].push_back(slot);
+	}
+}
+
+void LauncherSearchIndex::removeTarget(uint slot) {
+	const Target &target = _targets[slot];
+
+	for (uint length = 1; length <= kMaxGramLength; ++length) {
+		for (uint i = 0; i + length <= target.text.size(); ++i) {
+			GramMap::iterator it = _grams.find(makeGram(target.text, i, length));
+			if (it == _grams.end())
+				continue;
+
+			removePosting(it->_value, slot);
+			if (it->_value.empty())
+				_grams.erase(it);
+		}
+	}
+
+	for (int field = 0; field < kFieldCount; ++field) {
+		if (!isIndexedField(field))
+			continue;
+
+		ValueMap::iterator it = _values[field].find(target.lowerValues[field]);
+		if (it == _values[field].end())
+			continue;
+
+		removePosting(it->_value, slot);
+		if (it->_value.empty())
+			_values[field].erase(it);
+	}
+}
+
+void LauncherSearchIndex::search(const Common::U32String &filter, Common::Array<bool> &matches) const {
+	matches.resize(_items.size());
+	Common::fill(matches.begin(), matches.end(), true);
+
+	Common::U32StringTokenizer tok(filter);
+	Common::Array<bool> hits;
+	hits.resize(_items.size());
+
+	while (!tok.empty()) {
+		Common::U32String token = tok.nextToken();
+
+		bool invert = false;
+		uint start = 0;
+		while (start < token.size() && token[start] == '!') {
+			invert = !invert;
+			start++;
+		}
+
+		Common::fill(hits.begin(), hits.end(), false);
+		matchToken(token.substr(start), hits);
+
+		for (uint i = 0; i < hits.size(); ++i) {
+			if (hits[i] == invert)
+				matches[i] = false;
+		}
+	}
+}
+
+void LauncherSearchIndex::matchToken(const Common::U32String &token, Common::Array<bool> &hits) const {
+	Common::String token8 = token;
+	size_t pos = token8.findFirstOf(":=~");
+	if (pos == Common::String::npos) {
+		matchText(token, hits);
+		return;
+	}
+
+	Common::String key = token8.substr(0, pos);
+	Common::String filter = token8.substr(pos + 1);
+
+	if (!key.empty()) {
+		for (int field = 0; field < kFieldCount; ++field) {
+			if (Common::String(fieldNames[field]).hasPrefix(key)) {
+				matchField(field, token8[pos], filter, hits);
+				return;
+			}
+		}
+	}
+
+	// Any other key is looked up in the configuration
+	for (uint i = 0; i < _items.size(); ++i) {
+		const Common::String &domain = _targets[_items[i]].key;
+		Common::String data;
+		if (ConfMan.hasKey(key, domain))
+			data = ConfMan.get(key, domain);
+		data.toLowercase();
+
+		hits[i] = matchValue(data, token8[pos], filter);
+	}
+}
+
+void LauncherSearchIndex::matchField(int field, char op, const Common::String &filter, Common::Array<bool> &hits) const {
+	if (!isIndexedField(field)) {
+		for (uint i = 0; i < _items.size(); ++i)
+			hits[i] = matchValue(_targets[_items[i]].lowerValues[field], op, filter);
+		return;
+	}
+
+	if (op == '=') {
+		ValueMap::const_iterator it = _values[field].find(filter);
+		if (it != _values[field].end())
+			markPostings(it->_value, hits);
+		return;
+	}
+
+	// There are far fewer distinct values than targets
+	for (const auto &value : _values[field]) {
+		if (matchValue(value._key, op, filter))
+			markPostings(value._value, hits);
+	}
+}
+
+void LauncherSearchIndex::matchText(const Common::U32String &token, Common::Array<bool> &hits) const {
+	if (token.empty()) {
+		Common::fill(hits.begin(), hits.end(), true);
+		return;
+	}
+
+	// Short tokens are grams themselves
+	if (token.size() <= kMaxGramLength) {
+		GramMap::const_iterator it = _grams.find(makeGram(token, 0, token.size()));
+		if (it != _grams.end())
+			markPostings(it->_value, hits);
+		return;
+	}
+
+	// Only the names containing the least common trigram of the
+	// token can contain the token
+	const Postings *candidates = nullptr;
+	for (uint i = 0; i + kMaxGramLength <= token.size(); ++i) {
+		GramMap::const_iterator it = _grams.find(makeGram(token, i, kMaxGramLength));
+		if (it == _grams.end())
+			return;
+
+		if (!candidates || it->_value.size() < candidates->size())
+			candidates = &it->_value;
+	}
+
+	for (const auto &slot : *candidates) {
+		const Target &target = _targets[slot];
+		if (target.item != -1 && target.text.contains(token))
+			hits[target.item] = true;
+	}
+}
+
+void LauncherSearchIndex::markPostings(const Postings &postings, Common::Array<bool> &hits) const {
+	for (const auto &slot : postings) {
+		if (_targets[slot].item != -1)
+			hits[_targets[slot].item] = true;
+	}
+}
+
+} // End of namespace GUI
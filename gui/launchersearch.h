@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GUI_LAUNCHERSEARCH_H
+#define GUI_LAUNCHERSEARCH_H
+
+#include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+#include "common/ustr.h"
+
+namespace GUI {
+
+struct LauncherEntry;
+
+/**
+ * Index of the targets listed by the launcher, used to filter them as the
+ * search query is typed.
+ *
+ * The descriptions or titles are indexed by the groups of up to three
+ * characters they contain, and the targets by their engine, game, language and
+ * platform, so a query only looks at the targets which can match it.
+ * Targets are kept across updates of the listing and only indexed again
+ * when their configuration changed.
+ *
+ * The query is split into words, which all have to match:
+ *  - "word" matches the targets whose description contains word, or whose
+ *    title does when titles are matched.
+ *  - "key:value" matches if the value of key contains value, "key=value"
+ *    if it is value and "key~value" if it matches the pattern value.
+ *    Keys can be abbreviated for description, engineid, gameid, language,
+ *    path and platform. Other keys are looked up in the configuration.
+ *  - "!word" matches the targets which word does not match.
+ */
+class LauncherSearchIndex {
+public:
+	LauncherSearchIndex();
+
+	/**
+	 * Update the index for the entries listed by the launcher. The position
+	 * of an entry in the array is its item number in search results.
+	 *
+	 * @param entries      The entries listed by the launcher.
+	 * @param matchTitles  Whether words are matched against the titles of
+	 *                     the entries, as the grid shows them, instead of
+	 *                     their descriptions.
+	 */
+	void update(const Common::Array<LauncherEntry> &entries, bool matchTitles);
+
+	/**
+	 * Find the items matching a query.
+	 *
+	 * @param filter   The query, in lowercase.
+	 * @param matches  Set to whether each item matches.
+	 */
+	void search(const Common::U32String &filter, Common::Array<bool> &matches) const;
+
+private:
+	enum Field {
+		kFieldDescription,
+		kFieldEngineId,
+		kFieldGameId,
+		kFieldLanguage,
+		kFieldPath,
+		kFieldPlatform,
+		kFieldCount
+	};
+
+	struct Target {
+		Common::String key;
+		Common::String name; // The description or title
+		Common::String values[kFieldCount];
+		// Lowercase copies of the above, which the query is matched against
+		Common::U32String text;
+		Common::String lowerValues[kFieldCount];
+		int item;
+	};
+
+	enum {
+		kMaxGramLength = 3
+	};
+
+	struct GramHash {
+		uint operator()(uint64 gram) const { return (uint)(gram ^ (gram >> 29)); }
+	};
+
+	typedef Common::Array<uint> Postings;
+	typedef Common::HashMap<uint64, Postings, GramHash> GramMap;
+	typedef Common::HashMap<Common::String, Postings> ValueMap;
+	typedef Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SlotMap;
+
+	static bool isIndexedField(int field);
+	static uint64 makeGram(const Common::U32String &text, uint pos, uint length);
+	static void removePosting(Postings &postings, uint slot);
+
+	void addTarget(uint slot);
+	void removeTarget(uint slot);
+	void matchToken(const Common::U32String &token, Common::Array<bool> &hits) const;
+	void matchField(int field, char op, const Common::String &filter, Common::Array<bool> &hits) const;
+	void matchText(const Common::U32String &token, Common::Array<bool> &hits) const;
+	void markPostings(const Postings &postings, Common::Array<bool> &hits) const;
+
+	// Targets are stored in slots, which are kept when the listing changes
+	Common::Array<Target> _targets;
+	Common::Array<uint> _freeSlots;
+	SlotMap _slots;
+	// Slot of each item of the listing
+	Common::Array<uint> _items;
+
+	GramMap _grams;
+	ValueMap _values[kFieldCount];
+};
+
+} // End of namespace GUI
+
+#endif
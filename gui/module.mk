@@ -16,6 +16,7 @@ MODULE_OBJS := \
 	helpdialog.o \
 	imagealbum-dialog.o \
 	launcher.o \
+	launchersearch.o \
 	massadd.o \
 	message.o \
 	MetadataParser.o \
@@ -27,6 +28,7 @@ MODULE_OBJS := \
 	shaderbrowser-dialog.o \
 	textviewer.o \
 	themebrowser.o \
+	ThemeCache.o \
 	ThemeEngine.o \
 	ThemeEval.o \
 	ThemeLayout.o \
@@ -40,6 +42,7 @@ MODULE_OBJS := \
 	widgets/editable.o \
 	widgets/edittext.o \
 	widgets/grid.o \
+	widgets/gridicons.o \
 	widgets/groupedlist.o \
 	widgets/list.o \
 	widgets/popup.o \
@@ -28,6 +28,7 @@
 
 #include "gui/gui-manager.h"
 #include "gui/widgets/grid.h"
+#include "gui/widgets/gridicons.h"
 
 #include "gui/ThemeEval.h"
 
@@ -47,12 +48,13 @@ void GridItemWidget::setActiveEntry(GridItemInfo &entry) {
 }
 
 void GridItemWidget::updateThumb() {
-	const Graphics::ManagedSurface *gfx = _grid->filenameToSurface(_activeEntry->thumbPath);
+	Graphics::AlphaType alphaType;
+	const Graphics::ManagedSurface *gfx = _grid->thumbnailToSurface(*_activeEntry, alphaType);
 	_thumbGfx.free();
 	if (gfx) {
 		// TODO: Use a reference instead of copying the surface
 		_thumbGfx.copyFrom(*gfx);
-		_thumbAlpha = _thumbGfx.detectAlpha();
+		_thumbAlpha = alphaType;
 	}
 }
 
@@ -110,7 +112,7 @@ void GridItemWidget::drawWidget() {
 
 	// Draw Thumbnail
 	if (_thumbGfx.empty()) {
-		// Draw Title when thumbnail is missing
+		// Draw Title when thumbnail is missing or not loaded yet
 		int linesInThumb = MIN(thumbHeight / kLineHeight, (int)titleLines.size());
 		Common::Rect r(_x, _y + (thumbHeight - linesInThumb * kLineHeight) / 2,
 					   _x + thumbWidth, _y + (thumbHeight - linesInThumb * kLineHeight) / 2 + kLineHeight);
@@ -351,55 +353,6 @@ void GridItemTray::handleMouseMoved(int x, int y, int button) {
 
 #pragma mark -
 
-// Load an image file by String name, provide additional render dimensions for SVG images.
-// TODO: Add BMP support, and add scaling of non-vector images.
-Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int renderWidth = 0, int renderHeight = 0) {
-	Common::Path path(name);
-	Graphics::ManagedSurface *surf = nullptr;
-	if (name.hasSuffix(".png")) {
-#ifdef USE_PNG
-		const Graphics::Surface *srcSurface = nullptr;
-		Image::PNGDecoder decoder;
-		g_gui.lockIconsSet();
-		if (g_gui.getIconsSet().hasFile(path)) {
-			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(path);
-			if (!decoder.loadStream(*stream)) {
-				g_gui.unlockIconsSet();
-				warning("Error decoding PNG");
-				return surf;
-			}
-
-			srcSurface = decoder.getSurface();
-			delete stream;
-			if (!srcSurface) {
-				warning("Failed to load surface : %s", name.c_str());
-			} else if (srcSurface->format.bytesPerPixel != 1) {
-				surf = new Graphics::ManagedSurface();
-				surf->copyFrom(*srcSurface);
-			}
-		} else {
-			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
-		}
-		g_gui.unlockIconsSet();
-#else
-		error("No PNG support compiled");
-#endif
-	} else if (name.hasSuffix(".svg")) {
-		g_gui.lockIconsSet();
-		if (g_gui.getIconsSet().hasFile(path)) {
-			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(path);
-			surf = new Graphics::SVGBitmap(stream, renderWidth, renderHeight);
-			delete stream;
-		} else {
-			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
-		}
-		g_gui.unlockIconsSet();
-	}
-	return surf;
-}
-
-#pragma mark -
-
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	: ContainerWidget(boss, name), CommandSender(boss) {
 
@@ -412,6 +365,10 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	_extraIconHeight = 0;
 	_extraIconWidth = 0;
 	_disabledIconOverlay = nullptr;
+	_iconLoader = GridIconLoader::acquire();
+	_loadedIcons = 0;
+	_filterSearcher = nullptr;
+	_filterSearcherArg = nullptr;
 
 	_minGridXSpacing = 0;
 	_minGridYSpacing = 0;
@@ -445,57 +402,52 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 
 	_selectedEntry = nullptr;
 	_isGridInvalid = true;
+
+	setFlags(WIDGET_WANT_TICKLE);
 }
 
 GridWidget::~GridWidget() {
-	unloadSurfaces(_platformIcons);
-	unloadSurfaces(_languageIcons);
-	unloadSurfaces(_extraIcons);
-	unloadSurfaces(_loadedSurfaces);
+	GridIconLoader::release();
 	delete _disabledIconOverlay;
 	_gridItems.clear();
 	_dataEntryList.clear();
 	_headerEntryList.clear();
 	_sortedEntryList.clear();
 	_visibleEntryList.clear();
-	_platformIconsAlpha.clear();
-	_languageIconsAlpha.clear();
-	_extraIconsAlpha.clear();
-}
-
-template<typename T>
-void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurface *> &surfaces) {
-	for (typename Common::HashMap<T, const Graphics::ManagedSurface *>::iterator i = surfaces.begin(); i != surfaces.end(); ++i) {
-		delete i->_value;
-	}
-	surfaces.clear();
 }
 
-const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
-	if (name.empty())
+const Graphics::ManagedSurface *GridWidget::thumbnailToSurface(const GridItemInfo &entry, Graphics::AlphaType &alphaType) {
+	if (entry.thumbPath.empty())
 		return nullptr;
-	return _loadedSurfaces[name];
+	// Use the icon of the engine if there is none for the game
+	Common::String fallback = Common::String::format("icons/%s.png", entry.engineid.c_str());
+	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+	return _iconLoader->getIcon(entry.thumbPath, fallback, thumbnailWidth, thumbnailHeight, alphaType);
 }
 
 const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language languageCode, Graphics::AlphaType &alphaType) {
-	if (languageCode == Common::UNK_LANG)
+	const char *code = Common::getLanguageCode(languageCode);
+	if (languageCode == Common::UNK_LANG || !code)
 		return nullptr;
-	alphaType = _languageIconsAlpha[languageCode];
-	return _languageIcons[languageCode];
+	// If no .svg flag is available, search for a .png
+	return _iconLoader->getIcon(Common::String::format("icons/flags/%s.svg", code), Common::String::format("icons/flags/%s.png", code),
+								_flagIconWidth, _flagIconHeight, alphaType);
 }
 
 const Graphics::ManagedSurface *GridWidget::platformToSurface(Common::Platform platformCode, Graphics::AlphaType &alphaType) {
-	if (platformCode == Common::kPlatformUnknown)
+	const char *code = Common::getPlatformCode(platformCode);
+	if (platformCode == Common::kPlatformUnknown || !code)
 		return nullptr;
-	alphaType = _platformIconsAlpha[platformCode];
-	return _platformIcons[platformCode];
+	return _iconLoader->getIcon(Common::String::format("icons/platforms/%s.png", code), Common::String(),
+								_platformIconWidth, _platformIconHeight, alphaType);
 }
 
 const Graphics::ManagedSurface *GridWidget::demoToSurface(const Common::String &extraString, Graphics::AlphaType &alphaType) {
 	if (! extraString.contains("Demo") )
 		return nullptr;
-	alphaType = _extraIconsAlpha[0];
-	return _extraIcons[0];
+	// For now only the demo icon is available
+	return _iconLoader->getIcon("icons/extra/demo.svg", "icons/extra/demo.png", _extraIconWidth, _extraIconHeight, alphaType);
 }
 
 const Graphics::ManagedSurface *GridWidget::disabledThumbnail() {
@@ -584,6 +536,15 @@ void GridWidget::sortGroups() {
 				}
 			}
 		}
+	} else if (_filterSearcher) {
+		// With filter don't display any group header
+		Common::Array<bool> matches;
+		_filterSearcher(_filterSearcherArg, _filter, matches);
+
+		for (GridItemInfo *i = _dataEntryList.begin(); i != _dataEntryList.end(); ++i) {
+			if (i->entryID < (int)matches.size() && matches[i->entryID])
+				_sortedEntryList.push_back(i);
+		}
 	} else {
 		// With filter don't display any group header
 		// Restrict the list to everything which contains all words in _filter
@@ -698,114 +659,15 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 }
 
 void GridWidget::reloadThumbnails() {
-	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
-	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
-	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
-		GridItemInfo *entry = *iter;
-		if (entry->thumbPath.empty())
-			continue;
-
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
-			_loadedSurfaces[entry->thumbPath] = nullptr;
-			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
-				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
-					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					// TODO: Use SharedPtr instead of duplicating the surface
-					Graphics::ManagedSurface *thSurf = new Graphics::ManagedSurface();
-					thSurf->copyFrom(*scSurf);
-					_loadedSurfaces[entry->thumbPath] = thSurf;
-				}
-			}
-
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
-
-				if (path != entry->thumbPath) {
-					// TODO: Use SharedPtr instead of duplicating the surface
-					Graphics::ManagedSurface *thSurf = new Graphics::ManagedSurface();
-					thSurf->copyFrom(*scSurf);
-					_loadedSurfaces[path] = thSurf;
-				}
-
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
-			}
-		}
-	}
-}
-
-void GridWidget::loadFlagIcons() {
-	const Common::LanguageDescription *l = Common::g_languages;
-	for (; l->code; ++l) {
-		Common::String path = Common::String::format("icons/flags/%s.svg", l->code);
-		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path, _flagIconWidth, _flagIconHeight);
-		if (gfx) {
-			_languageIcons[l->id] = gfx;
-			_languageIconsAlpha[l->id] = gfx->detectAlpha();
-			continue;
-		} // if no .svg flag is available, search for a .png
-		path = Common::String::format("icons/flags/%s.png", l->code);
-		gfx = loadSurfaceFromFile(path);
-		if (gfx) {
-			const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _flagIconWidth, _flagIconHeight, true);
-			_languageIcons[l->id] = scGfx;
-			_languageIconsAlpha[l->id] = gfx->detectAlpha();
-			if (gfx != scGfx) {
-				gfx->free();
-				delete gfx;
-			}
-		} else {
-			_languageIcons[l->id] = nullptr; // nothing found, set to nullptr
-		}
-	}
-}
-
-void GridWidget::loadPlatformIcons() {
-	const Common::PlatformDescription *l = Common::g_platforms;
-	for (; l->code; ++l) {
-		Common::String path = Common::String::format("icons/platforms/%s.png", l->code);
-		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path);
-		if (gfx) {
-			const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _platformIconWidth, _platformIconHeight, true);
-			_platformIcons[l->id] = scGfx;
-			_platformIconsAlpha[l->id] = scGfx->detectAlpha();
-			if (gfx != scGfx) {
-				gfx->free();
-				delete gfx;
-			}
-		} else {
-			_platformIcons[l->id] = nullptr;
-		}
-	}
+	// Queue the thumbnails which are not loaded yet, they are shown by
+	// handleTickle() once the loader is done with them
+	Graphics::AlphaType alphaType;
+	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter)
+		thumbnailToSurface(**iter, alphaType);
 }
 
-void GridWidget::loadExtraIcons() {  // for now only the demo icon is available
-	Graphics::ManagedSurface *gfx = loadSurfaceFromFile("icons/extra/demo.svg", _extraIconWidth, _extraIconHeight);
-	if (gfx) {
-		_extraIcons[0] = gfx;
-		_extraIconsAlpha[0] = gfx->detectAlpha();
-		return;
-	} // if no .svg file is available, search for a .png
-	gfx = loadSurfaceFromFile("icons/extra/demo.png");
-	if (gfx) {
-		const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _extraIconWidth, _extraIconHeight, true);
-		_extraIcons[0] = scGfx;
-		_extraIconsAlpha[0] = scGfx->detectAlpha();
-		if (gfx != scGfx) {
-			gfx->free();
-			delete gfx;
-		}
-	} else {
-		_extraIcons[0] = nullptr;
-	}
+void GridWidget::invalidateIcons() {
+	_iconLoader->invalidate();
 }
 
 void GridWidget::destroyItems() {
@@ -958,6 +820,17 @@ void GridWidget::handleCommand(CommandSender *sender, uint32 cmd, uint32 data) {
 	}
 }
 
+void GridWidget::handleTickle() {
+	const uint32 loadedIcons = _iconLoader->update();
+	if (loadedIcons == _loadedIcons)
+		return;
+	_loadedIcons = loadedIcons;
+
+	// Only the visible items have a valid entry
+	for (uint k = 0; k < _gridItems.size() && k < _visibleEntryList.size(); ++k)
+		_gridItems[k]->update();
+}
+
 void GridWidget::calcInnerHeight() {
 	int row = 0;
 	int col = 0;
@@ -1069,18 +942,8 @@ void GridWidget::reflowLayout() {
 	if ((oldThumbnailHeight != _thumbnailHeight) ||
 		(oldThumbnailWidth != _thumbnailWidth) ||
 		(oldThumbnailMargin != _thumbnailMargin)) {
-		unloadSurfaces(_extraIcons);
-		unloadSurfaces(_platformIcons);
-		unloadSurfaces(_languageIcons);
-		unloadSurfaces(_loadedSurfaces);
-		_platformIconsAlpha.clear();
-		_languageIconsAlpha.clear();
-		_extraIconsAlpha.clear();
+		// Icons of the old size are dropped by the loader once they are not used any more
 		delete _disabledIconOverlay;
-		reloadThumbnails();
-		loadFlagIcons();
-		loadPlatformIcons();
-		loadExtraIcons();
 
 		Graphics::ManagedSurface *gfx = new Graphics::ManagedSurface(_thumbnailWidth, _thumbnailHeight, g_system->getOverlayFormat());
 		uint32 disabledThumbnailColor = gfx->format.ARGBToColor(153, 0, 0, 0);  // 60% opacity black
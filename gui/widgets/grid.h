@@ -33,6 +33,7 @@
 namespace GUI {
 
 class ScrollBarWidget;
+class GridIconLoader;
 class GridItemWidget;
 class GridWidget;
 
@@ -99,15 +100,9 @@ public:
 /* GridWidget */
 class GridWidget : public ContainerWidget, public CommandSender {
 protected:
-	Common::HashMap<int, const Graphics::ManagedSurface *> _platformIcons;
-	Common::HashMap<int, const Graphics::ManagedSurface *> _languageIcons;
-	Common::HashMap<int, const Graphics::ManagedSurface *> _extraIcons;
-	Common::HashMap<int, Graphics::AlphaType> _platformIconsAlpha;
-	Common::HashMap<int, Graphics::AlphaType> _languageIconsAlpha;
-	Common::HashMap<int, Graphics::AlphaType> _extraIconsAlpha;
+	GridIconLoader *_iconLoader;
+	uint32 _loadedIcons;
 	Graphics::ManagedSurface *_disabledIconOverlay;
-	// Images are mapped by filename -> surface.
-	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
@@ -169,13 +164,19 @@ public:
 
 	Common::U32String	_filter;
 
+	/**
+	 * Find the entries matching a whole filter at once, setting
+	 * matches[entryID] for each entry. Without it, the filter is matched
+	 * against the titles.
+	 */
+	typedef void (*FilterSearcher)(void *arg, const Common::U32String &filter, Common::Array<bool> &matches);
+	FilterSearcher	_filterSearcher;
+	void			*_filterSearcherArg;
+
 	GridWidget(GuiObject *boss, const Common::String &name);
 	~GridWidget();
 
-	template<typename T>
-	void unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurface *> &surfaces);
-
-	const Graphics::ManagedSurface *filenameToSurface(const Common::String &name);
+	const Graphics::ManagedSurface *thumbnailToSurface(const GridItemInfo &entry, Graphics::AlphaType &alphaType);
 	const Graphics::ManagedSurface *languageToSurface(Common::Language languageCode, Graphics::AlphaType &alphaType);
 	const Graphics::ManagedSurface *platformToSurface(Common::Platform platformCode, Graphics::AlphaType &alphaType);
 	const Graphics::ManagedSurface *demoToSurface(const Common::String &extraString, Graphics::AlphaType &alphaType);
@@ -198,9 +199,7 @@ public:
 	void saveClosedGroups(const Common::U32String &groupName);
 
 	void reloadThumbnails();
-	void loadFlagIcons();
-	void loadPlatformIcons();
-	void loadExtraIcons();
+	void invalidateIcons();
 
 	void destroyItems();
 	void calcInnerHeight();
@@ -219,6 +218,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -228,6 +228,7 @@ public:
 
 	void setSelected(int id);
 	void setFilter(const Common::U32String &filter);
+	void setFilterSearcher(FilterSearcher searcher, void *arg) { _filterSearcher = searcher; _filterSearcherArg = arg; }
 };
 
 /* GridItemWidget */
@@ -0,0 +1,451 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/config-manager.h"
+#include "common/endian.h"
+#include "common/fs.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+#include "base/version.h"
+
+#include "graphics/svg.h"
+#include "image/png.h"
+
+#include "gui/gui-manager.h"
+#include "gui/widget.h"
+#include "gui/widgets/gridicons.h"
+
+namespace GUI {
+
+#define GRID_ICON_CACHE_TAG MKTAG('G', 'I', 'C', 'N')
+#define GRID_ICON_CACHE_VERSION 2
+
+// The cache files keep their pixels little endian. Swapping to and from
+// native order is the same operation.
+static void swapPixelsLE(byte *pixels, int count, int bytesPerPixel) {
+	switch (bytesPerPixel) {
+	case 2:
+		for (int i = 0; i < count; ++i, pixels += 2)
+			WRITE_LE_UINT16(pixels, READ_UINT16(pixels));
+		break;
+	case 3:
+		for (int i = 0; i < count; ++i, pixels += 3)
+			WRITE_LE_UINT24(pixels, READ_UINT24(pixels));
+		break;
+	case 4:
+		for (int i = 0; i < count; ++i, pixels += 4)
+			WRITE_LE_UINT32(pixels, READ_UINT32(pixels));
+		break;
+	default:
+		break;
+	}
+}
+
+GridIconLoader *GridIconLoader::_instance = nullptr;
+int GridIconLoader::_refCount = 0;
+
+GridIconLoader *GridIconLoader::acquire() {
+	if (!_instance)
+		_instance = new GridIconLoader();
+	_refCount++;
+	return _instance;
+}
+
+void GridIconLoader::release() {
+	assert(_refCount > 0);
+	if (--_refCount == 0) {
+		delete _instance;
+		_instance = nullptr;
+	}
+}
+
+GridIconLoader::GridIconLoader() : _memoryUsed(0), _frame(0), _loaded(0), _generation(0) {
+	_packsHash = computePacksHash();
+	_cachePath = getCachePath();
+
+	g_system->getTimerManager()->installTimerProc(&workerProc, kWorkInterval, this, "GridIconLoader");
+}
+
+GridIconLoader::~GridIconLoader() {
+	// Waits for a running callback to return
+	g_system->getTimerManager()->removeTimerProc(&workerProc);
+
+	clearResults();
+	for (EntryMap::iterator i = _icons.begin(); i != _icons.end(); ++i)
+		delete i->_value.surface;
+}
+
+const Graphics::ManagedSurface *GridIconLoader::getIcon(const Common::String &file, const Common::String &fallback, int w, int h, Graphics::AlphaType &alphaType) {
+	if (w <= 0 || h <= 0)
+		return nullptr;
+
+	const Common::String name = Common::String::format("%s-%dx%d", file.c_str(), w, h);
+
+	EntryMap::iterator i = _icons.find(name);
+	if (i != _icons.end()) {
+		Entry &entry = i->_value;
+		if (entry.lastUsed != _frame) {
+			entry.lastUsed = _frame;
+			_lru.erase(entry.lru);
+			entry.lru = _lru.insert(_lru.end(), name);
+		}
+		alphaType = entry.alphaType;
+		return entry.surface;
+	}
+
+	Entry &entry = _icons[name];
+	entry.surface = nullptr;
+	entry.alphaType = Graphics::ALPHA_OPAQUE;
+	entry.lastUsed = _frame;
+	entry.size = 0;
+	entry.loading = true;
+	entry.lru = _lru.insert(_lru.end(), name);
+
+	Request request;
+	request.name = name;
+	request.file = file;
+	request.fallback = fallback;
+	request.w = w;
+	request.h = h;
+	request.generation = _generation;
+	request.packsHash = _packsHash;
+	request.cachePath = _cachePath;
+
+	Common::StackLock lock(_mutex);
+	_requests.push_back(request);
+	return nullptr;
+}
+
+uint32 GridIconLoader::update() {
+	Common::Array<Result> results;
+	{
+		Common::StackLock lock(_mutex);
+		results.swap(_results);
+	}
+
+	for (Common::Array<Result>::iterator i = results.begin(); i != results.end(); ++i) {
+		EntryMap::iterator entry = _icons.find(i->name);
+		if (i->generation != _generation || entry == _icons.end()) {
+			delete i->surface;
+			continue;
+		}
+
+		entry->_value.surface = i->surface;
+		entry->_value.alphaType = i->alphaType;
+		entry->_value.loading = false;
+		// Also account for the entry itself, so missing icons are dropped eventually
+		entry->_value.size = sizeof(Entry) + (i->surface ? i->surface->pitch * i->surface->h : 0);
+		_memoryUsed += entry->_value.size;
+	}
+
+	if (!results.empty()) {
+		_loaded++;
+		evict();
+	}
+
+	// Icons used from now on are not dropped before the next update
+	_frame++;
+	return _loaded;
+}
+
+void GridIconLoader::invalidate() {
+	clearResults();
+	{
+		Common::StackLock lock(_mutex);
+		_requests.clear();
+	}
+
+	for (EntryMap::iterator i = _icons.begin(); i != _icons.end(); ++i)
+		delete i->_value.surface;
+	_icons.clear();
+	_lru.clear();
+	_memoryUsed = 0;
+
+	// Drop the icons which are still being loaded
+	_generation++;
+	_loaded++;
+	_packsHash = computePacksHash();
+	_cachePath = getCachePath();
+}
+
+void GridIconLoader::evict() {
+	NameList::iterator i = _lru.begin();
+	while (_memoryUsed > kMemoryBudget && i != _lru.end()) {
+		EntryMap::iterator entry = _icons.find(*i);
+		assert(entry != _icons.end());
+
+		// The rest of the list is in use
+		if (entry->_value.lastUsed >= _frame)
+			break;
+
+		if (entry->_value.loading) {
+			++i;
+			continue;
+		}
+
+		_memoryUsed -= entry->_value.size;
+		delete entry->_value.surface;
+		_icons.erase(entry);
+		i = _lru.erase(i);
+	}
+}
+
+void GridIconLoader::clearResults() {
+	Common::StackLock lock(_mutex);
+	for (Common::Array<Result>::iterator i = _results.begin(); i != _results.end(); ++i)
+		delete i->surface;
+	_results.clear();
+}
+
+void GridIconLoader::workerProc(void *refCon) {
+	((GridIconLoader *)refCon)->work();
+}
+
+void GridIconLoader::work() {
+	// Only load one icon per call, as the other timer callbacks, like the
+	// ones of the audio and MIDI drivers, wait for this one
+	Request request;
+	{
+		Common::StackLock lock(_mutex);
+		if (_requests.empty())
+			return;
+
+		// The latest requests are for the part of the grid which is
+		// shown now, so load them first
+		request = _requests.back();
+		_requests.pop_back();
+	}
+
+	Result result = load(request);
+
+	Common::StackLock lock(_mutex);
+	_results.push_back(result);
+}
+
+GridIconLoader::Result GridIconLoader::load(const Request &request) {
+	Result result;
+	result.name = request.name;
+	result.surface = nullptr;
+	result.alphaType = Graphics::ALPHA_OPAQUE;
+	result.generation = request.generation;
+
+	// The cache file does not depend on the size, so the file written for
+	// an older size or icon packs is replaced instead of kept
+	Common::FSNode node;
+	if (!request.cachePath.empty()) {
+		Common::String cacheName = request.file;
+		cacheName.replace('/', '_');
+		node = Common::FSNode(request.cachePath.join(cacheName + ".icn"));
+		if (readCacheFile(node, request, result))
+			return result;
+	}
+
+	result.surface = decode(request.file, request.w, request.h);
+	if (!result.surface && !request.fallback.empty())
+		result.surface = decode(request.fallback, request.w, request.h);
+
+	if (result.surface) {
+		result.alphaType = result.surface->detectAlpha();
+		if (!request.cachePath.empty())
+			writeCacheFile(node, request, result);
+	}
+
+	return result;
+}
+
+const Graphics::ManagedSurface *GridIconLoader::decode(const Common::String &file, int w, int h) {
+	Common::Path path(file);
+	Common::SeekableReadStream *stream = nullptr;
+
+	// Only hold the lock while reading, decoding is done on a copy
+	g_gui.lockIconsSet();
+	if (g_gui.getIconsSet().hasFile(path)) {
+		Common::SeekableReadStream *member = g_gui.getIconsSet().createReadStreamForMember(path);
+		if (member) {
+			stream = member->readStream(member->size());
+			delete member;
+		}
+	}
+	g_gui.unlockIconsSet();
+
+	if (!stream) {
+		debug(5, "GridIconLoader: Cannot read file '%s'", file.c_str());
+		return nullptr;
+	}
+
+	const Graphics::ManagedSurface *surf = nullptr;
+	if (file.hasSuffix(".svg")) {
+		surf = new Graphics::SVGBitmap(stream, w, h);
+	} else if (file.hasSuffix(".png")) {
+#ifdef USE_PNG
+		Image::PNGDecoder decoder;
+		if (!decoder.loadStream(*stream)) {
+			warning("Error decoding PNG");
+		} else if (!decoder.getSurface()) {
+			warning("Failed to load surface : %s", file.c_str());
+		} else if (decoder.getSurface()->format.bytesPerPixel != 1) {
+			Graphics::ManagedSurface *gfx = new Graphics::ManagedSurface();
+			gfx->copyFrom(*decoder.getSurface());
+
+			surf = scaleGfx(gfx, w, h, true);
+			if (surf != gfx)
+				delete gfx;
+		}
+#else
+		error("No PNG support compiled");
+#endif
+	}
+
+	delete stream;
+	return surf;
+}
+
+bool GridIconLoader::readCacheFile(const Common::FSNode &node, const Request &request, Result &result) {
+	if (!node.exists())
+		return false;
+
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream)
+		return false;
+
+	bool valid = stream->readUint32BE() == GRID_ICON_CACHE_TAG &&
+		stream->readUint32BE() == GRID_ICON_CACHE_VERSION &&
+		stream->readUint32LE() == request.packsHash &&
+		stream->readUint16LE() == request.w &&
+		stream->readUint16LE() == request.h;
+
+	Graphics::PixelFormat format;
+	format.bytesPerPixel = stream->readByte();
+	format.rLoss = stream->readByte();
+	format.gLoss = stream->readByte();
+	format.bLoss = stream->readByte();
+	format.aLoss = stream->readByte();
+	format.rShift = stream->readByte();
+	format.gShift = stream->readByte();
+	format.bShift = stream->readByte();
+	format.aShift = stream->readByte();
+	const uint16 w = stream->readUint16LE();
+	const uint16 h = stream->readUint16LE();
+	const Graphics::AlphaType alphaType = (Graphics::AlphaType)stream->readByte();
+
+	if (!valid || stream->eos() || format.bytesPerPixel < 2 || format.bytesPerPixel > 4 ||
+		w > request.w || h > request.h || stream->size() - stream->pos() != w * h * format.bytesPerPixel) {
+		delete stream;
+		return false;
+	}
+
+	Graphics::ManagedSurface *surf = new Graphics::ManagedSurface(w, h, format);
+	for (int y = 0; y < h; ++y) {
+		byte *row = (byte *)surf->getBasePtr(0, y);
+		stream->read(row, w * format.bytesPerPixel);
+		swapPixelsLE(row, w, format.bytesPerPixel);
+	}
+
+	valid = !stream->err();
+	delete stream;
+
+	if (!valid) {
+		delete surf;
+		return false;
+	}
+
+	result.surface = surf;
+	result.alphaType = alphaType;
+	return true;
+}
+
+void GridIconLoader::writeCacheFile(const Common::FSNode &node, const Request &request, const Result &result) {
+	const Graphics::ManagedSurface *surf = result.surface;
+	const Graphics::PixelFormat &format = surf->format;
+
+	Common::FSNode dir(request.cachePath);
+	if (!dir.exists() && !dir.createDirectory())
+		return;
+
+	Common::SeekableWriteStream *stream = node.createWriteStream();
+	if (!stream)
+		return;
+
+	stream->writeUint32BE(GRID_ICON_CACHE_TAG);
+	stream->writeUint32BE(GRID_ICON_CACHE_VERSION);
+	stream->writeUint32LE(request.packsHash);
+	stream->writeUint16LE(request.w);
+	stream->writeUint16LE(request.h);
+	stream->writeByte(format.bytesPerPixel);
+	stream->writeByte(format.rLoss);
+	stream->writeByte(format.gLoss);
+	stream->writeByte(format.bLoss);
+	stream->writeByte(format.aLoss);
+	stream->writeByte(format.rShift);
+	stream->writeByte(format.gShift);
+	stream->writeByte(format.bShift);
+	stream->writeByte(format.aShift);
+	stream->writeUint16LE(surf->w);
+	stream->writeUint16LE(surf->h);
+	stream->writeByte(result.alphaType);
+
+	const int rowSize = surf->w * format.bytesPerPixel;
+	byte *row = (byte *)malloc(rowSize);
+	for (int y = 0; y < surf->h; ++y) {
+		memcpy(row, surf->getBasePtr(0, y), rowSize);
+		swapPixelsLE(row, surf->w, format.bytesPerPixel);
+		stream->write(row, rowSize);
+	}
+	free(row);
+
+	stream->finalize();
+	delete stream;
+}
+
+Common::Path GridIconLoader::getCachePath() {
+	Common::Path iconsPath = ConfMan.getPath("iconspath");
+	if (iconsPath.empty())
+		return Common::Path();
+	return iconsPath.join("cache");
+}
+
+uint32 GridIconLoader::computePacksHash() {
+	// The built-in icons only change with the version
+	uint32 hash = Common::hashit(gScummVMVersion);
+
+	Common::Path iconsPath = ConfMan.getPath("iconspath");
+	if (iconsPath.empty())
+		return hash;
+
+	Common::FSDirectory iconDir(iconsPath);
+	Common::ArchiveMemberList iconFiles;
+	iconDir.listMatchingMembers(iconFiles, "gui-icons*.dat");
+
+	for (Common::ArchiveMemberList::iterator ic = iconFiles.begin(); ic != iconFiles.end(); ++ic) {
+		Common::SeekableReadStream *str = (*ic)->createReadStream();
+		const uint32 size = str ? str->size() : 0;
+		delete str;
+
+		// Do not depend on the order of the list
+		hash += Common::hashit((*ic)->getName().c_str()) * 31 + size;
+	}
+
+	return hash;
+}
+
+} // End of namespace GUI
@@ -0,0 +1,161 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GUI_WIDGETS_GRIDICONS_H
+#define GUI_WIDGETS_GRIDICONS_H
+
+#include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/path.h"
+#include "common/str.h"
+
+#include "graphics/managed_surface.h"
+
+namespace Common {
+class FSNode;
+}
+
+namespace GUI {
+
+/**
+ * Loads the icons shown by the grid view of the launcher in the background.
+ *
+ * Decoding the PNG files and rendering the SVG files of the icon packs is
+ * done by a timer callback, one icon per call, so opening and scrolling the
+ * grid never waits for it; the grid draws a placeholder until an icon is
+ * ready. Loaded icons
+ * are kept in memory up to a fixed budget, dropping the least recently used
+ * ones first. They are also saved, already scaled, to a cache directory in
+ * the icons path, so an icon is only decoded again when the icon packs or
+ * the size it is shown at change. Each icon has a single file in the cache,
+ * which is overwritten then, so outdated copies do not pile up.
+ *
+ * A launcher can hold more than one grid while it is rebuilt, so the loader
+ * is shared by all of them, see acquire() and release().
+ */
+class GridIconLoader {
+public:
+	static GridIconLoader *acquire();
+	static void release();
+
+	/**
+	 * Get an icon, queueing it for loading if it is not loaded yet.
+	 *
+	 * SVG files are rendered at the given size, other images are scaled
+	 * down to fit into it.
+	 *
+	 * @param file      Path of the icon in the icons set.
+	 * @param fallback  Path used if file does not exist, may be empty.
+	 * @param w, h      Size to fit the icon into.
+	 * @param alphaType Set to the alpha type of the icon.
+	 * @return The icon, or nullptr while it is loaded or if neither file exists.
+	 */
+	const Graphics::ManagedSurface *getIcon(const Common::String &file, const Common::String &fallback, int w, int h, Graphics::AlphaType &alphaType);
+
+	/**
+	 * Take over the icons loaded in the background. This has to be called
+	 * regularly from the GUI thread.
+	 *
+	 * @return A counter which changes whenever new icons became available.
+	 */
+	uint32 update();
+
+	/**
+	 * Drop all icons, after the icons set changed.
+	 */
+	void invalidate();
+
+private:
+	enum {
+		kWorkInterval = 10 * 1000,          // in microseconds
+		kMemoryBudget = 32 * 1024 * 1024    // in bytes
+	};
+
+	struct Request {
+		Common::String name;
+		Common::String file;
+		Common::String fallback;
+		int w, h;
+		uint32 generation;
+		uint32 packsHash;
+		Common::Path cachePath;
+	};
+
+	struct Result {
+		Common::String name;
+		const Graphics::ManagedSurface *surface;
+		Graphics::AlphaType alphaType;
+		uint32 generation;
+	};
+
+	typedef Common::List<Common::String> NameList;
+
+	struct Entry {
+		const Graphics::ManagedSurface *surface;
+		Graphics::AlphaType alphaType;
+		uint32 lastUsed;
+		uint32 size;
+		bool loading;
+		NameList::iterator lru;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static GridIconLoader *_instance;
+	static int _refCount;
+
+	GridIconLoader();
+	~GridIconLoader();
+
+	static void workerProc(void *refCon);
+	void work();
+	void evict();
+	void clearResults();
+
+	static Result load(const Request &request);
+	static const Graphics::ManagedSurface *decode(const Common::String &file, int w, int h);
+	static bool readCacheFile(const Common::FSNode &node, const Request &request, Result &result);
+	static void writeCacheFile(const Common::FSNode &node, const Request &request, const Result &result);
+	static Common::Path getCachePath();
+	static uint32 computePacksHash();
+
+	// Shared with the timer callback
+	Common::Mutex _mutex;
+	Common::Array<Request> _requests;
+	Common::Array<Result> _results;
+
+	// Only accessed from the GUI thread
+	EntryMap _icons;
+	NameList _lru;          // The names of the icons, least recently used first
+	uint32 _memoryUsed;
+	uint32 _frame;
+	uint32 _loaded;
+	uint32 _generation;
+	uint32 _packsHash;
+	Common::Path _cachePath;
+};
+
+} // End of namespace GUI
+
+#endif
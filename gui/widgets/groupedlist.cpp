@@ -435,6 +435,19 @@ void GroupedListWidget::setFilter(const Common::U32String &filter, bool redraw)
 	if (_filter.empty()) {
 		// No filter -> display everything
 		sortGroups();
+	} else if (_filterSearcher) {
+		Common::Array<bool> matches;
+		_filterSearcher(_filterSearcherArg, _filter, matches);
+
+		_list.clear();
+		_listIndex.clear();
+
+		for (uint n = 0; n < _dataList.size() && n < matches.size(); ++n) {
+			if (matches[n]) {
+				_list.push_back(_dataList[n].orig);
+				_listIndex.push_back(n);
+			}
+		}
 	} else {
 		// Restrict the list to everything which contains all words in _filter
 		// as substrings, ignoring case.
@@ -70,6 +70,8 @@ ListWidget::ListWidget(Dialog *boss, const Common::String &name, const Common::U
 
 	_filterMatcher = ListWidgetDefaultMatcher;
 	_filterMatcherArg = nullptr;
+	_filterSearcher = nullptr;
+	_filterSearcherArg = nullptr;
 
 	_lastRead = -1;
 
@@ -112,6 +114,8 @@ ListWidget::ListWidget(Dialog *boss, int x, int y, int w, int h, bool scale, con
 
 	_filterMatcher = ListWidgetDefaultMatcher;
 	_filterMatcherArg = nullptr;
+	_filterSearcher = nullptr;
+	_filterSearcherArg = nullptr;
 
 	_lastRead = -1;
 
@@ -769,6 +773,19 @@ void ListWidget::setFilter(const Common::U32String &filter, bool redraw) {
 			_list.push_back(_dataList[i].orig);
 
 		_listIndex.clear();
+	} else if (_filterSearcher) {
+		Common::Array<bool> matches;
+		_filterSearcher(_filterSearcherArg, _filter, matches);
+
+		_list.clear();
+		_listIndex.clear();
+
+		for (uint n = 0; n < _dataList.size() && n < matches.size(); ++n) {
+			if (matches[n]) {
+				_list.push_back(_dataList[n].orig);
+				_listIndex.push_back(n);
+			}
+		}
 	} else {
 		// Restrict the list to everything which matches all tokens in _filter, ignoring case.
 
@@ -51,6 +51,11 @@ enum {
 class ListWidget : public EditableWidget {
 public:
 	typedef bool (*FilterMatcher)(void *arg, int idx, const Common::U32String &item, const Common::U32String &token);
+	/**
+	 * Find the items matching a whole filter at once, setting matches[idx]
+	 * for each item. Used instead of the FilterMatcher if set.
+	 */
+	typedef void (*FilterSearcher)(void *arg, const Common::U32String &filter, Common::Array<bool> &matches);
 
 	struct ListData {
 		Common::U32String orig;
@@ -98,6 +103,8 @@ protected:
 
 	FilterMatcher	_filterMatcher;
 	void			*_filterMatcherArg;
+	FilterSearcher	_filterSearcher;
+	void			*_filterSearcherArg;
 public:
 	ListWidget(Dialog *boss, const Common::String &name, const Common::U32String &tooltip = Common::U32String(), uint32 cmd = 0);
 	ListWidget(Dialog *boss, int x, int y, int w, int h, bool scale, const Common::U32String &tooltip = Common::U32String(), uint32 cmd = 0);
@@ -132,6 +139,7 @@ public:
 	void setEditable(bool editable)				{ _editable = editable; }
 	void setEditColor(ThemeEngine::FontColor color) { _editColor = color; }
 	void setFilterMatcher(FilterMatcher matcher, void *arg) { _filterMatcher = matcher; _filterMatcherArg = arg; }
+	void setFilterSearcher(FilterSearcher searcher, void *arg) { _filterSearcher = searcher; _filterSearcherArg = arg; }
 
 	// Made startEditMode/endEditMode for SaveLoadChooser
 	void startEditMode() override;
@@ -690,6 +690,7 @@ byte CinepakDecoder::findNearestRGB(int index) const {
 	byte g = s_defaultPalette[index * 3 + 1];
 	byte b = s_defaultPalette[index * 3 + 2];
 
+	// Only called once per color to build the map, see Graphics::PaletteLookup
 	return _ditherPalette.findBestColor(r, g, b, Graphics::kColorDistanceEuclidean);
 }
 
@@ -0,0 +1,125 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decoders/adpcm.h"
+
+#include "common/array.h"
+#include "common/memstream.h"
+
+class ADPCMTestSuite : public CxxTest::TestSuite {
+private:
+	uint32 _seed;
+
+	byte nextByte() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0xff;
+	}
+
+	void writeSint16LE(Common::Array<byte> &data, int16 value) {
+		data.push_back(value & 0xff);
+		data.push_back((value >> 8) & 0xff);
+	}
+
+	// Builds a number of blocks with random samples and valid headers,
+	// followed by a truncated block
+	Common::Array<byte> createData(Audio::ADPCMType type, int channels, uint32 blockAlign, uint32 blocks) {
+		Common::Array<byte> data;
+		_seed = 1234 + type * 16 + channels;
+
+		for (uint32 block = 0; block <= blocks; block++) {
+			const uint32 start = data.size();
+			if (type == Audio::kADPCMMSIma) {
+				for (int i = 0; i < channels; i++) {
+					writeSint16LE(data, (int16)(nextByte() << 8 | nextByte()));
+					writeSint16LE(data, nextByte() % 89);
+				}
+			} else if (type == Audio::kADPCMMS) {
+				for (int i = 0; i < channels; i++)
+					data.push_back(nextByte() % 7);
+				for (int i = 0; i < channels; i++)
+					writeSint16LE(data, 16 + nextByte() * 4);
+				for (int i = 0; i < channels * 2; i++)
+					writeSint16LE(data, (int16)(nextByte() << 8 | nextByte()));
+			}
+
+			const uint32 end = (block == blocks) ? start + blockAlign / 2 : start + blockAlign;
+			while (data.size() < end)
+				data.push_back(nextByte());
+		}
+
+		return data;
+	}
+
+	// Decodes the data in chunks of the given sizes and hashes the result
+	uint32 decode(const Common::Array<byte> &data, uint32 size, Audio::ADPCMType type, int channels, uint32 blockAlign, const int *chunks, int numChunks, Common::Array<int16> *output = nullptr) {
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data.data(), data.size());
+		Audio::SeekableAudioStream *adpcm = Audio::makeADPCMStream(stream, DisposeAfterUse::YES, size, type, 22050, channels, blockAlign);
+
+		int16 buffer[4096];
+		uint32 hash = 2166136261u;
+		for (int chunk = 0; !adpcm->endOfData(); chunk++) {
+			const int samples = adpcm->readBuffer(buffer, chunks[chunk % numChunks]);
+			if (samples <= 0)
+				break;
+			for (int i = 0; i < samples; i++) {
+				hash = (hash ^ (uint16)buffer[i]) * 16777619u;
+				if (output)
+					output->push_back(buffer[i]);
+			}
+		}
+
+		delete adpcm;
+		return hash;
+	}
+
+	void checkChunks(Audio::ADPCMType type, int channels, uint32 blockAlign) {
+		const Common::Array<byte> data = createData(type, channels, blockAlign, 4);
+		const int whole[] = { 4096 };
+		const int chunks[] = { channels, channels * 3, channels * 8, channels * 37, channels * 500 };
+
+		Common::Array<int16> expected, actual;
+		decode(data, data.size(), type, channels, blockAlign, whole, ARRAYSIZE(whole), &expected);
+		decode(data, data.size(), type, channels, blockAlign, chunks, ARRAYSIZE(chunks), &actual);
+		TS_ASSERT_EQUALS(expected.size(), actual.size());
+		TS_ASSERT(expected == actual);
+	}
+
+	uint32 hashWhole(Audio::ADPCMType type, int channels, uint32 blockAlign, bool truncated = false) {
+		const Common::Array<byte> data = createData(type, channels, blockAlign, 4);
+		const int whole[] = { 4096 };
+		// A stream shorter than the size it was created with
+		const uint32 size = truncated ? data.size() + 100 : data.size();
+		return decode(data, size, type, channels, blockAlign, whole, ARRAYSIZE(whole));
+	}
+
+public:
+	void test_oki() {
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMOki, 1, 256), 3836514501u);
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMOki, 1, 256, true), 1148368589u);
+		checkChunks(Audio::kADPCMOki, 1, 256);
+	}
+
+	void test_dvi() {
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMDVI, 1, 256), 1199764160u);
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMDVI, 2, 256), 493690425u);
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMDVI, 2, 256, true), 4096751671u);
+		checkChunks(Audio::kADPCMDVI, 1, 256);
+		checkChunks(Audio::kADPCMDVI, 2, 256);
+	}
+
+	void test_ms_ima() {
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMMSIma, 1, 256), 843995165u);
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMMSIma, 2, 512), 2458771487u);
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMMSIma, 2, 512, true), 3513495919u);
+		checkChunks(Audio::kADPCMMSIma, 1, 256);
+		checkChunks(Audio::kADPCMMSIma, 2, 512);
+	}
+
+	void test_ms() {
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMMS, 1, 256), 184225029u);
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMMS, 2, 512), 2688853380u);
+		TS_ASSERT_EQUALS(hashWhole(Audio::kADPCMMS, 2, 512, true), 2243736108u);
+		checkChunks(Audio::kADPCMMS, 1, 256);
+		checkChunks(Audio::kADPCMMS, 2, 512);
+	}
+};
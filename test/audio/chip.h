@@ -0,0 +1,207 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/chip.h"
+#include "audio/softsynth/opl/dosbox.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+// The chips take their rate from the mixer of the null OSystem
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_CHIP 1
+#else
+#define TEST_CHIP 0
+#endif
+
+#if TEST_CHIP
+namespace {
+
+// A chip whose output depends on the register value the callback writes,
+// so that samples and callback timing both show up in the output
+class TestChip : public Audio::EmulatedChip {
+public:
+	TestChip(int renderAhead) : _reg(0), _phase(0) {
+		setCallbackFrequency(70);
+		setRenderAhead(renderAhead);
+		_callback.reset(new Common::Functor0Mem<void, TestChip>(this, &TestChip::onTimer));
+	}
+
+	using EmulatedChip::renderAhead;
+
+	bool isStereo() const override { return true; }
+	int getRate() const override { return 22050; }
+
+protected:
+	void generateSamples(int16 *buffer, int numSamples) override {
+		for (int i = 0; i < numSamples; i++)
+			buffer[i] = (int16)(_reg * 31 + _phase++);
+	}
+
+private:
+	void onTimer() {
+		_reg = _reg * 7 + 1;
+	}
+
+	uint32 _reg;
+	uint32 _phase;
+};
+
+#ifndef DISABLE_DOSBOX_OPL
+// The DOSBox OPL3 emulator, driven like a music player which changes the
+// notes in every callback
+class BenchmarkOPL : public ::OPL::DOSBox::OPL {
+public:
+	BenchmarkOPL(int renderAhead) : ::OPL::DOSBox::OPL(::OPL::Config::kOpl3), _tick(0) {
+		init();
+		setCallbackFrequency(::OPL::OPL::kDefaultCallbackFrequency);
+		setRenderAhead(renderAhead);
+		_callback.reset(new Common::Functor0Mem<void, BenchmarkOPL>(this, &BenchmarkOPL::onTimer));
+
+		writeReg(0x105, 0x01);
+		for (int channel = 0; channel < 9; channel++) {
+			static const uint8 opOffset[9] = { 0x00, 0x01, 0x02, 0x08, 0x09, 0x0a, 0x10, 0x11, 0x12 };
+			for (int bank = 0; bank < 0x200; bank += 0x100) {
+				const int op = bank + opOffset[channel];
+				writeReg(op + 0x20, 0x21);
+				writeReg(op + 0x23, 0x21);
+				writeReg(op + 0x40, 0x10);
+				writeReg(op + 0x43, 0x00);
+				writeReg(op + 0x60, 0xf2);
+				writeReg(op + 0x63, 0xf2);
+				writeReg(op + 0x80, 0x35);
+				writeReg(op + 0x83, 0x35);
+				writeReg(bank + 0xc0 + channel, 0x31);
+			}
+		}
+	}
+
+	using EmulatedChip::renderAhead;
+
+private:
+	void onTimer() {
+		// Play a different note on every channel of both banks
+		for (int channel = 0; channel < 9; channel++) {
+			for (int bank = 0; bank < 0x200; bank += 0x100) {
+				const int fnum = 0x157 + ((_tick + channel * 5 + bank / 0x40) % 24) * 0x10;
+				writeReg(bank + 0xa0 + channel, fnum & 0xff);
+				writeReg(bank + 0xb0 + channel, ((_tick + channel) & 4 ? 0x20 : 0x00) | 0x10 | (fnum >> 8));
+			}
+		}
+		_tick++;
+	}
+
+	uint _tick;
+};
+#endif
+
+} // End of anonymous namespace
+#endif
+
+class EmulatedChipTestSuite : public CxxTest::TestSuite {
+	static const int kReadSizes[];
+
+#if TEST_CHIP
+	// Reads the chip with the given read sizes, and renders ahead every
+	// few reads if the chip has a render-ahead buffer
+	template<class ChipType>
+	void readChip(ChipType &chip, int renderEvery, Common::Array<int16> &output) {
+		for (int i = 0; i < 200; i++) {
+			const int size = kReadSizes[i % 7];
+
+			if (renderEvery && i % renderEvery == 0)
+				chip.renderAhead();
+
+			const uint pos = output.size();
+			output.resize(pos + size);
+			chip.readBuffer(&output[pos], size);
+		}
+	}
+#endif
+
+public:
+	void test_render_ahead_matches_direct() {
+#if TEST_CHIP
+		Common::install_null_g_system();
+
+		// The buffer covers all reads
+		TestChip direct(0), ahead(100);
+		Common::Array<int16> expected, actual;
+		readChip(direct, 0, expected);
+		readChip(ahead, 1, actual);
+		TS_ASSERT(expected == actual);
+#endif
+	}
+
+	void test_render_ahead_underrun() {
+#if TEST_CHIP
+		Common::install_null_g_system();
+
+		// The buffer runs dry, so readBuffer() emulates the rest
+		TestChip direct(0), ahead(10);
+		Common::Array<int16> expected, actual;
+		readChip(direct, 0, expected);
+		readChip(ahead, 5, actual);
+		TS_ASSERT(expected == actual);
+#endif
+	}
+
+	void test_opl_render_ahead_matches_direct() {
+#if TEST_CHIP && !defined(DISABLE_DOSBOX_OPL)
+		Common::install_null_g_system();
+
+		// Only one OPL can exist at a time
+		Common::Array<int16> expected, actual;
+		{
+			BenchmarkOPL direct(0);
+			readChip(direct, 0, expected);
+		}
+		{
+			BenchmarkOPL ahead(50);
+			readChip(ahead, 3, actual);
+		}
+		TS_ASSERT(expected == actual);
+#endif
+	}
+
+	void test_render_ahead_benchmark() {
+#if TEST_CHIP && !defined(DISABLE_DOSBOX_OPL)
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 2000;
+#else
+		const int iters = 50;
+#endif
+		const int size = 2048;
+		int16 buffer[size];
+
+		// The mixer asks for less than the 100 ms buffer holds. Only one
+		// OPL can exist at a time.
+		uint32 directTime = 0, aheadTime = 0;
+		{
+			BenchmarkOPL direct(0);
+			for (int i = 0; i < iters; i++) {
+				const uint32 start = g_system->getMillis();
+				direct.readBuffer(buffer, size);
+				directTime += g_system->getMillis() - start;
+			}
+		}
+		{
+			BenchmarkOPL ahead(100);
+			for (int i = 0; i < iters; i++) {
+				// Rendering ahead runs on the timer thread, so only the
+				// time spent in the mixer callback counts
+				ahead.renderAhead();
+				const uint32 start = g_system->getMillis();
+				ahead.readBuffer(buffer, size);
+				aheadTime += g_system->getMillis() - start;
+			}
+		}
+
+		debug("DOSBox OPL3 readBuffer() %d samples avg time (in milliseconds): direct %f, rendered ahead %f\n",
+		      size, (double)directTime / iters, (double)aheadTime / iters);
+#endif
+	}
+};
+
+const int EmulatedChipTestSuite::kReadSizes[] = { 2, 512, 1024, 6, 2048, 300, 1000 };
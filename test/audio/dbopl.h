@@ -0,0 +1,142 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/opl/dbopl.h"
+
+#ifndef DISABLE_DOSBOX_OPL
+
+namespace {
+
+using namespace OPL::DOSBox;
+
+// Plays a fixed register sequence through every synthesis mode and hashes
+// the output, so changes to the generators can be checked to stay
+// bit-exact with the original DOSBox emulation.
+class DBOPLRenderer {
+public:
+	DBOPLRenderer(bool opl3) : _opl3(opl3), _hash(2166136261u) {
+		DBOPL::InitTables();
+		_chip.Setup(49716);
+		_chip.WriteReg(0x01, 0x20);
+		if (opl3)
+			_chip.WriteReg(0x105, 0x01);
+	}
+
+	void write(uint32 reg, uint8 val) {
+		_chip.WriteReg(reg, val);
+	}
+
+	// Sets up both operators of a two operator channel
+	void setupChannel(uint32 bank, uint8 channel, uint8 c0, uint8 waveform) {
+		static const uint8 opOffset[9] = { 0x00, 0x01, 0x02, 0x08, 0x09, 0x0a, 0x10, 0x11, 0x12 };
+		const uint32 op = bank + opOffset[channel];
+		write(op + 0x20, 0xe1 + channel);
+		write(op + 0x23, 0x61 + (channel & 3));
+		write(op + 0x40, 0x10 + channel * 3);
+		write(op + 0x43, 0x00);
+		write(op + 0x60, 0xf2 - channel * 0x10);
+		write(op + 0x63, 0xd3);
+		write(op + 0x80, 0x35);
+		write(op + 0x83, 0x17);
+		write(op + 0xe0, waveform & 7);
+		write(op + 0xe3, (waveform + 1) & 7);
+		write(bank + 0xc0 + channel, c0 | (_opl3 ? 0x30 : 0x00));
+	}
+
+	void keyOn(uint32 bank, uint8 channel, uint16 fnum, uint8 block) {
+		write(bank + 0xa0 + channel, fnum & 0xff);
+		write(bank + 0xb0 + channel, 0x20 | (block << 2) | (fnum >> 8));
+	}
+
+	void keyOff(uint32 bank, uint8 channel) {
+		write(bank + 0xb0 + channel, 0x00);
+	}
+
+	void render(uint32 samples) {
+		int32 buffer[512 * 2];
+		while (samples > 0) {
+			const uint32 todo = MIN<uint32>(samples, 512);
+			if (_opl3)
+				_chip.GenerateBlock3(todo, buffer);
+			else
+				_chip.GenerateBlock2(todo, buffer);
+			for (uint32 i = 0; i < todo * (_opl3 ? 2 : 1); i++) {
+				_hash = (_hash ^ (uint32)buffer[i]) * 16777619u;
+			}
+			samples -= todo;
+		}
+	}
+
+	uint32 hash() const { return _hash; }
+
+private:
+	DBOPL::Chip _chip;
+	bool _opl3;
+	uint32 _hash;
+};
+
+} // End of anonymous namespace
+
+#endif
+
+class DBOPLTestSuite : public CxxTest::TestSuite {
+public:
+	void test_opl2_melodic() {
+#ifndef DISABLE_DOSBOX_OPL
+		DBOPLRenderer opl(false);
+		opl.write(0xbd, 0xc0);
+		for (uint8 ch = 0; ch < 9; ch++) {
+			// Alternate between FM and AM with varying feedback
+			opl.setupChannel(0, ch, ((ch % 7) << 1) | (ch & 1), ch);
+			opl.keyOn(0, ch, 0x157 + ch * 0x20, 2 + ch % 4);
+		}
+		opl.render(20000);
+		for (uint8 ch = 0; ch < 9; ch += 2)
+			opl.keyOff(0, ch);
+		opl.render(20000);
+		for (uint8 ch = 1; ch < 9; ch += 2)
+			opl.keyOff(0, ch);
+		opl.render(30000);
+		TS_ASSERT_EQUALS(opl.hash(), 2373721828u);
+#endif
+	}
+
+	void test_opl2_percussion() {
+#ifndef DISABLE_DOSBOX_OPL
+		DBOPLRenderer opl(false);
+		for (uint8 ch = 0; ch < 9; ch++) {
+			opl.setupChannel(0, ch, (ch & 1) | 0x0a, ch);
+			opl.keyOn(0, ch, 0x200 + ch * 0x10, 3);
+		}
+		opl.write(0xbd, 0x3f);
+		opl.render(15000);
+		opl.write(0xbd, 0x20);
+		opl.render(15000);
+		TS_ASSERT_EQUALS(opl.hash(), 1444152635u);
+#endif
+	}
+
+	void test_opl3_four_operator() {
+#ifndef DISABLE_DOSBOX_OPL
+		DBOPLRenderer opl(true);
+		opl.write(0x104, 0x3f);
+		for (uint8 ch = 0; ch < 9; ch++) {
+			opl.setupChannel(0x000, ch, (ch & 1) | ((ch % 5) << 1), ch);
+			opl.setupChannel(0x100, ch, ((ch >> 1) & 1) | 0x04, ch + 3);
+		}
+		// Every combination of the connection bits of the 4 operator pairs
+		for (uint8 ch = 0; ch < 3; ch++) {
+			opl.keyOn(0x000, ch, 0x181 + ch * 0x40, 4);
+			opl.keyOn(0x100, ch, 0x1c1 + ch * 0x40, 3);
+		}
+		for (uint8 ch = 6; ch < 9; ch++) {
+			opl.keyOn(0x000, ch, 0x120 + ch * 0x30, 3);
+			opl.keyOn(0x100, ch, 0x2a0 - ch * 0x30, 4);
+		}
+		opl.render(25000);
+		for (uint8 ch = 0; ch < 3; ch++)
+			opl.keyOff(0x000, ch);
+		opl.render(25000);
+		TS_ASSERT_EQUALS(opl.hash(), 990006999u);
+#endif
+	}
+};
@@ -0,0 +1,183 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "audio/audiostream.h"
+#include "audio/decoders/mp3.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+// The benchmark times with the null OSystem
+#if defined(USE_MAD) && NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_MP3_BENCHMARK 1
+#else
+#define TEST_MP3_BENCHMARK 0
+#endif
+
+namespace {
+
+// Writes an MPEG-1 Layer I stream of random subband samples. Layer I
+// frames do not depend on each other. So a stream that starts at some
+// frame decodes like a seek to that frame, which restarts the decoder.
+class MP1Writer {
+public:
+	enum {
+		kFrameSize = 136,	// 128 kbit/s at 44100 Hz, without padding
+		kFrameSamples = 384,
+		kRate = 44100
+	};
+
+	MP1Writer() : _seed(1), _data(nullptr), _bit(0) {}
+
+	byte *write(uint frames) {
+		_data = (byte *)calloc(frames, kFrameSize);
+		for (uint i = 0; i < frames; i++) {
+			_bit = i * kFrameSize * 8;
+			writeFrame();
+		}
+		return _data;
+	}
+
+	// The first frame that starts at or after the given time
+	static uint frameAt(uint32 msecs) {
+		return (msecs * kRate + kFrameSamples * 1000 - 1) / (kFrameSamples * 1000);
+	}
+
+private:
+	uint nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	void put(uint value, int bits) {
+		while (bits--) {
+			if ((value >> bits) & 1)
+				_data[_bit >> 3] |= 0x80 >> (_bit & 7);
+			_bit++;
+		}
+	}
+
+	void writeFrame() {
+		// MPEG-1, Layer I, no CRC, 128 kbit/s, 44100 Hz, mono
+		put(0xFFF, 12);
+		put(1, 1);
+		put(3, 2);
+		put(1, 1);
+		put(4, 4);
+		put(0, 2);
+		put(0, 2);
+		put(3, 2);
+		put(0, 6);
+
+		// The lowest subbands get up to five bits per sample
+		uint allocation[32];
+		for (int sb = 0; sb < 32; sb++) {
+			allocation[sb] = sb < 8 ? 1 + nextRandom() % 4 : 0;
+			put(allocation[sb], 4);
+		}
+
+		for (int sb = 0; sb < 32; sb++)
+			if (allocation[sb])
+				put(10 + nextRandom() % 30, 6);
+
+		for (int s = 0; s < 12; s++) {
+			for (int sb = 0; sb < 32; sb++) {
+				if (allocation[sb]) {
+					const int bits = allocation[sb] + 1;
+					put(nextRandom() % ((1 << bits) - 1), bits);
+				}
+			}
+		}
+	}
+
+	uint32 _seed;
+	byte *_data;
+	uint _bit;
+};
+
+} // End of anonymous namespace
+
+class MP3StreamTestSuite : public CxxTest::TestSuite {
+public:
+	void test_seek_index() {
+#ifdef USE_MAD
+		// Recorded frames are every 32 frames, or about 279 ms apart
+		const uint frames = 200;
+		MP1Writer writer;
+		byte *data = writer.write(frames);
+		const uint32 size = frames * MP1Writer::kFrameSize;
+
+		Audio::SeekableAudioStream *stream = Audio::makeMP3Stream(new Common::MemoryReadStream(data, size), DisposeAfterUse::YES);
+		TS_ASSERT(stream);
+		if (!stream) {
+			free(data);
+			return;
+		}
+		TS_ASSERT_EQUALS(stream->getLength().msecs(), (uint32)(frames * MP1Writer::kFrameSamples * 1000 / MP1Writer::kRate));
+
+		// Forward and backward, before the first and between the other
+		// recorded frames. Small forward seeks continue decoding from the
+		// current frame instead, so they are not compared.
+		const uint32 destinations[] = { 400, 1000, 1700, 600, 100, 50, 0, 1200, 279, 278 };
+		const int length = 3 * MP1Writer::kFrameSamples;
+		int16 expected[length], actual[length];
+
+		for (int i = 0; i < ARRAYSIZE(destinations); i++) {
+			TS_ASSERT(stream->seek(Audio::Timestamp(destinations[i], 1000)));
+			TS_ASSERT_EQUALS(stream->readBuffer(actual, length), length);
+
+			// The same frames decoded from the start of a stream
+			const uint frame = MP1Writer::frameAt(destinations[i]);
+			const uint32 offset = frame * MP1Writer::kFrameSize;
+			Audio::SeekableAudioStream *reference = Audio::makeMP3Stream(new Common::MemoryReadStream(data + offset, size - offset), DisposeAfterUse::YES);
+			TS_ASSERT_EQUALS(reference->readBuffer(expected, length), length);
+			TS_ASSERT_SAME_DATA(expected, actual, length * sizeof(int16));
+			delete reference;
+		}
+
+		// Seeking to the end is allowed and ends the stream, seeking past
+		// it is not
+		TS_ASSERT(!stream->seek(stream->getLength().addMsecs(1)));
+		TS_ASSERT(!stream->endOfData());
+		TS_ASSERT(stream->seek(stream->getLength()));
+		TS_ASSERT(stream->endOfData());
+
+		delete stream;
+		free(data);
+#endif
+	}
+
+	void test_seek_benchmark() {
+#if TEST_MP3_BENCHMARK
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const uint frames = 100000;	// About 15 minutes
+		const int iters = 1000;
+#else
+		const uint frames = 10000;
+		const int iters = 100;
+#endif
+		MP1Writer writer;
+		byte *data = writer.write(frames);
+		Audio::SeekableAudioStream *stream = Audio::makeMP3Stream(new Common::MemoryReadStream(data, frames * MP1Writer::kFrameSize, DisposeAfterUse::YES), DisposeAfterUse::YES);
+
+		const uint32 length = stream->getLength().msecs();
+		uint32 seed = 1;
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < iters; i++) {
+			seed = seed * 1103515245 + 12345;
+			stream->seek(Audio::Timestamp((seed >> 8) % length, 1000));
+		}
+		const uint32 time = g_system->getMillis() - start;
+
+		debug("MP3Stream::seek() in %d s of audio avg time (in milliseconds): %f\n", length / 1000, (double)time / iters);
+
+		delete stream;
+#endif
+	}
+};
@@ -0,0 +1,213 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "backends/timer/default/default-timer.h"
+
+#include "../null_osystem.h"
+
+// The timers run on the clock of the null OSystem
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_TIMER 1
+#else
+#define TEST_TIMER 0
+#endif
+
+#if TEST_TIMER
+namespace {
+
+struct TimerCounter {
+	DefaultTimerManager *manager;
+	uint32 calls;
+	uint32 maxCalls;
+};
+
+template<int N>
+void countingProc(void *refCon) {
+	TimerCounter *counter = (TimerCounter *)refCon;
+	counter->calls++;
+	if (counter->maxCalls && counter->calls >= counter->maxCalls)
+		counter->manager->removeTimerProc(&countingProc<N>);
+}
+
+// installTimerProc() does not accept the same callback twice
+const Common::TimerManager::TimerProc countingProcs[] = {
+	countingProc<0>, countingProc<1>, countingProc<2>, countingProc<3>,
+	countingProc<4>, countingProc<5>, countingProc<6>, countingProc<7>,
+	countingProc<8>, countingProc<9>, countingProc<10>, countingProc<11>,
+	countingProc<12>, countingProc<13>, countingProc<14>, countingProc<15>
+};
+
+const int kNumProcs = ARRAYSIZE(countingProcs);
+
+// Runs the timers on a clock which only the test advances
+class ManualTimerManager : public DefaultTimerManager {
+public:
+	ManualTimerManager() : _time(1000) {}
+
+	// Advance the clock one millisecond at a time, running the handler
+	// after each like a backend would
+	void run(uint32 duration) {
+		for (uint32 i = 0; i < duration; i++) {
+			_time++;
+			handler();
+		}
+	}
+
+	// Advance the clock at once, like a handler that runs late
+	void jump(uint32 duration) {
+		_time += duration;
+		handler();
+	}
+
+protected:
+	uint32 getMillis(bool skipRecord) const override { return _time; }
+
+private:
+	uint32 _time;
+};
+
+// The number of calls of a timer in the given time after it was
+// installed. A call is due once the clock has passed the millisecond
+// it falls in.
+uint32 expectedCalls(uint32 interval, uint32 elapsed) {
+	uint32 calls = 0;
+	while ((uint64)(calls + 1) * interval / 1000 < elapsed)
+		calls++;
+	return calls;
+}
+
+} // End of anonymous namespace
+#endif
+
+class DefaultTimerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_interval() {
+#if TEST_TIMER
+		Common::install_null_g_system();
+		ManualTimerManager manager;
+
+		TimerCounter fast = { &manager, 0, 0 };
+		TimerCounter slow = { &manager, 0, 0 };
+		manager.installTimerProc(countingProcs[0], 2000, &fast, "fast");
+		// Far enough ahead to start in the second level of the wheel
+		manager.installTimerProc(countingProcs[1], 300000, &slow, "slow");
+
+		manager.run(700);
+		TS_ASSERT_EQUALS(fast.calls, expectedCalls(2000, 700));
+		TS_ASSERT_EQUALS(slow.calls, expectedCalls(300000, 700));
+
+		// Overdue calls are caught up
+		manager.jump(100);
+		TS_ASSERT_EQUALS(fast.calls, expectedCalls(2000, 800));
+		TS_ASSERT_EQUALS(slow.calls, expectedCalls(300000, 800));
+
+		manager.removeTimerProc(countingProcs[0]);
+		manager.removeTimerProc(countingProcs[1]);
+#endif
+	}
+
+	void test_levels() {
+#if TEST_TIMER
+		Common::install_null_g_system();
+		ManualTimerManager manager;
+
+		// Timers which start in every level of the wheel, run through
+		// several turns of the upper levels with handlers running late
+		static const uint32 intervals[] = { 1500, 100000, 333333, 70000000 };
+		TimerCounter counters[ARRAYSIZE(intervals)];
+		for (int i = 0; i < ARRAYSIZE(intervals); i++) {
+			counters[i].manager = &manager;
+			counters[i].calls = 0;
+			counters[i].maxCalls = 0;
+			manager.installTimerProc(countingProcs[i], intervals[i], &counters[i], Common::String::format("timer%d", i));
+		}
+
+		uint32 elapsed = 0;
+		for (uint32 step = 1; elapsed < 150000; step = step * 7 % 1009) {
+			manager.jump(step);
+			elapsed += step;
+		}
+
+		for (int i = 0; i < ARRAYSIZE(intervals); i++) {
+			TS_ASSERT_EQUALS(counters[i].calls, expectedCalls(intervals[i], elapsed));
+			manager.removeTimerProc(countingProcs[i]);
+		}
+#endif
+	}
+
+	void test_remove() {
+#if TEST_TIMER
+		Common::install_null_g_system();
+		ManualTimerManager manager;
+
+		TimerCounter removed = { &manager, 0, 0 };
+		TimerCounter selfRemoving = { &manager, 0, 3 };
+		manager.installTimerProc(countingProcs[0], 1000, &removed, "removed");
+		manager.installTimerProc(countingProcs[1], 1000, &selfRemoving, "selfRemoving");
+		manager.removeTimerProc(countingProcs[0]);
+
+		manager.run(50);
+		TS_ASSERT_EQUALS(removed.calls, 0u);
+		TS_ASSERT_EQUALS(selfRemoving.calls, 3u);
+
+		// The name is free again after removal
+		manager.installTimerProc(countingProcs[2], 1000, &removed, "removed");
+		manager.run(20);
+		TS_ASSERT_EQUALS(removed.calls, expectedCalls(1000, 20));
+		manager.removeTimerProc(countingProcs[2]);
+
+		Common::Array<DefaultTimerManager::TimerStatistics> stats;
+		manager.getStatistics(stats);
+		TS_ASSERT(stats.empty());
+#endif
+	}
+
+	void test_jitter() {
+#if TEST_TIMER
+		Common::install_null_g_system();
+		ManualTimerManager manager;
+
+		TimerCounter counters[kNumProcs];
+		for (int i = 0; i < kNumProcs; i++) {
+			counters[i].manager = &manager;
+			counters[i].calls = 0;
+			counters[i].maxCalls = 0;
+			manager.installTimerProc(countingProcs[i], 1000 + i * 1250, &counters[i], Common::String::format("timer%d", i));
+		}
+
+		manager.run(250);
+
+		Common::Array<DefaultTimerManager::TimerStatistics> stats;
+		manager.getStatistics(stats);
+		TS_ASSERT_EQUALS(stats.size(), (uint)kNumProcs);
+
+		for (uint i = 0; i < stats.size(); i++) {
+			TS_ASSERT_EQUALS(stats[i].calls, counters[i].calls);
+			TS_ASSERT_EQUALS(stats[i].calls, expectedCalls(stats[i].interval, 250));
+
+			// The handler runs in the millisecond after each call is due,
+			// so a call is late by the rest of the millisecond it falls in
+			uint32 maxLateness = 0;
+			uint64 totalLateness = 0;
+			for (uint32 call = 1; call <= stats[i].calls; call++) {
+				const uint32 lateness = 1000 - (uint32)((uint64)call * stats[i].interval % 1000);
+				maxLateness = MAX(maxLateness, lateness);
+				totalLateness += lateness;
+			}
+			TS_ASSERT_EQUALS(stats[i].maxLateness, maxLateness);
+			TS_ASSERT_EQUALS(stats[i].totalLateness, totalLateness);
+		}
+
+		// A handler running 50 ms late shows up in the statistics. The
+		// 1 ms timer was due right at the end of the last run.
+		manager.jump(50);
+		manager.getStatistics(stats);
+		TS_ASSERT_EQUALS(stats[0].interval, 1000u);
+		TS_ASSERT_EQUALS(stats[0].maxLateness, 50000u);
+		TS_ASSERT_EQUALS(stats[0].calls, expectedCalls(1000, 300));
+
+		for (int i = 0; i < kNumProcs; i++)
+			manager.removeTimerProc(countingProcs[i]);
+#endif
+	}
+};
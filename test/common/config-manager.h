@@ -0,0 +1,185 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_CONFIG_MANAGER 1
+#else
+#define TEST_CONFIG_MANAGER 0
+#endif
+
+class ConfigManagerTestSuite : public CxxTest::TestSuite {
+	bool load(const char *config) {
+		Common::MemoryReadStream stream((const byte *)config, strlen(config));
+		return ConfMan.loadFromStream(stream);
+	}
+
+	Common::String save() {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		TS_ASSERT(ConfMan.saveToStream(stream));
+		return Common::String((const char *)stream.getData(), stream.size());
+	}
+
+	public:
+	void setUp() {
+#if TEST_CONFIG_MANAGER
+		// The ConfigManager creates its mutexes right away
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+		Common::ConfigManager::destroy();
+	}
+
+	void test_load() {
+#if TEST_CONFIG_MANAGER
+		TS_ASSERT(load("# app\n[scummvm]\nversioninfo=1\n\n[monkey]\ngameid=monkey\n# fs\n  fullscreen = true \n\n[misc]\nkey=value\n"));
+
+		TS_ASSERT(ConfMan.hasGameDomain("monkey"));
+		TS_ASSERT(ConfMan.hasMiscDomain("misc"));
+		TS_ASSERT(!ConfMan.hasGameDomain("misc"));
+
+		const Common::ConfigManager::Domain *domain = ConfMan.getDomain("monkey");
+		TS_ASSERT(domain);
+		TS_ASSERT_EQUALS(domain->getVal("fullscreen"), "true");
+		TS_ASSERT_EQUALS(domain->getKVComment("fullscreen"), "# fs\n");
+		TS_ASSERT_EQUALS(ConfMan.getDomain("scummvm")->getDomainComment(), "# app\n");
+		TS_ASSERT_EQUALS(ConfMan.get("key", "misc"), "value");
+#endif
+	}
+
+	void test_line_endings() {
+#if TEST_CONFIG_MANAGER
+		TS_ASSERT(load("\xEF\xBB\xBF[scummvm]\r\nversioninfo=1\r\n[game]\rgameid=game\rpath=/games\r"));
+
+		TS_ASSERT(ConfMan.hasGameDomain("game"));
+		TS_ASSERT_EQUALS(ConfMan.get("versioninfo", "scummvm"), "1");
+		TS_ASSERT_EQUALS(ConfMan.get("path", "game"), "/games");
+#endif
+	}
+
+	void test_errors() {
+#if TEST_CONFIG_MANAGER
+		TS_ASSERT(!load("[scummvm\nversioninfo=1\n"));
+		TS_ASSERT(!load("[scumm vm]\nversioninfo=1\n"));
+		TS_ASSERT(!load("versioninfo=1\n"));
+		TS_ASSERT(!load("[scummvm]\nversioninfo\n"));
+#endif
+	}
+
+	void test_round_trip() {
+#if TEST_CONFIG_MANAGER
+		// Domains which are not accessed are written as they were read
+		static const char *config =
+			"[scummvm]\nversioninfo=1\n\n"
+			"# comment\n[monkey]\ngameid=monkey\n# fs\nfullscreen=true\n\n"
+			"[tentacle]\ngameid=tentacle\nzz=1\naa=2\n\n";
+		TS_ASSERT(load(config));
+		TS_ASSERT_EQUALS(save(), config);
+
+		ConfMan.set("fullscreen", "false", "monkey");
+		Common::String saved = save();
+		TS_ASSERT(saved.contains("# fs\nfullscreen=false\n"));
+		TS_ASSERT(saved.hasSuffix("[tentacle]\ngameid=tentacle\nzz=1\naa=2\n\n"));
+
+		ConfMan.removeGameDomain("tentacle");
+		TS_ASSERT(load(save().c_str()));
+		TS_ASSERT(!ConfMan.hasGameDomain("tentacle"));
+		TS_ASSERT_EQUALS(ConfMan.get("fullscreen", "monkey"), "false");
+#endif
+	}
+
+	void test_read_domains_written_verbatim() {
+#if TEST_CONFIG_MANAGER
+		// Reading a domain parses it, but only modifying it drops its lines
+		static const char *config =
+			"[scummvm]\nversioninfo=1\n\n"
+			"[monkey]\ngameid=monkey\n# fs\n  fullscreen = true \n\n"
+			"[tentacle]\ngameid=tentacle\nzz=1\naa=2\n\n";
+		TS_ASSERT(load(config));
+
+		for (const auto &domain : ConfMan.getGameDomains())
+			TS_ASSERT_EQUALS(domain._value.getVal("gameid"), domain._key);
+		TS_ASSERT_EQUALS(ConfMan.get("fullscreen", "monkey"), "true");
+		TS_ASSERT_EQUALS(save(), config);
+
+		ConfMan.getDomain("tentacle")->erase("zz");
+		Common::String saved = save();
+		TS_ASSERT(saved.contains("[monkey]\ngameid=monkey\n# fs\n  fullscreen = true \n\n"));
+		TS_ASSERT(saved.hasSuffix("[tentacle]\naa=2\ngameid=tentacle\n\n"));
+#endif
+	}
+
+	void test_parsed_when_handed_out() {
+#if TEST_CONFIG_MANAGER
+		TS_ASSERT(load("[scummvm]\nversioninfo=1\n\n[monkey]\ngameid=monkey\n\n[tentacle]\ngameid=tentacle\n\n[misc]\nkey=value\n"));
+
+		// The accessors of a domain do not parse it themselves
+		const Common::ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
+		for (const auto &domain : domains)
+			TS_ASSERT_EQUALS(domain._value.getVal("gameid"), domain._key);
+
+		const Common::ConfigManager &constMan = ConfMan;
+		TS_ASSERT(constMan.getDomain("misc")->contains("key"));
+		TS_ASSERT(ConfMan.getDomain("scummvm")->contains("versioninfo"));
+#endif
+	}
+
+	void test_many_domains() {
+#if TEST_CONFIG_MANAGER
+		Common::String config = "[scummvm]\nversioninfo=1\n\n";
+		for (int i = 0; i < 10000; i++)
+			config += Common::String::format("[game%d]\ngameid=game\ndescription=Game %d\npath=/games/%d\n\n", i, i, i);
+
+		TS_ASSERT(load(config.c_str()));
+		TS_ASSERT(ConfMan.hasGameDomain("game9999"));
+		TS_ASSERT_EQUALS(ConfMan.get("path", "game1234"), "/games/1234");
+		TS_ASSERT_EQUALS(save(), config);
+#endif
+	}
+
+	void test_load_flush_benchmark() {
+#if TEST_CONFIG_MANAGER
+#ifdef SLOW_TESTS
+		const int domains = 20000;
+		const int iters = 20;
+#else
+		const int domains = 1000;
+		const int iters = 2;
+#endif
+		Common::String config = "[scummvm]\nversioninfo=1\n\n";
+		for (int i = 0; i < domains; i++)
+			config += Common::String::format("[game%d]\ngameid=game\ndescription=Game %d\npath=/games/%d\n\n", i, i, i);
+
+		// Like the launcher: load, list every game, then flush after
+		// changing one setting
+		uint32 loadTime = 0, listTime = 0, flushTime = 0;
+		for (int i = 0; i < iters; i++) {
+			uint32 start = g_system->getMillis();
+			TS_ASSERT(load(config.c_str()));
+			loadTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			int described = 0;
+			for (const auto &domain : ConfMan.getGameDomains())
+				described += domain._value.contains("description");
+			listTime += g_system->getMillis() - start;
+			TS_ASSERT_EQUALS(described, domains);
+
+			ConfMan.set("lastselectedgame", "game0", Common::ConfigManager::kApplicationDomain);
+			start = g_system->getMillis();
+			save();
+			flushTime += g_system->getMillis() - start;
+		}
+
+		debug("ConfigManager %d domains avg time (in milliseconds): load %f, list %f, flush %f\n",
+		      domains, (double)loadTime / iters, (double)listTime / iters, (double)flushTime / iters);
+#endif
+	}
+};
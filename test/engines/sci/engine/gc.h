@@ -0,0 +1,105 @@
+#include <cxxtest/TestSuite.h>
+
+// The engines' detection headers use the same names for their game options,
+// and all tests are built as one file
+#undef GAMEOPTION_ORIGINAL_SAVELOAD
+
+#include "engines/sci/engine/gc.h"
+#include "engines/sci/engine/kernel.h"
+#include "engines/sci/resource/resource.h"
+
+namespace Sci {
+// Declared in engines/sci/resource/resource.cpp
+extern SciVersion g_sciVersion;
+}
+
+/**
+ * A locked resource held in memory, which the resource manager never loads.
+ */
+class SciTestResource : public Sci::Resource {
+public:
+	SciTestResource(Sci::ResourceManager *resMan, Sci::ResourceId id, const byte *data, uint32 size) : Sci::Resource(resMan, id) {
+		byte *copy = new byte[size];
+		if (size)
+			memcpy(copy, data, size);
+		_data = copy;
+		_size = size;
+		_status = Sci::kResStatusLocked;
+		_lockers = 1;
+	}
+};
+
+/**
+ * A resource manager without resource files, which provides the class table
+ * the segment manager reads from vocab 996.
+ */
+class SciTestResourceManager : public Sci::ResourceManager {
+public:
+	SciTestResourceManager() {
+		_maxMemoryLRU = 256 * 1024;
+		_memoryLocked = 0;
+		_memoryLRU = 0;
+
+		// An empty class table, as the tests only use dynamically allocated
+		// objects. Reading class entries would also need the engine, for the
+		// platform.
+		const Sci::ResourceId id(Sci::kResourceTypeVocab, 996);
+		_resMap.setVal(id, new SciTestResource(this, id, nullptr, 0));
+	}
+};
+
+/**
+ * Test suite for the incremental garbage collector in engines/sci/engine/gc.h
+ */
+
+class SciIncrementalGCTestSuite : public CxxTest::TestSuite {
+	public:
+	void setUp() {
+		Sci::g_sciVersion = Sci::SCI_VERSION_1_1;
+	}
+
+	void tearDown() {
+		Sci::g_sciVersion = Sci::SCI_VERSION_NONE;
+	}
+
+	void test_delete_key_while_marking() {
+		SciTestResourceManager resMan;
+		Sci::SegManager segMan(&resMan, nullptr);
+		Sci::EngineState s(&segMan);
+
+		// A list with the nodes P, N, S and T, keyed 1 to 4
+		Sci::reg_t list;
+		segMan.allocateList(&list);
+		Sci::reg_t nodes[4];
+		for (int i = 0; i < 4; i++) {
+			nodes[i] = segMan.newNode(Sci::NULL_REG, Sci::make_reg(0, i + 1));
+			Sci::reg_t argv[2] = { list, nodes[i] };
+			Sci::kAddToEnd(&s, 2, argv);
+		}
+
+		Sci::IncrementalGC gc;
+		gc.setStepBudget(1);
+		gc.beginMark(&segMan);
+		segMan.writeBarrier(list);
+
+		// Trace the list, which queues P and T, then T, which queues S
+		TS_ASSERT(!gc.markStep(&segMan));
+		TS_ASSERT(!gc.markStep(&segMan));
+		TS_ASSERT(gc.isMarked(nodes[2]));
+		TS_ASSERT(!gc.isMarked(nodes[1]));
+
+		// Deleting S and P leaves N referenced only by the list and T, which
+		// have both been traced already
+		Sci::reg_t argv[2] = { list, Sci::make_reg(0, 3) };
+		TS_ASSERT_EQUALS(Sci::kDeleteKey(&s, 2, argv), Sci::make_reg(0, 1));
+		argv[1] = Sci::make_reg(0, 1);
+		TS_ASSERT_EQUALS(Sci::kDeleteKey(&s, 2, argv), Sci::make_reg(0, 1));
+
+		gc.setStepBudget(0);
+		TS_ASSERT(gc.markStep(&segMan));
+		TS_ASSERT(gc.isMarked(nodes[1]));
+		TS_ASSERT(gc.isMarked(nodes[3]));
+
+		gc.cancel(&segMan);
+	}
+};
@@ -0,0 +1,217 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "common/system.h"
+#include "engines/scumm/imuse_digi/dimuse_engine.h"
+#include "engines/scumm/imuse_digi/dimuse_internalmixer.h"
+
+#include "../../../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_IMUSE_MIXER 1
+#else
+#define TEST_IMUSE_MIXER 0
+#endif
+
+/**
+ * Test suite for the Digital iMUSE software mixer in
+ * engines/scumm/imuse_digi/dimuse_internalmixer.h
+ */
+
+class IMuseDigiInternalMixerTestSuite : public CxxTest::TestSuite {
+	enum {
+		kFeedSize = 512,
+		kMixBufFrames = 2 * kFeedSize + 16
+	};
+
+	uint32 _seed;
+	uint16 _mixBuf[2 * kMixBufFrames];
+	uint8 _src[4 * 2 * kFeedSize + 64];
+
+	uint8 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	uint32 hashMixBuffer(uint32 hash) {
+		for (int i = 0; i < ARRAYSIZE(_mixBuf); i++)
+			hash = (hash ^ _mixBuf[i]) * 16777619;
+		return hash;
+	}
+
+	static bool hasSSE2() {
+#ifdef SCUMMVM_SSE2
+		return instrset_detect() >= 2;
+#else
+		return false;
+#endif
+	}
+
+#if TEST_IMUSE_MIXER
+	// Mixes random sources of every sample format and channel layout, at
+	// the output rate and resampled, and hashes the mixing buffer after
+	// every track
+	uint32 mixAll(int outChannelCount, bool useSSE2) {
+		static const int volumes[] = { 0, 1, 37, 64, 127 };
+		static const int pans[] = { 0, 20, 64, 100, 127 };
+		static const int wordSizes[] = { 8, 12, 16 };
+		// Pairs of source frames and output frames
+		static const int rates[][2] = {
+			{ kFeedSize, kFeedSize }, { 31, 31 }, { kFeedSize / 2, kFeedSize },
+			{ kFeedSize, kFeedSize / 2 }, { kFeedSize / 4, kFeedSize }, { 300, kFeedSize }
+		};
+
+		Scumm::IMuseDigiInternalMixer mixer(g_system->getMixer(), 22050, false);
+		mixer.init(16, outChannelCount, (uint8 *)_mixBuf, sizeof(_mixBuf), 0, 6);
+		mixer._useSSE2 = useSSE2;
+
+		_seed = 1;
+		memset(_mixBuf, 0, sizeof(_mixBuf));
+		uint32 hash = 2166136261u;
+
+		for (int w = 0; w < ARRAYSIZE(wordSizes); w++) {
+			for (int channelCount = 1; channelCount <= 2; channelCount++) {
+				for (int r = 0; r < ARRAYSIZE(rates); r++) {
+					for (int v = 0; v < ARRAYSIZE(volumes); v++) {
+						for (int p = 0; p < ARRAYSIZE(pans); p++) {
+							for (int i = 0; i < ARRAYSIZE(_src); i++)
+								_src[i] = nextRandom();
+
+							// An odd start checks unaligned mixing
+							const int start = (v + p) & 3;
+							mixer.mix(_src, rates[r][0], wordSizes[w], channelCount, rates[r][1], start, volumes[v], pans[p], false);
+							hash = hashMixBuffer(hash);
+						}
+					}
+				}
+			}
+		}
+
+		return hash;
+	}
+#endif
+
+public:
+	void setUp() {
+#if TEST_IMUSE_MIXER
+		Common::install_null_g_system();
+#endif
+	}
+
+	void test_golden_output() {
+#if TEST_IMUSE_MIXER
+		// Recorded from the table lookups, before SIMD mixing was added
+		TS_ASSERT_EQUALS(mixAll(1, false), 2000725804u);
+		TS_ASSERT_EQUALS(mixAll(2, false), 209842882u);
+
+		if (hasSSE2()) {
+			TS_ASSERT_EQUALS(mixAll(1, true), 2000725804u);
+			TS_ASSERT_EQUALS(mixAll(2, true), 209842882u);
+		}
+#endif
+	}
+
+	void test_sse2_amplitudes() {
+#ifdef SCUMMVM_SSE2
+		if (!hasSSE2())
+			return;
+
+		// Every sample at every scale the amplitude tables are built with,
+		// in the lanes and in the tail
+		uint8 samples8[256 + 7];
+		int16 samples12[4096 + 7];
+		uint16 samples16[4096 + 7];
+		for (int i = 0; i < ARRAYSIZE(samples8); i++)
+			samples8[i] = i;
+		for (int i = 0; i < ARRAYSIZE(samples12); i++) {
+			samples12[i] = (i & 4095) - 2048;
+			samples16[i] = (uint16)(samples12[i] * 16 + (i & 15));
+		}
+
+		static uint16 actual[2 * (4096 + 7)], expected[2 * (4096 + 7)];
+		for (int z = 0; z <= 127; z++) {
+			memset(actual, 0, sizeof(actual));
+			Scumm::mixBits8SSE2(actual, samples8, ARRAYSIZE(samples8), 16 * z);
+			for (int i = 0; i < ARRAYSIZE(samples8); i++)
+				TS_ASSERT_EQUALS((int16)actual[i], (int16)(16 * z * (samples8[i] - 128) / 127));
+
+			memset(actual, 0, sizeof(actual));
+			memset(expected, 0, sizeof(expected));
+			Scumm::mixCenteredToStereoSSE2(actual, samples12, ARRAYSIZE(samples12), z, 127 - z);
+			Scumm::mixBits16ToStereoSSE2(expected, samples16, ARRAYSIZE(samples16), z, 127 - z);
+			for (int i = 0; i < ARRAYSIZE(samples12); i++) {
+				TS_ASSERT_EQUALS((int16)actual[2 * i], (int16)(z * samples12[i] / 127));
+				TS_ASSERT_EQUALS((int16)actual[2 * i + 1], (int16)((127 - z) * samples12[i] / 127));
+			}
+			TS_ASSERT_SAME_DATA(actual, expected, sizeof(actual));
+		}
+#endif
+	}
+
+	void test_bits12_upsampled_to_mono() {
+#if TEST_IMUSE_MIXER
+		// Upsampling stereo 12-bit frames to mono puts every frame at the
+		// even positions, like mixing each frame twice at the output rate
+		Scumm::IMuseDigiInternalMixer mixer(g_system->getMixer(), 22050, false);
+		mixer.init(16, 1, (uint8 *)_mixBuf, sizeof(_mixBuf), 0, 6);
+
+		_seed = 1;
+		uint8 frames[3 * kFeedSize / 2];
+		for (int i = 0; i < ARRAYSIZE(frames); i++)
+			frames[i] = nextRandom();
+		for (int i = 0; i < kFeedSize / 2; i++) {
+			memcpy(_src + 6 * i, frames + 3 * i, 3);
+			memcpy(_src + 6 * i + 3, frames + 3 * i, 3);
+		}
+
+		uint16 expected[kFeedSize];
+		memset(_mixBuf, 0, sizeof(_mixBuf));
+		mixer.mix(_src, kFeedSize, 12, 2, kFeedSize, 0, 127, 64, false);
+		memcpy(expected, _mixBuf, sizeof(expected));
+
+		memset(_mixBuf, 0, sizeof(_mixBuf));
+		mixer.mix(frames, kFeedSize / 2, 12, 2, kFeedSize, 0, 127, 64, false);
+		for (int i = 0; i < kFeedSize; i += 2)
+			TS_ASSERT_EQUALS(_mixBuf[i], expected[i]);
+#endif
+	}
+
+	void test_mix_benchmark() {
+#if TEST_IMUSE_MIXER
+#ifdef SLOW_TESTS
+		const int iters = 20000;
+#else
+		const int iters = 500;
+#endif
+		// A callback mixes 16 tracks at the output rate, in the formats and
+		// layouts of the games
+		static const int formats[][2] = { { 16, 1 }, { 12, 1 }, { 8, 1 }, { 16, 2 } };
+
+		Scumm::IMuseDigiInternalMixer mixer(g_system->getMixer(), 22050, false);
+		mixer.init(16, 2, (uint8 *)_mixBuf, sizeof(_mixBuf), 0, 6);
+		uint16 output[2 * kFeedSize];
+		uint8 *outputPtr = (uint8 *)output;
+
+		for (int i = 0; i < ARRAYSIZE(_src); i++)
+			_src[i] = nextRandom();
+
+		for (int simd = 0; simd <= (hasSSE2() ? 1 : 0); simd++) {
+			mixer._useSSE2 = simd;
+
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iters; i++) {
+				mixer.clearMixerBuffer();
+				for (int track = 0; track < 16; track++) {
+					const int *format = formats[track % ARRAYSIZE(formats)];
+					mixer.mix(_src + 2 * track, kFeedSize, format[0], format[1], kFeedSize, 0, 32 + 2 * track, 8 * track, false);
+				}
+				mixer.loop(&outputPtr, kFeedSize);
+			}
+			const uint32 time = g_system->getMillis() - start;
+
+			debug("IMuseDigiInternalMixer 16 tracks per callback avg time (in milliseconds): %s %f\n",
+			      simd ? "SSE2" : "scalar", (double)time / iters);
+		}
+#endif
+	}
+};
@@ -0,0 +1,83 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/resource.h"
+
+/**
+ * Test suite for the eviction policies of the resource manager in
+ * engines/scumm/resource.h. The resource with the highest score is
+ * expired first.
+ */
+class ScummResourceEvictionTestSuite : public CxxTest::TestSuite {
+	static uint64 score(Scumm::ResourceEvictionPolicy policy, Scumm::ResType type, byte counter, uint32 size, uint16 uses) {
+		return Scumm::ResourceManager::getExpireScore(policy, type, counter, size, uses);
+	}
+
+public:
+	void test_oldest() {
+		// Only the age counts
+		TS_ASSERT_LESS_THAN(score(Scumm::kEvictOldest, Scumm::rtSound, 2, 100000, 0),
+		                    score(Scumm::kEvictOldest, Scumm::rtScript, 3, 100, 50));
+		TS_ASSERT_EQUALS(score(Scumm::kEvictOldest, Scumm::rtRoom, 5, 100000, 0),
+		                 score(Scumm::kEvictOldest, Scumm::rtCostume, 5, 100, 50));
+	}
+
+	void test_cost_aware() {
+		// Of equally old and big resources, the one that is cheaper to
+		// load again goes first
+		TS_ASSERT_LESS_THAN(score(Scumm::kEvictCostAware, Scumm::rtRoom, 10, 50000, 0),
+		                    score(Scumm::kEvictCostAware, Scumm::rtSound, 10, 50000, 0));
+		TS_ASSERT_LESS_THAN(score(Scumm::kEvictCostAware, Scumm::rtImage, 10, 50000, 0),
+		                    score(Scumm::kEvictCostAware, Scumm::rtCostume, 10, 50000, 0));
+
+		// Bigger resources go first, unless they are much younger
+		TS_ASSERT_LESS_THAN(score(Scumm::kEvictCostAware, Scumm::rtSound, 10, 1000, 0),
+		                    score(Scumm::kEvictCostAware, Scumm::rtSound, 10, 2000, 0));
+		TS_ASSERT_LESS_THAN(score(Scumm::kEvictCostAware, Scumm::rtSound, 2, 2000, 0),
+		                    score(Scumm::kEvictCostAware, Scumm::rtSound, 10, 1000, 0));
+
+		// Uses do not matter
+		TS_ASSERT_EQUALS(score(Scumm::kEvictCostAware, Scumm::rtSound, 10, 1000, 0),
+		                 score(Scumm::kEvictCostAware, Scumm::rtSound, 10, 1000, 100));
+	}
+
+	void test_least_frequent() {
+		// Of equally old resources, the one used less often goes first
+		TS_ASSERT_LESS_THAN(score(Scumm::kEvictLeastFrequent, Scumm::rtScript, 10, 100, 8),
+		                    score(Scumm::kEvictLeastFrequent, Scumm::rtScript, 10, 100, 2));
+
+		// Of equally often used resources, the older one goes first,
+		// even with many uses
+		TS_ASSERT_LESS_THAN(score(Scumm::kEvictLeastFrequent, Scumm::rtScript, 10, 100, 0xFFFF),
+		                    score(Scumm::kEvictLeastFrequent, Scumm::rtScript, 11, 100, 0xFFFF));
+
+		// A resource used again and again is kept longer than a younger
+		// one that was only loaded once
+		TS_ASSERT_LESS_THAN(score(Scumm::kEvictLeastFrequent, Scumm::rtRoom, 20, 100000, 20),
+		                    score(Scumm::kEvictLeastFrequent, Scumm::rtSound, 2, 100, 0));
+
+		// Size and type do not matter
+		TS_ASSERT_EQUALS(score(Scumm::kEvictLeastFrequent, Scumm::rtRoom, 10, 100000, 3),
+		                 score(Scumm::kEvictLeastFrequent, Scumm::rtSound, 10, 100, 3));
+	}
+
+	void test_policy_names() {
+		static const Scumm::ResourceEvictionPolicy policies[] = {
+			Scumm::kEvictOldest, Scumm::kEvictCostAware, Scumm::kEvictLeastFrequent
+		};
+
+		for (int i = 0; i < ARRAYSIZE(policies); i++) {
+			Scumm::ResourceEvictionPolicy policy = Scumm::kEvictOldest;
+			TS_ASSERT(Scumm::ResourceManager::parseEvictionPolicy(Scumm::ResourceManager::getEvictionPolicyName(policies[i]), policy));
+			TS_ASSERT_EQUALS(policy, policies[i]);
+		}
+
+		Scumm::ResourceEvictionPolicy policy = Scumm::kEvictCostAware;
+		TS_ASSERT(!Scumm::ResourceManager::parseEvictionPolicy("newest", policy));
+		TS_ASSERT_EQUALS(policy, Scumm::kEvictCostAware);
+	}
+
+	void test_heap_size_fits() {
+		// setHeapSize() passes the budget in bytes as int
+		TS_ASSERT_LESS_THAN_EQUALS((uint64)Scumm::ResourceManager::kMaxHeapSize * 1024, (uint64)0x7FFFFFFF);
+	}
+};
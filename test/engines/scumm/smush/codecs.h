@@ -0,0 +1,197 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/system.h"
+#include "engines/scumm/smush/codec37.h"
+#include "engines/scumm/smush/codec47.h"
+
+#include "../../../null_osystem.h"
+
+// The benchmark times with the null OSystem
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_SMUSH_BENCHMARK 1
+#else
+#define TEST_SMUSH_BENCHMARK 0
+#endif
+
+/**
+ * Test suite for the block kernels of the SMUSH codecs 37 and 47 in
+ * engines/scumm/smush/. The expected hashes were taken with the kernels
+ * which moved one or four bytes at a time.
+ */
+class SmushCodecTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 320,
+		kHeight = 200,
+		kBlocks37 = (kWidth / 4) * (kHeight / 4),
+		kBlocks47 = (kWidth / 8) * (kHeight / 8)
+	};
+
+	uint32 _seed;
+	byte _frame[kWidth * kHeight];
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	uint32 hashFrame(uint32 hash) {
+		for (int i = 0; i < ARRAYSIZE(_frame); i++)
+			hash = (hash ^ _frame[i]) * 16777619;
+		return hash;
+	}
+
+	// A codec 37 frame of 4x4 blocks, with the literal blocks and motion
+	// between frames of an animation and runs of unchanged blocks
+	void writeBlocksFrame(Common::Array<byte> &frame, uint16 seqNb, bool withFDFE) {
+		frame.resize(16);
+		memset(frame.data(), 0, 16);
+		frame[0] = seqNb ? 4 : 0;
+		frame[1] = 1;
+		WRITE_LE_UINT16(&frame[2], seqNb);
+		frame[12] = withFDFE ? 4 : 0;
+
+		if (!seqNb) {
+			WRITE_LE_UINT32(&frame[4], kWidth * kHeight);
+			for (int i = 0; i < kWidth * kHeight; i++)
+				frame.push_back(nextRandom());
+			return;
+		}
+
+		int blocks = kBlocks37;
+		while (blocks > 0) {
+			const byte kind = nextRandom() % 16;
+			if (kind < 8) {
+				const int length = MIN<int>(1 + nextRandom() % 64, blocks);
+				frame.push_back(0x00);
+				frame.push_back(length - 1);
+				blocks -= length;
+				continue;
+			}
+
+			if (withFDFE && kind == 8) {
+				frame.push_back(0xFD);
+				frame.push_back(nextRandom());
+			} else if (withFDFE && kind == 9) {
+				frame.push_back(0xFE);
+				for (int i = 0; i < 4; i++)
+					frame.push_back(nextRandom());
+			} else if (kind == 10) {
+				frame.push_back(0xFF);
+				for (int i = 0; i < 16; i++)
+					frame.push_back(nextRandom());
+			} else {
+				frame.push_back(1 + nextRandom() % 0xFC);
+			}
+			blocks--;
+		}
+	}
+
+	// Codes of codec 47 that stay inside the frame: copies from the previous
+	// frame, fills, glyphs and subblocks
+	void writeGlyphsBlock(Common::Array<byte> &frame, int level) {
+		const byte kind = nextRandom() % 5;
+		if (kind == 0) {
+			frame.push_back(0xFC);
+		} else if (kind == 1) {
+			frame.push_back(0xFE);
+			frame.push_back(nextRandom());
+		} else if (kind == 2) {
+			frame.push_back(0xF8 + nextRandom() % 4);
+		} else if (kind == 3 && level < 3) {
+			frame.push_back(0xFD);
+			frame.push_back(nextRandom());
+			frame.push_back(nextRandom());
+			frame.push_back(nextRandom());
+		} else if (level < 3) {
+			frame.push_back(0xFF);
+			for (int i = 0; i < 4; i++)
+				writeGlyphsBlock(frame, level + 1);
+		} else {
+			frame.push_back(0xFF);
+			for (int i = 0; i < 4; i++)
+				frame.push_back(nextRandom());
+		}
+	}
+
+	void writeGlyphsFrame(Common::Array<byte> &frame, uint16 seqNb) {
+		frame.resize(26);
+		memset(frame.data(), 0, 26);
+		WRITE_LE_UINT16(&frame[0], seqNb);
+		frame[2] = 2;
+		for (int i = 8; i < 14; i++)
+			frame[i] = nextRandom();
+
+		for (int i = 0; i < kBlocks47; i++)
+			writeGlyphsBlock(frame, 1);
+	}
+
+public:
+	void test_codec37_blocks() {
+		static const uint32 expected[] = { 1407754598u, 4172568739u };
+
+		for (int withFDFE = 0; withFDFE < 2; withFDFE++) {
+			Scumm::SmushDeltaBlocksDecoder decoder(kWidth, kHeight);
+			Common::Array<byte> frame;
+			_seed = 1;
+			uint32 hash = 2166136261u;
+			for (uint16 seqNb = 0; seqNb < 20; seqNb++) {
+				writeBlocksFrame(frame, seqNb, withFDFE);
+				decoder.decode(_frame, frame.data());
+				hash = hashFrame(hash);
+			}
+			TS_ASSERT_EQUALS(hash, expected[withFDFE]);
+		}
+	}
+
+	void test_codec47_blocks() {
+		Scumm::SmushDeltaGlyphsDecoder decoder(kWidth, kHeight);
+		Common::Array<byte> frame;
+		_seed = 1;
+		uint32 hash = 2166136261u;
+		for (uint16 seqNb = 0; seqNb < 20; seqNb++) {
+			writeGlyphsFrame(frame, seqNb);
+			TS_ASSERT(decoder.decode(_frame, frame.data()));
+			hash = hashFrame(hash);
+		}
+		TS_ASSERT_EQUALS(hash, 620316809u);
+	}
+
+	void test_decode_benchmark() {
+#if TEST_SMUSH_BENCHMARK
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int frames = 5000;
+#else
+		const int frames = 100;
+#endif
+		// The frames are written beforehand, so only decoding is timed
+		const int written = 50;
+		Common::Array<byte> blocksFrames[written], glyphsFrames[written];
+		_seed = 1;
+		for (int i = 0; i < written; i++) {
+			writeBlocksFrame(blocksFrames[i], i, true);
+			writeGlyphsFrame(glyphsFrames[i], i);
+		}
+
+		// Every pass over the frames starts with the first one, which
+		// decodes without the previous ones
+		Scumm::SmushDeltaBlocksDecoder blocks(kWidth, kHeight);
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < frames; i++)
+			blocks.decode(_frame, blocksFrames[i % written].data());
+		const uint32 blocksTime = g_system->getMillis() - start;
+
+		Scumm::SmushDeltaGlyphsDecoder glyphs(kWidth, kHeight);
+		start = g_system->getMillis();
+		for (int i = 0; i < frames; i++)
+			glyphs.decode(_frame, glyphsFrames[i % written].data());
+		const uint32 glyphsTime = g_system->getMillis() - start;
+
+		debug("SMUSH %dx%d frame decoding avg time (in milliseconds): codec 37 %f, codec 47 %f\n",
+		      kWidth, kHeight, (double)blocksTime / frames, (double)glyphsTime / frames);
+#endif
+	}
+};
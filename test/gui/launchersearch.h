@@ -0,0 +1,197 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+#include "common/system.h"
+#include "common/tokenizer.h"
+#include "gui/launcher.h"
+#include "gui/launchersearch.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_LAUNCHER_SEARCH 1
+#else
+#define TEST_LAUNCHER_SEARCH 0
+#endif
+
+/**
+ * Compares the launcher search index with the matchers the launcher used
+ * before, which looked at every target for every word.
+ */
+class LauncherSearchIndexTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+	int _targetCount;
+	Common::Array<GUI::LauncherEntry> _entries;
+
+	uint nextRandom(uint range) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) % range;
+	}
+
+	// The matcher of the launcher list, for one word
+	static bool listMatcher(const Common::String &domain, const Common::U32String &item, const Common::U32String &token_) {
+		bool invert = false;
+		Common::U32String token(token_);
+
+		while (token.size() && token[0] == '!') {
+			token = token.substr(1);
+			invert = !invert;
+		}
+
+		bool result = false;
+		Common::String token8 = token;
+		size_t pos = token8.findFirstOf(":=~");
+		if (pos != token8.npos) {
+			Common::String key = token8.substr(0, pos);
+			Common::String filter = token8.substr(pos + 1);
+
+			static const char *const keys[] = { "description", "engineid", "gameid", "language", "path", "platform" };
+			if (key.size()) {
+				for (int i = 0; i < ARRAYSIZE(keys); i++) {
+					if (Common::String(keys[i]).hasPrefix(key)) {
+						key = keys[i];
+						break;
+					}
+				}
+			}
+
+			Common::String data;
+			if (ConfMan.hasKey(key, domain))
+				data = ConfMan.get(key, domain);
+			data.toLowercase();
+
+			if (token8[pos] == ':')
+				result = data.contains(filter);
+			else if (token8[pos] == '=')
+				result = data == filter;
+			else
+				result = data.matchString(filter);
+		} else {
+			result = item.contains(token);
+		}
+
+		return invert ? !result : result;
+	}
+
+	// Every word has to match, in the list the description and in the grid
+	// the title, which only matched plain words
+	bool oldMatches(const GUI::LauncherEntry &entry, const Common::U32String &filter, bool grid) {
+		Common::U32String item(grid ? entry.title : entry.description);
+		item.toLowercase();
+
+		Common::U32StringTokenizer tok(filter);
+		while (!tok.empty()) {
+			Common::U32String token = tok.nextToken();
+			if (grid ? !item.contains(token) : !listMatcher(entry.key, item, token))
+				return false;
+		}
+		return true;
+	}
+
+	void compare(GUI::LauncherSearchIndex &index, const char *const *filters, int count, bool grid) {
+		for (int f = 0; f < count; f++) {
+			const Common::U32String filter = Common::U32String(filters[f], Common::kUtf8);
+			Common::Array<bool> matches;
+			index.search(filter, matches);
+
+			TS_ASSERT_EQUALS(matches.size(), _entries.size());
+			for (uint i = 0; i < _entries.size() && i < matches.size(); i++) {
+				if (matches[i] != oldMatches(_entries[i], filter, grid))
+					TS_FAIL(Common::String::format("'%s' on %s", filters[f], _entries[i].key.c_str()).c_str());
+			}
+		}
+	}
+
+	void addTargets(int count) {
+		static const char *const titles[] = {
+			"The Secret of Monkey Island", "Day of the Tentacle", "Zak McKracken", "Space Quest",
+			"King's Quest", "Loom", "Gabriel Knight", "Les Aventures de Pépé"
+		};
+		static const char *const engines[][2] = { { "scumm", "monkey" }, { "scumm", "tentacle" }, { "scumm", "zak" },
+			{ "sci", "sq1" }, { "sci", "kq1" }, { "scumm", "loom" }, { "sci", "gk1" }, { "agi", "pepe" } };
+		static const char *const platforms[] = { "pc", "amiga", "macintosh", "fmtowns" };
+		static const char *const languages[] = { "en", "de", "fr", "it" };
+		static const char *const extras[] = { "", "CD", "VGA", "Demo" };
+
+		for (int n = 0; n < count; n++) {
+			const int i = _targetCount++;
+			const int game = nextRandom(ARRAYSIZE(titles));
+			const char *platform = platforms[nextRandom(ARRAYSIZE(platforms))];
+			const char *language = languages[nextRandom(ARRAYSIZE(languages))];
+			const char *extra = extras[nextRandom(ARRAYSIZE(extras))];
+
+			const Common::String key = Common::String::format("%s-%d", engines[game][1], i);
+			const Common::String description = Common::String::format("%s %s(%s/%s%s)", titles[game], extra,
+				platform == platforms[0] ? "DOS" : platform, language, i % 7 ? "" : "/Ünïcode");
+
+			ConfMan.addGameDomain(key);
+			ConfMan.set("engineid", engines[game][0], key);
+			ConfMan.set("gameid", engines[game][1], key);
+			ConfMan.set("description", description, key);
+			ConfMan.set("platform", platform, key);
+			ConfMan.set("language", language, key);
+			ConfMan.set("path", Common::String::format("/games/%d", i), key);
+			if (*extra)
+				ConfMan.set("extra", extra, key);
+
+			_entries.push_back(GUI::LauncherEntry(key, engines[game][0], engines[game][1], description, titles[game], ConfMan.getDomain(key)));
+		}
+	}
+
+public:
+	void setUp() {
+#if TEST_LAUNCHER_SEARCH
+		Common::install_null_g_system();
+		_seed = 1;
+		_targetCount = 0;
+		_entries.clear();
+#endif
+	}
+
+	void tearDown() {
+		Common::ConfigManager::destroy();
+	}
+
+	void test_list_matches_old_matcher() {
+#if TEST_LAUNCHER_SEARCH
+		static const char *const filters[] = {
+			"", "dos", "monkey", "mon isl", "!dos", "!!dos", "x", "q", "qu", "quest", "quest dos !kin",
+			"pépé", "ünï", "(amiga/", "plat:amiga", "platform=pc", "pl=fmtowns !lang:en", "lang~?e", "l~*",
+			"engine:sc", "e=sci", "gameid=monkey", "g:o", "desc:island", "d=loom", "extra:cd", "ext=demo",
+			"!extra:", "path:/games/1", "pa~*/2?", ":monkey", "=pc", "unknown:x", "!unknown:"
+		};
+
+		addTargets(300);
+		GUI::LauncherSearchIndex index;
+		index.update(_entries, false);
+		compare(index, filters, ARRAYSIZE(filters), false);
+
+		// Targets which change, come and go keep their matches
+		ConfMan.set("platform", "amiga", _entries[5].key);
+		_entries[10].description = "Renamed (Amiga/en)";
+		_entries.remove_at(20);
+		addTargets(10);
+		index.update(_entries, false);
+		compare(index, filters, ARRAYSIZE(filters), false);
+#endif
+	}
+
+	void test_grid_matches_titles() {
+#if TEST_LAUNCHER_SEARCH
+		static const char *const filters[] = {
+			"", "dos", "monkey", "mon isl", "x", "q", "quest", "quest king", "pépé", "the", "cd", "amiga"
+		};
+
+		addTargets(300);
+		GUI::LauncherSearchIndex index;
+		index.update(_entries, true);
+		compare(index, filters, ARRAYSIZE(filters), true);
+
+		// Only the descriptions mention the platform
+		Common::Array<bool> matches;
+		index.search(Common::U32String("dos"), matches);
+		for (uint i = 0; i < matches.size(); i++)
+			TS_ASSERT(!matches[i]);
+#endif
+	}
+};
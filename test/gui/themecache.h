@@ -0,0 +1,137 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/system.h"
+#include "graphics/managed_surface.h"
+#include "gui/ThemeCache.h"
+#include "gui/ThemeEval.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_THEME_CACHE 1
+#else
+#define TEST_THEME_CACHE 0
+#endif
+
+class ThemeCacheTestSuite : public CxxTest::TestSuite {
+	GUI::ThemeCache::Key _key;
+	Graphics::ManagedSurface _bitmap;
+
+	// Records a bit of everything, with the bitmap last
+	void record(GUI::ThemeCache &cache) {
+		cache.recordVar("Globals.Test", 42);
+		cache.recordTextColor(GUI::kTextColorNormal, 10, 20, 30);
+		cache.recordDialog("TestDialog", "screen", -1, -1, 0);
+		cache.recordLayout(GUI::ThemeLayout::kLayoutVertical, 8, GUI::ThemeLayout::kItemAlignStart);
+		cache.recordWidget("Button", "", 100, 20, Graphics::kTextAlignCenter, false);
+		cache.recordCloseLayout();
+		cache.recordCloseDialog();
+		cache.recordBitmap("test.bmp", &_bitmap);
+	}
+
+	Common::MemoryReadStream *save(GUI::ThemeCache &cache, const byte **data = nullptr) {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::NO);
+		TS_ASSERT(cache.save(stream, _key));
+		if (data)
+			*data = stream.getData();
+		return new Common::MemoryReadStream(stream.getData(), stream.size(), DisposeAfterUse::YES);
+	}
+
+public:
+	void setUp() {
+#if TEST_THEME_CACHE
+		Common::install_null_g_system();
+#endif
+
+		_key.contentHash = 0x12345678;
+		_key.scaleFactor = 1.5f;
+		_key.baseWidth = 640;
+		_key.baseHeight = 480;
+		_key.format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		_bitmap.create(7, 3, _key.format);
+		for (int y = 0; y < _bitmap.h; ++y)
+			for (int x = 0; x < _bitmap.w; ++x)
+				_bitmap.setPixel(x, y, 0x1234 + y * 0x100 + x);
+		_bitmap.setTransparentColor(0xF81F);
+	}
+
+	void tearDown() {
+		_bitmap.free();
+	}
+
+	void test_round_trip() {
+#if TEST_THEME_CACHE
+		GUI::ThemeCache cache;
+		record(cache);
+		const byte *data;
+		Common::MemoryReadStream *stream = save(cache, &data);
+
+		// The last pixel is stored little endian, just before the end
+		TS_ASSERT_EQUALS(data[stream->size() - 1], 0);
+		TS_ASSERT_EQUALS(READ_LE_UINT16(data + stream->size() - 3), 0x1234 + 0x206);
+
+		GUI::ThemeEngine engine("builtin", GUI::ThemeEngine::kGfxDisabled);
+		TS_ASSERT(GUI::ThemeCache::load(*stream, _key, &engine));
+		delete stream;
+
+		GUI::ThemeEval *eval = engine.getEvaluator();
+		TS_ASSERT_EQUALS(eval->getVar("Globals.Test"), 42);
+		TS_ASSERT(eval->hasDialog("TestDialog"));
+
+		GUI::TextColorData *color = engine.getTextColorData(GUI::kTextColorNormal);
+		TS_ASSERT(color);
+		if (color) {
+			TS_ASSERT_EQUALS(color->r, 10);
+			TS_ASSERT_EQUALS(color->g, 20);
+			TS_ASSERT_EQUALS(color->b, 30);
+		}
+
+		Graphics::ManagedSurface *bitmap = engine.getImageSurface("test.bmp");
+		TS_ASSERT(bitmap);
+		if (bitmap) {
+			TS_ASSERT_EQUALS(bitmap->format, _key.format);
+			TS_ASSERT_EQUALS(bitmap->w, _bitmap.w);
+			TS_ASSERT_EQUALS(bitmap->h, _bitmap.h);
+			TS_ASSERT(bitmap->hasTransparentColor());
+			TS_ASSERT_EQUALS(bitmap->getTransparentColor(), 0xF81Fu);
+			for (int y = 0; y < _bitmap.h; ++y)
+				TS_ASSERT_SAME_DATA(bitmap->getBasePtr(0, y), _bitmap.getBasePtr(0, y), _bitmap.w * 2);
+		}
+#endif
+	}
+
+	void test_key_mismatch() {
+#if TEST_THEME_CACHE
+		GUI::ThemeCache cache;
+		record(cache);
+		Common::MemoryReadStream *stream = save(cache);
+
+		GUI::ThemeEngine engine("builtin", GUI::ThemeEngine::kGfxDisabled);
+		_key.scaleFactor = 2.0f;
+		TS_ASSERT(!GUI::ThemeCache::load(*stream, _key, &engine));
+		TS_ASSERT(!engine.getEvaluator()->hasVar("Globals.Test"));
+		delete stream;
+#endif
+	}
+
+	void test_partial_replay() {
+#if TEST_THEME_CACHE
+		// A layout imported from a dialog that does not exist fails the
+		// replay after the rest has been rebuilt
+		GUI::ThemeCache cache;
+		record(cache);
+		cache.recordImportedLayout("MissingDialog");
+		Common::MemoryReadStream *stream = save(cache);
+
+		GUI::ThemeEngine engine("builtin", GUI::ThemeEngine::kGfxDisabled);
+		TS_ASSERT(!GUI::ThemeCache::load(*stream, _key, &engine));
+		delete stream;
+
+		TS_ASSERT(!engine.getEvaluator()->hasVar("Globals.Test"));
+		TS_ASSERT(!engine.getEvaluator()->hasDialog("TestDialog"));
+		TS_ASSERT(!engine.getTextColorData(GUI::kTextColorNormal));
+#endif
+	}
+};
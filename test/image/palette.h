@@ -0,0 +1,143 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "graphics/palette.h"
+#include "graphics/surface.h"
+
+#include "../null_osystem.h"
+
+// The benchmark times with the null OSystem
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_PALETTE_BENCHMARK 1
+#else
+#define TEST_PALETTE_BENCHMARK 0
+#endif
+
+class PaletteLookupTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	void randomPalette(byte *palette, uint len) {
+		for (uint i = 0; i < len * 3; i++)
+			palette[i] = nextRandom();
+	}
+
+	void checkPalette(const byte *palette, uint len) {
+		static const Graphics::ColorDistanceMethod methods[] = {
+			Graphics::kColorDistanceEuclidean,
+			Graphics::kColorDistanceNaive,
+			Graphics::kColorDistanceRedmean
+		};
+
+		Graphics::Palette reference(palette, len);
+		Graphics::PaletteLookup lookup(palette, len);
+
+		for (int m = 0; m < ARRAYSIZE(methods); m++) {
+			for (int i = 0; i < 20000; i++) {
+				byte r = nextRandom(), g = nextRandom(), b = nextRandom();
+				TS_ASSERT_EQUALS(lookup.findBestColor(r, g, b, methods[m]), reference.findBestColor(r, g, b, methods[m]));
+			}
+
+			// The palette colors themselves, where the first duplicate wins
+			for (uint i = 0; i < len; i++) {
+				byte r = palette[i * 3], g = palette[i * 3 + 1], b = palette[i * 3 + 2];
+				TS_ASSERT_EQUALS(lookup.findBestColor(r, g, b, methods[m]), reference.findBestColor(r, g, b, methods[m]));
+			}
+		}
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_find_best_color() {
+		byte palette[256 * 3];
+
+		randomPalette(palette, 256);
+		checkPalette(palette, 256);
+
+		randomPalette(palette, 16);
+		checkPalette(palette, 16);
+
+		checkPalette(palette, 1);
+
+		// Duplicated and close colors
+		for (uint i = 0; i < 256; i++) {
+			palette[i * 3 + 0] = (i / 2) & 0xE0;
+			palette[i * 3 + 1] = (i / 2) << 3;
+			palette[i * 3 + 2] = 0x80 + (i & 3);
+		}
+		checkPalette(palette, 256);
+
+		// A grayscale ramp
+		for (uint i = 0; i < 256; i++)
+			palette[i * 3 + 0] = palette[i * 3 + 1] = palette[i * 3 + 2] = i;
+		checkPalette(palette, 256);
+	}
+
+	void test_set_palette() {
+		byte palette[256 * 3];
+		randomPalette(palette, 256);
+
+		Graphics::PaletteLookup lookup(palette, 256);
+		TS_ASSERT(!lookup.setPalette(palette, 256));
+		TS_ASSERT_EQUALS(lookup.findBestColor(palette[30], palette[31], palette[32]), Graphics::Palette(palette, 256).findBestColor(palette[30], palette[31], palette[32]));
+
+		// The cached lookups are dropped when the palette changes
+		palette[30] ^= 0x80;
+		TS_ASSERT(lookup.setPalette(palette, 256));
+		Graphics::Palette reference(palette, 256);
+		TS_ASSERT_EQUALS(lookup.findBestColor(palette[30] ^ 0x80, palette[31], palette[32]), reference.findBestColor(palette[30] ^ 0x80, palette[31], palette[32]));
+
+		// Only the given entries are looked at
+		palette[0] = palette[1] = palette[2] = 0;
+		TS_ASSERT(lookup.setPalette(palette + 3, 255));
+		TS_ASSERT(lookup.setPalette(palette, 1));
+		TS_ASSERT_EQUALS(lookup.findBestColor(255, 255, 255), 0);
+	}
+
+	void test_convert_benchmark() {
+#if TEST_PALETTE_BENCHMARK
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 20;
+#else
+		const int iters = 1;
+#endif
+
+		const Graphics::PixelFormat format(3, 8, 8, 8, 0, 16, 8, 0, 0);
+		Graphics::Surface frame;
+		frame.create(640, 480, format);
+		for (int y = 0; y < frame.h; y++) {
+			for (int x = 0; x < frame.w; x++) {
+				// Gradients with some noise, which error diffusion spreads further
+				byte r = x * 255 / frame.w, g = y * 255 / frame.h, b = (x + y) & 0xFF;
+				frame.setPixel(x, y, format.RGBToColor(r ^ (nextRandom() & 7), g ^ (nextRandom() & 7), b));
+			}
+		}
+
+		byte palette[256 * 3];
+		uint32 time = 0;
+		for (int i = 0; i < iters; i++) {
+			randomPalette(palette, 256);
+
+			uint32 start = g_system->getMillis();
+			Graphics::Surface *converted = frame.convertTo(Graphics::PixelFormat::createFormatCLUT8(), nullptr, 0, palette, 256, Graphics::kDitherFloyd);
+			time += g_system->getMillis() - start;
+
+			converted->free();
+			delete converted;
+		}
+
+		debug("Surface::convertTo 640x480 to CLUT8 avg time per frame (in milliseconds): %f\n", (double)time / iters);
+
+		frame.free();
+#endif
+	}
+};
@@ -5,8 +5,11 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/backends/*.h
 TEST_LIBS    :=
+TEST_DEPS    :=
+TEST_ENGINE_OBJS :=
+TEST_ENGINE_DEPS :=
 
 ifdef POSIX
 TEST_LIBS += test/null_osystem.o \
@@ -15,7 +18,9 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-iostream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/mixer/null/null-mixer.o \
+	backends/timer/default/default-timer.o
 endif
 
 ifdef WIN32
@@ -25,7 +30,9 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o \
-	backends/platform/sdl/win32/win32_wrapper.o
+	backends/mixer/null/null-mixer.o \
+	backends/platform/sdl/win32/win32_wrapper.o \
+	backends/timer/default/default-timer.o
 endif
 
 TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
@@ -45,6 +52,35 @@ endif
 	TEST_LIBS += engines/ultima/libultima.a
 endif
 
+ifeq ($(ENABLE_SCI), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/sci/*/*.h
+	TEST_LINK_SCUMMVM := 1
+endif
+
+ifeq ($(ENABLE_SCUMM), STATIC_PLUGIN)
+ifdef ENABLE_SCUMM_7_8
+	TESTS += $(srcdir)/test/engines/scumm/*.h $(srcdir)/test/engines/scumm/*/*.h
+	TEST_LINK_SCUMMVM := 1
+endif
+endif
+
+# The GUI tests run on the null OSystem
+ifneq ($(filter test/null_osystem.o,$(TEST_LIBS)),)
+	TESTS += $(srcdir)/test/gui/*.h
+	TEST_LINK_SCUMMVM := 1
+endif
+
+ifdef TEST_LINK_SCUMMVM
+# Engine and GUI code reach the table of static plugins in base/plugins.cpp
+# through the engine dialogs and the launcher, so the libraries of ScummVM
+# are linked along with the detection objects. Only the archive members which
+# are used end up in the runner. base/libbase.a comes first in OBJS and is
+# repeated for the version strings. The other modules are read after this
+# one, so Makefile.common adds these as prerequisites.
+TEST_ENGINE_DEPS = $(DETECT_OBJS) $(filter %.a,$(OBJS))
+TEST_ENGINE_OBJS = $(TEST_ENGINE_DEPS) base/libbase.a
+endif
+
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
@@ -73,8 +109,8 @@ endif
 
 test: test/runner
 	./test/runner
-test/runner: test/runner.cpp $(TEST_LIBS) copy-dat
-	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/runner.cpp $(TEST_LIBS) $(TEST_LDFLAGS)
+test/runner: test/runner.cpp $(TEST_LIBS) $(TEST_DEPS) copy-dat
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/runner.cpp $(TEST_LIBS) $(TEST_ENGINE_OBJS) $(TEST_LDFLAGS)
 test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
@@ -14,7 +14,10 @@ void Common::install_null_g_system() {
 	const bool silenceLogs = true;
 #endif
 
-	g_system = OSystem_NULL_create(silenceLogs);
+	OSystem_NULL *system = new OSystem_NULL(silenceLogs);
+	g_system = system;
+	system->initMixer();
+	system->initGraphics();
 }
 
 void OSystem_NULL::quit() {